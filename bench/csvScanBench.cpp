@@ -0,0 +1,175 @@
+// CSV 分词吞吐: 标量级别 (逐字节, parseRecord) 与 SSE2 / AVX2 块位图对比
+// index 为打开文件时建立的记录索引, tokenize 为 forEachRecord 全量分词
+// 最后以最快级别对比多线程分块建索引与并发分词 (parallel 行)
+// 生成的数据: 整数, 小数, 日期, 文本, 约 1/8 的行含带逗号和 "" 的引号字段
+// 用法: csvScanBench [MB] [runs] [threads]
+//   默认 1024 MB, 3 次取最好, 线程数为硬件并发数
+// 也可以指定已有文件: csvScanBench file.csv [runs] [threads]
+
+#include "../src/CsvParser.h"
+#include "../src/CsvSimd.h"
+#include "../src/MappedFile.h"
+#include "../src/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double
+elapsedMs (Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli> (Clock::now () - start)
+        .count ();
+}
+
+std::string
+syntheticCsv (std::size_t bytes)
+{
+    std::string text;
+    text.reserve (bytes + 256);
+    text += "id,amount,date,name,comment,flag\n";
+    char buf[256];
+    for (std::size_t r = 1; text.size () < bytes; ++r)
+    {
+        const int n = std::snprintf (
+            buf, sizeof buf, "%zu,%zu.%02zu,2024-%02zu-%02zu,name%zu,%s,%s\n",
+            r, (r * 7919) % 100000, r % 100, r % 12 + 1, r % 28 + 1,
+            r % 5000,
+            r % 8 == 0 ? "\"quoted, with \"\"escapes\"\"\"" : "plain text",
+            r % 2 == 0 ? "TRUE" : "FALSE");
+        text.append (buf, static_cast<std::size_t> (n));
+    }
+    return text;
+}
+
+template <typename Fn>
+double
+bestOf (int runs, Fn &&fn)
+{
+    double best = std::numeric_limits<double>::max ();
+    for (int run = 0; run < runs; ++run)
+    {
+        const auto start = Clock::now ();
+        fn ();
+        best = std::min (best, elapsedMs (start));
+    }
+    return best;
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    int runs = argc > 2 ? std::atoi (argv[2]) : 3;
+    std::string generated;
+    MappedFile file;
+    std::string_view text;
+    const char *arg = argc > 1 ? argv[1] : "1024";
+    char *rest = nullptr;
+    const auto sizeMb = std::strtoul (arg, &rest, 10);
+    if (rest != nullptr && *rest == '\0' && sizeMb > 0)
+    {
+        generated = syntheticCsv (sizeMb * 1024 * 1024);
+        text = generated;
+    }
+    else
+    {
+        file = MappedFile (arg);
+        text = file.view ();
+    }
+
+    const double mb = static_cast<double> (text.size ()) / (1024.0 * 1024.0);
+    std::printf ("csv: %.1f MB, best of %d runs\n", mb, runs);
+
+    double scalarIndexMs = 0;
+    double scalarTokenMs = 0;
+    for (auto level : { csvsimd::Level::SCALAR, csvsimd::Level::SSE2,
+                        csvsimd::Level::AVX2 })
+    {
+        if (csvsimd::setActive (level) != level)
+        {
+            std::printf ("%-7s not supported\n", csvsimd::levelName (level));
+            continue;
+        }
+        const auto &kernels = csvsimd::kernels (level);
+
+        std::size_t rows = 0;
+        const double indexMs
+            = bestOf (runs,
+                      [&]
+                      {
+                          rows = csv::indexRecords (text, {}, kernels)
+                                     .rowCount ();
+                      });
+        if (level == csvsimd::Level::SCALAR)
+        {
+            scalarIndexMs = indexMs;
+        }
+        std::printf ("index    %-7s %8.1f ms  %7.1f MB/s  %zu rows  x%.2f\n",
+                     csvsimd::levelName (level), indexMs,
+                     mb / (indexMs / 1000.0), rows, scalarIndexMs / indexMs);
+
+        std::size_t fields = 0;
+        const double tokenMs = bestOf (
+            runs,
+            [&]
+            {
+                fields = 0;
+                csv::forEachRecord (text, {},
+                                    [&] (const csv::CsvRow &row)
+                                    { fields += row.size (); });
+            });
+        if (level == csvsimd::Level::SCALAR)
+        {
+            scalarTokenMs = tokenMs;
+        }
+        std::printf ("tokenize %-7s %8.1f ms  %7.1f MB/s  %zu fields  x%.2f\n",
+                     csvsimd::levelName (level), tokenMs,
+                     mb / (tokenMs / 1000.0), fields, scalarTokenMs / tokenMs);
+    }
+
+    // 多线程: 最快的级别
+    csvsimd::setActive (csvsimd::Level::AVX2);
+    const std::size_t threads
+        = argc > 3 ? std::strtoul (argv[3], nullptr, 10)
+                   : defaultThreadCount ();
+    csv::CsvIndex index;
+    const double indexMs = bestOf (
+        runs, [&] { index = csv::indexRecordsParallel (text, {}, threads); });
+    std::printf ("index    %zu threads %8.1f ms  %7.1f MB/s  %zu rows  "
+                 "x%.2f\n",
+                 threads, indexMs, mb / (indexMs / 1000.0), index.rowCount (),
+                 scalarIndexMs / indexMs);
+
+    std::atomic<std::size_t> fields{ 0 };
+    const double tokenMs = bestOf (
+        runs,
+        [&]
+        {
+            fields = 0;
+            csv::forEachRecordParallel (
+                text, index, {}, threads,
+                [&] (const csv::CsvRow &row)
+                {
+                    fields.fetch_add (row.size (),
+                                      std::memory_order_relaxed);
+                });
+        });
+    std::printf ("tokenize %zu threads %8.1f ms  %7.1f MB/s  %zu fields  "
+                 "x%.2f\n",
+                 threads, tokenMs, mb / (tokenMs / 1000.0), fields.load (),
+                 scalarTokenMs / tokenMs);
+    return 0;
+}
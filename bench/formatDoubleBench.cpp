@@ -0,0 +1,134 @@
+// XlsCell::formatDouble 吞吐对比: 原 ostringstream 实现 vs to_chars 实现
+// 用法: formatDoubleBench [count]
+
+#include "../src/XlsCell.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double
+elapsedMs (Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli> (Clock::now () - start)
+        .count ();
+}
+
+std::string
+legacyFormat (double value)
+{
+    std::ostringstream oss;
+    double intpart;
+    if (std::modf (value, &intpart) == 0.0)
+    {
+        if (value >= std::numeric_limits<int64_t>::min () && value < 0x1p63)
+        {
+            oss << static_cast<int64_t> (value);
+        }
+        else
+        {
+            oss << std::fixed << std::setprecision (0) << value;
+        }
+        return oss.str ();
+    }
+
+    oss << std::setprecision (15) << value;
+    std::string str = oss.str ();
+    if (str.find ('.') != std::string::npos)
+    {
+        str.erase (str.find_last_not_of ('0') + 1, std::string::npos);
+        if (!str.empty () && str.back () == '.')
+        {
+            str.pop_back ();
+        }
+    }
+    return str;
+}
+
+// 表格中常见的数值: 整数, 两位小数的金额, 日期序列号, 任意小数
+std::vector<double>
+makeValues (std::size_t count)
+{
+    std::mt19937_64 rng (42);
+    std::uniform_int_distribution<int> ints (-100000, 100000);
+    std::uniform_real_distribution<double> reals (-1e6, 1e6);
+    std::vector<double> values (count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        switch (i % 4)
+        {
+        case 0:
+            values[i] = ints (rng);
+            break;
+        case 1:
+            values[i] = ints (rng) / 100.0;
+            break;
+        case 2:
+            values[i] = 40000 + ints (rng) / 86400.0;
+            break;
+        default:
+            values[i] = reals (rng);
+            break;
+        }
+    }
+    return values;
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    std::size_t count = argc > 1 ? std::strtoull (argv[1], nullptr, 10)
+                                 : 2000000;
+    auto values = makeValues (count);
+
+    std::size_t mismatches = 0;
+    for (double value : values)
+    {
+        char buf[XlsCell::MaxDoubleLength];
+        std::size_t len = XlsCell::formatDouble (value, buf);
+        if (legacyFormat (value) != std::string (buf, len))
+        {
+            ++mismatches;
+        }
+    }
+
+    auto start = Clock::now ();
+    std::size_t legacyBytes = 0;
+    for (double value : values)
+    {
+        legacyBytes += legacyFormat (value).size ();
+    }
+    auto legacyMs = elapsedMs (start);
+
+    start = Clock::now ();
+    std::size_t bufferBytes = 0;
+    char buf[XlsCell::MaxDoubleLength];
+    for (double value : values)
+    {
+        bufferBytes += XlsCell::formatDouble (value, buf);
+    }
+    auto bufferMs = elapsedMs (start);
+
+    std::printf ("values=%zu mismatches=%zu\n", count, mismatches);
+    std::printf ("ostringstream  %8.2f ms  %7.2f M/s  (%zu B)\n", legacyMs,
+                 count / legacyMs / 1000.0, legacyBytes);
+    std::printf ("to_chars       %8.2f ms  %7.2f M/s  (%zu B)  x%.1f\n",
+                 bufferMs, count / bufferMs / 1000.0, bufferBytes,
+                 legacyMs / bufferMs);
+    return mismatches == 0 ? 0 : 1;
+}
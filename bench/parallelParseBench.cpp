@@ -0,0 +1,68 @@
+// 多工作表并行解析的扩展性测试
+// 用法: parallelParseBench file.xls [repeat]
+// 对 1, 2, 4 ... 硬件线程数分别打开工作簿并调用 parseAllSheets
+
+#include "../src/reader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int
+main (int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::printf ("usage: %s file.xls [repeat]\n", argv[0]);
+        return 1;
+    }
+    const int repeat = argc > 2 ? std::atoi (argv[2]) : 3;
+    const std::size_t maxThreads = defaultThreadCount ();
+
+    double baseline = 0.0;
+    for (std::size_t threads = 1;; threads *= 2)
+    {
+        threads = std::min (threads, maxThreads);
+
+        double best = 0.0;
+        std::size_t cells = 0;
+        for (int i = 0; i < repeat; ++i)
+        {
+            XLSReader reader{ fs::path (argv[1]) };
+            if (!reader.open ())
+            {
+                std::printf ("%s: open failed\n", argv[1]);
+                return 1;
+            }
+
+            auto start = std::chrono::steady_clock::now ();
+            reader.parseAllSheets (threads);
+            double ms = std::chrono::duration<double, std::milli> (
+                            std::chrono::steady_clock::now () - start)
+                            .count ();
+            best = i == 0 ? ms : std::min (best, ms);
+
+            cells = 0;
+            for (std::size_t s = 0; s < reader.getSheetsCount (); ++s)
+            {
+                for (const auto &row : reader.rows (s))
+                {
+                    cells += row.size ();
+                }
+            }
+        }
+
+        if (threads == 1)
+        {
+            baseline = best;
+        }
+        std::printf ("threads=%-3zu cells=%-10zu %.2f ms  speedup=%.2fx\n",
+                     threads, cells, best, baseline / best);
+
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+// 打开方式的耗时对比: 打开工作簿并解析全部工作表, 每项取 repeat 次中的
+// 最短时间
+// 用法: xlsOpenBench file.xls [repeat]
+//   stream  xls_open: libxls 通过 FILE* 按扇区 fseek / fread
+//   mapped  OpenMode::MAPPED: 整个文件只读映射, xls_open_buffer 读映射区
+//   memory  数据已在内存中 (如对象存储缓存), 读入内存的时间不计
+// 第一次运行前文件已在页缓存中, 比较的是读取路径本身的开销
+
+#include "../src/reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Open>
+double
+bestMs (int repeat, Open &&open)
+{
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i)
+    {
+        auto start = Clock::now ();
+        XLSReader reader = open ();
+        if (!reader.open ())
+        {
+            std::printf ("open failed\n");
+            std::exit (1);
+        }
+        reader.parseAllSheets (1);
+        double ms = std::chrono::duration<double, std::milli> (Clock::now ()
+                                                               - start)
+                        .count ();
+        best = i == 0 ? ms : std::min (best, ms);
+    }
+    return best;
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::printf ("usage: %s file.xls [repeat]\n", argv[0]);
+        return 1;
+    }
+    const int repeat = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+    const fs::path path (argv[1]);
+
+    std::ifstream in (path, std::ios::binary);
+    const std::vector<char> chars ((std::istreambuf_iterator<char> (in)),
+                                   std::istreambuf_iterator<char> ());
+    std::vector<std::byte> bytes (chars.size ());
+    std::memcpy (bytes.data (), chars.data (), chars.size ());
+    const Span<const std::byte> data (bytes.data (), bytes.size ());
+
+    double streamMs = bestMs (repeat, [&] () { return XLSReader (path); });
+    double mappedMs = bestMs (
+        repeat,
+        [&] ()
+        { return XLSReader (path, ParseMode::FULL, OpenMode::MAPPED); });
+    double memoryMs = bestMs (repeat, [&] () { return XLSReader (data); });
+
+    std::printf ("%s %zu B  stream=%.2f ms  mapped=%.2f ms  "
+                 "memory=%.2f ms\n",
+                 argv[1], bytes.size (), streamMs, mappedMs, memoryMs);
+    return 0;
+}
@@ -0,0 +1,125 @@
+// 工作表解析方式的耗时对比, 每项取 repeat 次中的最短时间
+// 用法: xlsSheetParseBench file.xls [repeat]
+//   libxls    xls_parseWorkSheet: 预读一遍求 lastrow / lastcol, 再读一遍
+//             解码到稠密表
+//   read      readSheetStream: 只把记录流读到内存, 即多出的一遍的开销
+//   buffered  readSheetStream + decodeSheetStream: 先缓存整个流再解码
+//   single    parseSparseSheet: 单遍读取并解码, 容量取自 DIMENSIONS
+//   values    同 single, ParseMode::VALUES_ONLY, 数值单元格不生成文本
+
+#include "../src/SheetParser.h"
+#include "../src/SparseSheet.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// fn 返回解析结果, 结果在计时结束后才析构, 释放不计入耗时
+template <typename Fn>
+double
+bestMs (int repeat, Fn &&fn)
+{
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i)
+    {
+        auto start = Clock::now ();
+        auto result = fn ();
+        double ms = std::chrono::duration<double, std::milli> (Clock::now ()
+                                                               - start)
+                        .count ();
+        best = i == 0 ? ms : std::min (best, ms);
+    }
+    return best;
+}
+
+using DenseSheet
+    = std::unique_ptr<xls::xlsWorkSheet, decltype (&xls::xls_close_WS)>;
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::printf ("usage: %s file.xls [repeat]\n", argv[0]);
+        return 1;
+    }
+    const int repeat = argc > 2 ? std::max (1, std::atoi (argv[2])) : 5;
+
+    auto *wb = xls::xls_open (argv[1], "UTF-8");
+    if (wb == nullptr)
+    {
+        std::printf ("%s: open failed\n", argv[1]);
+        return 1;
+    }
+
+    for (std::size_t i = 0; i < wb->sheets.count; ++i)
+    {
+        auto *handle = xls::xls_getWorkSheet (wb, int (i));
+
+        double libxlsMs = bestMs (repeat,
+                                  [&] ()
+                                  {
+                                      DenseSheet dense (
+                                          xls::xls_getWorkSheet (wb, int (i)),
+                                          &xls::xls_close_WS);
+                                      xls::xls_parseWorkSheet (dense.get ());
+                                      return dense;
+                                  });
+        double readMs = bestMs (repeat,
+                                [&] ()
+                                {
+                                    std::vector<xls::BYTE> data;
+                                    readSheetStream (handle, data);
+                                    return data;
+                                });
+        double bufferedMs = bestMs (repeat,
+                                    [&] ()
+                                    {
+                                        std::vector<xls::BYTE> data;
+                                        readSheetStream (handle, data);
+                                        SparseSheet sheet;
+                                        decodeSheetStream (wb, data, sheet);
+                                        return sheet;
+                                    });
+        double singleMs = bestMs (repeat,
+                                  [&] ()
+                                  {
+                                      SparseSheet sheet;
+                                      parseSparseSheet (handle, sheet);
+                                      return sheet;
+                                  });
+        double valuesMs = bestMs (repeat,
+                                  [&] ()
+                                  {
+                                      SparseSheet sheet;
+                                      parseSparseSheet (
+                                          handle, sheet,
+                                          ParseMode::VALUES_ONLY);
+                                      return sheet;
+                                  });
+
+        std::vector<xls::BYTE> stream;
+        readSheetStream (handle, stream);
+        SparseSheet sheet;
+        parseSparseSheet (handle, sheet);
+        xls::xls_close_WS (handle);
+
+        std::printf ("%s[%zu] records=%zu B cells=%zu  libxls=%.2f ms  "
+                     "read=%.2f ms  buffered=%.2f ms  single=%.2f ms  "
+                     "values=%.2f ms\n",
+                     argv[1], i, stream.size (), sheet.cellCount (), libxlsMs,
+                     readMs, bufferedMs, singleMs, valuesMs);
+    }
+    xls::xls_close_WB (wb);
+    return 0;
+}
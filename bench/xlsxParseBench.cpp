@@ -0,0 +1,100 @@
+// 内置 XLSX 解析器吞吐: 分别统计工作表解压和 XML 扫描的时间,
+// 以及 readSheet 边解压边扫描的总时间; 速度按解压后的 XML 字节数计算
+// 用法: xlsxParseBench file.xlsx [runs]
+
+#include "../src/XlsxWorkbook.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double
+elapsedMs (Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli> (Clock::now () - start)
+        .count ();
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf (stderr, "usage: %s file.xlsx [runs]\n", argv[0]);
+        return 1;
+    }
+    const int runs = argc > 2 ? std::atoi (argv[2]) : 3;
+
+    auto start = Clock::now ();
+    XlsxWorkbook workbook (argv[1]);
+    const double openMs = elapsedMs (start);
+    std::printf ("open (workbook, styles, %zu shared strings): %.1f ms\n",
+                 workbook.sharedStrings ().size (), openMs);
+
+    double unzipMs = std::numeric_limits<double>::max ();
+    double scanMs = std::numeric_limits<double>::max ();
+    double streamMs = std::numeric_limits<double>::max ();
+    std::size_t bytes = 0;
+    std::size_t cells = 0;
+    for (int run = 0; run < runs; ++run)
+    {
+        double unzip = 0;
+        double scan = 0;
+        bytes = 0;
+        cells = 0;
+        for (std::size_t pos = 0; pos < workbook.sheetCount (); ++pos)
+        {
+            std::string xml;
+            start = Clock::now ();
+            if (!workbook.archive ().read (workbook.sheetPart (pos), xml))
+            {
+                std::fprintf (stderr, "cannot read %s\n",
+                              workbook.sheetPart (pos).c_str ());
+                return 1;
+            }
+            unzip += elapsedMs (start);
+
+            XlsxSheet sheet (&workbook.sharedStrings (),
+                             &workbook.dateFormats ());
+            start = Clock::now ();
+            xlsx::parseSheet (xml, sheet, workbook.date1904 ());
+            scan += elapsedMs (start);
+
+            bytes += xml.size ();
+            cells += sheet.cellCount ();
+        }
+        unzipMs = std::min (unzipMs, unzip);
+        scanMs = std::min (scanMs, scan);
+
+        start = Clock::now ();
+        for (std::size_t pos = 0; pos < workbook.sheetCount (); ++pos)
+        {
+            XlsxSheet sheet;
+            workbook.readSheet (pos, sheet);
+        }
+        streamMs = std::min (streamMs, elapsedMs (start));
+    }
+
+    const double mb = static_cast<double> (bytes) / (1024.0 * 1024.0);
+    std::printf ("sheets: %zu, xml: %.1f MB, cells: %zu\n",
+                 workbook.sheetCount (), mb, cells);
+    std::printf ("unzip: %8.1f ms  %7.1f MB/s\n", unzipMs,
+                 mb / (unzipMs / 1000.0));
+    std::printf ("scan:  %8.1f ms  %7.1f MB/s  %.1f Mcells/s\n", scanMs,
+                 mb / (scanMs / 1000.0),
+                 static_cast<double> (cells) / (scanMs * 1000.0));
+    std::printf ("stream:%8.1f ms  %7.1f MB/s\n", streamMs,
+                 mb / (streamMs / 1000.0));
+    return 0;
+}
@@ -0,0 +1,139 @@
+// XLSX 工作表扫描吞吐: 标量内核与 SSE2 / AVX2 内核对比
+// 不带参数时使用生成的工作表 XML (数值, 共享字符串, 日期混合);
+// 指定 xlsx 文件时扫描其中所有工作表
+// 用法: xmlScanBench [file.xlsx] [runs]
+
+#include "../src/XlsxWorkbook.h"
+#include "../src/XmlSimd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double
+elapsedMs (Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli> (Clock::now () - start)
+        .count ();
+}
+
+std::string
+syntheticSheet (std::size_t rows)
+{
+    std::string xml = "<worksheet><sheetData>";
+    char buf[160];
+    for (std::size_t r = 1; r <= rows; ++r)
+    {
+        std::snprintf (buf, sizeof buf, "<row r=\"%zu\" spans=\"1:9\">", r);
+        xml += buf;
+        for (int c = 0; c < 9; ++c)
+        {
+            const char col = static_cast<char> ('A' + c);
+            switch (c % 3)
+            {
+            case 0:
+                std::snprintf (buf, sizeof buf,
+                               "<c r=\"%c%zu\" t=\"s\"><v>%zu</v></c>", col,
+                               r, (r * 7 + c) % 5000);
+                break;
+            case 1:
+                std::snprintf (buf, sizeof buf,
+                               "<c r=\"%c%zu\" s=\"2\"><v>%zu.%06zu</v></c>",
+                               col, r, r % 10000, (r * 7919) % 1000000);
+                break;
+            default:
+                std::snprintf (buf, sizeof buf,
+                               "<c r=\"%c%zu\" s=\"1\"><v>%zu</v></c>", col,
+                               r, 40000 + r % 1000);
+                break;
+            }
+            xml += buf;
+        }
+        xml += "</row>";
+    }
+    xml += "</sheetData></worksheet>";
+    return xml;
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+    std::vector<std::string> sheets;
+    int runs = 5;
+    if (argc > 1)
+    {
+        XlsxWorkbook workbook (argv[1]);
+        for (std::size_t pos = 0; pos < workbook.sheetCount (); ++pos)
+        {
+            sheets.emplace_back ();
+            if (!workbook.archive ().read (workbook.sheetPart (pos),
+                                           sheets.back ()))
+            {
+                std::fprintf (stderr, "cannot read %s\n",
+                              workbook.sheetPart (pos).c_str ());
+                return 1;
+            }
+        }
+        runs = argc > 2 ? std::atoi (argv[2]) : runs;
+    }
+    else
+    {
+        sheets.push_back (syntheticSheet (200000));
+    }
+
+    std::size_t bytes = 0;
+    for (const auto &xml : sheets)
+    {
+        bytes += xml.size ();
+    }
+    const double mb = static_cast<double> (bytes) / (1024.0 * 1024.0);
+    std::printf ("xml: %.1f MB, best of %d runs\n", mb, runs);
+
+    StringArena shared;
+    DateFormatCache formats;
+    double scalarMs = 0;
+    for (auto level : { xmlsimd::Level::SCALAR, xmlsimd::Level::SSE2,
+                        xmlsimd::Level::AVX2 })
+    {
+        if (xmlsimd::setActive (level) != level)
+        {
+            std::printf ("%-7s not supported\n", xmlsimd::levelName (level));
+            continue;
+        }
+
+        double best = std::numeric_limits<double>::max ();
+        std::size_t cells = 0;
+        for (int run = 0; run < runs; ++run)
+        {
+            cells = 0;
+            const auto start = Clock::now ();
+            for (const auto &xml : sheets)
+            {
+                XlsxSheet sheet (&shared, &formats);
+                xlsx::parseSheet (xml, sheet);
+                cells += sheet.cellCount ();
+            }
+            best = std::min (best, elapsedMs (start));
+        }
+        if (level == xmlsimd::Level::SCALAR)
+        {
+            scalarMs = best;
+        }
+        std::printf ("%-7s %8.1f ms  %7.1f MB/s  %zu cells  x%.2f\n",
+                     xmlsimd::levelName (level), best, mb / (best / 1000.0),
+                     cells, scalarMs / best);
+    }
+    return 0;
+}
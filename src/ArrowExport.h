@@ -0,0 +1,305 @@
+#ifndef ARROWEXPORT_H
+#define ARROWEXPORT_H
+
+#include "ColumnBuffer.h"
+#include "XlsCell.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Arrow C Data Interface, 与 arrow/c/abi.h 中的定义相同, 不依赖 Arrow 库
+// https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+    // Array type description
+    const char *format;
+    const char *name;
+    const char *metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema **children;
+    struct ArrowSchema *dictionary;
+
+    // Release callback
+    void (*release) (struct ArrowSchema *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+struct ArrowArray
+{
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void **buffers;
+    struct ArrowArray **children;
+    struct ArrowArray *dictionary;
+
+    // Release callback
+    void (*release) (struct ArrowArray *);
+    // Opaque producer-specific data
+    void *private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace arrowexport
+{
+
+// 每个 ArrowSchema / ArrowArray 独立持有自己的数据, 使用方可以把子数组
+// 移走后单独释放 (见 C Data Interface 的 "Moving child arrays")
+// 字典编码的列另带 dictionary, 随所属的结构一起释放
+struct SchemaHolder
+{
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema *> childPtrs;
+    ArrowSchema dictionary{};
+};
+
+struct ArrayHolder
+{
+    ColumnBuffer column; // 缓冲区直接交给使用方, 不复制
+    std::shared_ptr<const StringDictionary> strings; // 字典数组的数据
+    const void *buffers[3] = {};
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray *> childPtrs;
+    ArrowArray dictionary{};
+};
+
+inline void
+releaseSchema (ArrowSchema *schema)
+{
+    auto *holder = static_cast<SchemaHolder *> (schema->private_data);
+    for (auto &child : holder->children)
+    {
+        if (child.release != nullptr)
+        {
+            child.release (&child);
+        }
+    }
+    if (holder->dictionary.release != nullptr)
+    {
+        holder->dictionary.release (&holder->dictionary);
+    }
+    delete holder;
+    schema->release = nullptr;
+}
+
+inline void
+releaseArray (ArrowArray *array)
+{
+    auto *holder = static_cast<ArrayHolder *> (array->private_data);
+    for (auto &child : holder->children)
+    {
+        if (child.release != nullptr)
+        {
+            child.release (&child);
+        }
+    }
+    if (holder->dictionary.release != nullptr)
+    {
+        holder->dictionary.release (&holder->dictionary);
+    }
+    delete holder;
+    array->release = nullptr;
+}
+
+inline const char *
+formatOf (ColumnType type)
+{
+    switch (type)
+    {
+    case ColumnType::NUMBER:
+        return "g"; // float64
+    case ColumnType::BOOL:
+        return "b";
+    case ColumnType::DATE:
+        return "tsm:"; // timestamp[ms], 无时区
+    case ColumnType::STRING:
+        return "U"; // large_utf8, int64 偏移
+    case ColumnType::EMPTY:
+        break;
+    }
+    return "n"; // null
+}
+
+// 字典编码的列: 下标为 uint32, 字典为 large_utf8
+inline const char *
+formatOf (const ColumnBuffer &column)
+{
+    return column.dictionaryEncoded () ? "I" : formatOf (column.type);
+}
+
+inline void
+initSchema (ArrowSchema *out, std::unique_ptr<SchemaHolder> holder,
+            int64_t flags)
+{
+    out->format = holder->format.c_str ();
+    out->name = holder->name.c_str ();
+    out->metadata = nullptr;
+    out->flags = flags;
+    out->n_children = static_cast<int64_t> (holder->childPtrs.size ());
+    out->children = holder->childPtrs.empty () ? nullptr
+                                               : holder->childPtrs.data ();
+    out->dictionary = holder->dictionary.release != nullptr
+                          ? &holder->dictionary
+                          : nullptr;
+    out->release = releaseSchema;
+    out->private_data = holder.release ();
+}
+
+// 字典导出为不含空值的 large_utf8 数组, 与各列共享同一份数据
+inline void
+exportDictionary (std::shared_ptr<const StringDictionary> strings,
+                  ArrowArray *out)
+{
+    auto holder = std::make_unique<ArrayHolder> ();
+    holder->strings = std::move (strings);
+    holder->buffers[1] = holder->strings->offsets.data ();
+    holder->buffers[2] = holder->strings->chars.data ();
+
+    out->length = static_cast<int64_t> (holder->strings->size ());
+    out->null_count = 0;
+    out->offset = 0;
+    out->n_buffers = 3;
+    out->n_children = 0;
+    out->buffers = holder->buffers;
+    out->children = nullptr;
+    out->dictionary = nullptr;
+    out->release = releaseArray;
+    out->private_data = holder.release ();
+}
+
+inline void
+exportColumn (ColumnBuffer column, ArrowArray *out)
+{
+    auto holder = std::make_unique<ArrayHolder> ();
+    holder->column = std::move (column);
+    const auto &col = holder->column;
+
+    out->length = static_cast<int64_t> (col.length);
+    out->null_count = static_cast<int64_t> (col.nullCount);
+    out->offset = 0;
+    out->n_buffers = 2;
+    holder->buffers[0] = col.nullCount == 0 ? nullptr : col.validity.data ();
+    switch (col.type)
+    {
+    case ColumnType::NUMBER:
+        holder->buffers[1] = col.numbers.data ();
+        break;
+    case ColumnType::BOOL:
+        holder->buffers[1] = col.bools.data ();
+        break;
+    case ColumnType::DATE:
+        holder->buffers[1] = col.dates.data ();
+        break;
+    case ColumnType::STRING:
+        if (col.dictionaryEncoded ())
+        {
+            holder->buffers[1] = col.codes.data ();
+            exportDictionary (col.dictionary, &holder->dictionary);
+            break;
+        }
+        out->n_buffers = 3;
+        holder->buffers[1] = col.offsets.data ();
+        holder->buffers[2] = col.chars.data ();
+        break;
+    case ColumnType::EMPTY:
+        out->n_buffers = 0;
+        break;
+    }
+
+    out->n_children = 0;
+    out->buffers = holder->buffers;
+    out->children = nullptr;
+    out->dictionary = holder->dictionary.release != nullptr
+                          ? &holder->dictionary
+                          : nullptr;
+    out->release = releaseArray;
+    out->private_data = holder.release ();
+}
+
+} // namespace arrowexport
+
+// 把列式数据导出为 Arrow 结构体数组 (struct<...>), 缓冲区所有权转移给使用方,
+// 由使用方调用 schema->release / array->release 释放
+// names 中缺少或为空的列以列名 (A, B, ...) 命名
+// 字典编码的字符串列导出为 dictionary<uint32, large_utf8>
+inline void
+exportArrow (SheetColumns table, const std::vector<std::string> &names,
+             ArrowSchema *schema, ArrowArray *array)
+{
+    using namespace arrowexport;
+    const std::size_t count = table.columns.size ();
+
+    auto schemaHolder = std::make_unique<SchemaHolder> ();
+    schemaHolder->format = "+s";
+    schemaHolder->children.resize (count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto child = std::make_unique<SchemaHolder> ();
+        child->format = formatOf (table.columns[i]);
+        if (table.columns[i].dictionaryEncoded ())
+        {
+            auto values = std::make_unique<SchemaHolder> ();
+            values->format = formatOf (ColumnType::STRING);
+            initSchema (&child->dictionary, std::move (values), 0);
+        }
+        if (i < names.size () && !names[i].empty ())
+        {
+            child->name = names[i];
+        }
+        else
+        {
+            char buf[8];
+            child->name.assign (
+                buf, CellPosition::columnName (static_cast<uint32_t> (i),
+                                               buf));
+        }
+        initSchema (&schemaHolder->children[i], std::move (child),
+                    ARROW_FLAG_NULLABLE);
+        schemaHolder->childPtrs.push_back (&schemaHolder->children[i]);
+    }
+
+    auto arrayHolder = std::make_unique<ArrayHolder> ();
+    arrayHolder->children.resize (count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        exportColumn (std::move (table.columns[i]),
+                      &arrayHolder->children[i]);
+        arrayHolder->childPtrs.push_back (&arrayHolder->children[i]);
+    }
+
+    initSchema (schema, std::move (schemaHolder), 0);
+
+    array->length = static_cast<int64_t> (table.rows);
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = 1; // 结构体本身没有空值, 有效位图为空
+    array->n_children = static_cast<int64_t> (count);
+    array->buffers = arrayHolder->buffers;
+    array->children = arrayHolder->childPtrs.empty ()
+                          ? nullptr
+                          : arrayHolder->childPtrs.data ();
+    array->dictionary = nullptr;
+    array->release = releaseArray;
+    array->private_data = arrayHolder.release ();
+}
+
+#endif
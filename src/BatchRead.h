@@ -0,0 +1,137 @@
+#ifndef BATCHREAD_H
+#define BATCHREAD_H
+
+#include "Exceptions.h"
+#include "Span.h"
+#include "XlsCell.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// 区域读取 (readRange) 的结果: 行优先的稠密块
+// 相对区域左上角的第 r 行第 c 列为 at (r, c); 没有单元格的位置是空视图
+template <typename Cell>
+struct CellBlock
+{
+    CellRange range; // 截断后的区域, 见 CellRange::clamp
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::vector<Cell> cells;
+
+    [[nodiscard]] const Cell &
+    at (std::size_t r, std::size_t c) const
+    {
+        return cells[r * cols + c];
+    }
+};
+
+// 批量读取单元格 (readCells) 和区域 (readRange) 的公共部分
+// readCells: 请求按 (row, col) 排序后按行分组, 每行只定位一次, 行内按
+// 列升序与该行已排好序的单元格归并, 整批请求只遍历一遍工作表; 结果按
+// 请求原来的顺序写入调用方提供的缓冲区
+// readRange: 按行顺序遍历区域内的单元格, 直接写入块中的位置
+namespace batch
+{
+
+// 检查请求和输出缓冲区: 位置无效时抛出 ParseAddrException,
+// 输出缓冲区不够时抛出 IndexOutException
+template <typename Out>
+void
+checkRequest (Span<const CellPosition> cells, Span<Out> out)
+{
+    if (out.size () < cells.size ())
+    {
+        throw ExcelReader::IndexOutException (
+            "out[" + std::to_string (cells.size () - 1) + "]");
+    }
+    for (const auto &cell : cells)
+    {
+        if (!cell.valid ())
+        {
+            throw ExcelReader::ParseAddrException ("empty position");
+        }
+    }
+}
+
+// 按行分组调用 fn(row, const uint32_t *first, const uint32_t *last),
+// [first, last) 为该行请求的下标, 按列升序; 行按升序
+// 请求已经有序时不排序
+template <typename Fn>
+void
+forEachRow (Span<const CellPosition> cells, Fn &&fn)
+{
+    auto less = [&cells] (uint32_t lhs, uint32_t rhs)
+    {
+        const auto &a = cells[lhs];
+        const auto &b = cells[rhs];
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    };
+    std::vector<uint32_t> order (cells.size ());
+    std::iota (order.begin (), order.end (), 0u);
+    if (!std::is_sorted (order.begin (), order.end (), less))
+    {
+        std::sort (order.begin (), order.end (), less);
+    }
+
+    const uint32_t *first = order.data ();
+    const uint32_t *end = first + order.size ();
+    while (first != end)
+    {
+        const uint32_t row = cells[*first].row;
+        const uint32_t *last = first + 1;
+        while (last != end && cells[*last].row == row)
+        {
+            ++last;
+        }
+        fn (static_cast<std::size_t> (row), first, last);
+        first = last;
+    }
+}
+
+// 在按列升序的单元格 [cursor, last) 中查找 col, 找到时返回该单元格
+// cursor 只前进不后退, 依次查找升序 (可重复) 的列时整行只扫描一遍
+template <typename Cell>
+const Cell *
+advanceTo (const Cell *&cursor, const Cell *last, std::size_t col)
+{
+    while (cursor != last && cursor->col < col)
+    {
+        ++cursor;
+    }
+    return cursor != last && cursor->col == col ? cursor : nullptr;
+}
+
+// 逐行填充 range (已截断) 对应的块
+// rowCells(row) 返回该行按列升序的单元格 [first, last), 单元格有 col 成员;
+// convert(const Cell*) 转成块元素, 块元素默认构造即为空
+template <typename Out, typename RowFn, typename Convert>
+CellBlock<Out>
+fillRange (const CellRange &range, RowFn &&rowCells, Convert &&convert)
+{
+    CellBlock<Out> block;
+    block.range = range;
+    block.rows = range.rowCount ();
+    block.cols = range.colCount ();
+    block.cells.resize (block.rows * block.cols);
+    for (std::size_t r = 0; r < block.rows; ++r)
+    {
+        auto [first, last] = rowCells (range.firstRow + r);
+        first = std::lower_bound (first, last, range.firstCol,
+                                  [] (const auto &cell, std::size_t col)
+                                  { return cell.col < col; });
+        Out *out = block.cells.data () + r * block.cols;
+        for (; first != last && first->col <= range.lastCol; ++first)
+        {
+            out[first->col - range.firstCol] = convert (first);
+        }
+    }
+    return block;
+}
+
+} // namespace batch
+
+#endif
@@ -0,0 +1,575 @@
+#ifndef COLUMNBUFFER_H
+#define COLUMNBUFFER_H
+
+#include "SparseSheet.h"
+#include "XlsCell.h"
+#include "XlsCellView.h"
+#include "XlsxSheet.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class ColumnType : uint8_t
+{
+    EMPTY = 0, // 整列没有值
+    NUMBER,
+    BOOL,
+    DATE,
+    STRING
+};
+
+// 字符串列的输出方式
+enum class StringEncoding : uint8_t
+{
+    PLAIN = 0,  // 每行的文本依次存放在 chars 中
+    DICTIONARY  // 每行一个 uint32 编码, 文本只在字典中存放一次
+};
+
+// 字典: 互不相同的字符串, 第 i 个位于 chars[offsets[i], offsets[i+1])
+struct StringDictionary
+{
+    std::vector<int64_t> offsets{ 0 };
+    std::vector<char> chars;
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return offsets.size () - 1;
+    }
+
+    [[nodiscard]] std::string_view
+    get (std::size_t i) const
+    {
+        return { chars.data () + offsets[i],
+                 static_cast<std::size_t> (offsets[i + 1] - offsets[i]) };
+    }
+};
+
+// 一列数据, 布局与 Arrow 一致:
+//   validity 有效位图, 第 i 行对应第 i/8 字节的第 i%8 位, 1 为有效
+//   NUMBER  numbers[i]
+//   BOOL    bools 位图
+//   DATE    dates[i], Unix 纪元以来的毫秒数
+//   STRING  chars[offsets[i], offsets[i+1]), offsets 长度为 length+1;
+//           字典编码时为 dictionary->get (codes[i]), offsets / chars 为空
+// 只有与 type 对应的缓冲区有内容
+struct ColumnBuffer
+{
+    ColumnType type = ColumnType::EMPTY;
+    std::size_t length = 0;
+    std::size_t nullCount = 0;
+    std::vector<uint8_t> validity;
+    std::vector<double> numbers;
+    std::vector<uint8_t> bools;
+    std::vector<int64_t> dates;
+    std::vector<int64_t> offsets;
+    std::vector<char> chars;
+    std::vector<uint32_t> codes;
+    // 同一次读取的字符串列共用一个字典, 编码可以跨列比较
+    std::shared_ptr<const StringDictionary> dictionary;
+
+    [[nodiscard]] bool
+    dictionaryEncoded () const
+    {
+        return dictionary != nullptr;
+    }
+
+    [[nodiscard]] bool
+    valid (std::size_t i) const
+    {
+        return (validity[i / 8] >> (i % 8) & 1u) != 0;
+    }
+
+    [[nodiscard]] bool
+    boolAt (std::size_t i) const
+    {
+        return (bools[i / 8] >> (i % 8) & 1u) != 0;
+    }
+
+    [[nodiscard]] std::string_view
+    stringAt (std::size_t i) const
+    {
+        if (dictionary != nullptr)
+        {
+            return dictionary->get (codes[i]);
+        }
+        return { chars.data () + offsets[i],
+                 static_cast<std::size_t> (offsets[i + 1] - offsets[i]) };
+    }
+};
+
+// 整张工作表的列式数据, 每列长度都是 rows
+struct SheetColumns
+{
+    std::size_t rows = 0;
+    std::vector<ColumnBuffer> columns;
+};
+
+namespace columnar
+{
+
+// Excel 日期序列号转 Unix 毫秒, 1900 日期系统不处理虚构的 1900-02-29
+inline int64_t
+serialToUnixMillis (double serial, bool date1904)
+{
+    constexpr double MillisPerDay = 86400000.0;
+    const double epoch = date1904 ? 24107.0 : 25569.0;
+    return static_cast<int64_t> (
+        std::llround ((serial - epoch) * MillisPerDay));
+}
+
+inline void
+setBit (std::vector<uint8_t> &bits, std::size_t i, bool value)
+{
+    if (value)
+    {
+        bits[i / 8] |= static_cast<uint8_t> (1u << (i % 8));
+    }
+}
+
+// 按取样的单元格推断列类型, 取样结束后列类型固定
+// 非空值全是数值为 NUMBER, 全是 TRUE / FALSE 为 BOOL, 全是日期为 DATE,
+// 混合或含其它文本为 STRING (不丢失任何值), 没有非空值为 EMPTY
+class TypeSampler
+{
+  private:
+    unsigned seen_ = 0; // 见过的 CellType 位集合
+
+    static constexpr unsigned
+    bit (CellType type)
+    {
+        return 1u << static_cast<unsigned> (type);
+    }
+
+  public:
+    // 已推断类型的单元格 (XLS / XLSX 单元格视图的 type ())
+    void
+    observe (CellType type)
+    {
+        seen_ |= bit (type);
+    }
+
+    // 文本字段 (CSV), 按 inferTextType 推断
+    void
+    observe (std::string_view text)
+    {
+        observe (inferTextType (text));
+    }
+
+    [[nodiscard]] ColumnType
+    type () const
+    {
+        const unsigned values
+            = seen_ & ~(bit (CellType::BLANK) | bit (CellType::UNKNOWN));
+        if (values == 0)
+        {
+            return ColumnType::EMPTY;
+        }
+        if (values == bit (CellType::NUMBER))
+        {
+            return ColumnType::NUMBER;
+        }
+        if (values == bit (CellType::BOOL))
+        {
+            return ColumnType::BOOL;
+        }
+        if (values == bit (CellType::DATE))
+        {
+            return ColumnType::DATE;
+        }
+        return ColumnType::STRING;
+    }
+};
+
+// 取样全部行
+constexpr std::size_t SampleAllRows = static_cast<std::size_t> (-1);
+
+// 未引用共享字符串表的单元格
+constexpr std::size_t NoSharedString = static_cast<std::size_t> (-1);
+
+// 字符串驻留池, 为每个不同的字符串分配从 0 开始的编码
+// 散列表 slots_ 使用开放寻址, 只存编码, 比较时取字典中的文本
+// 共享字符串表 (XLS 的 SST, XLSX 的 sharedStrings.xml) 中的字符串按下标
+// 记住编码, 同一表项只散列一次
+class StringPool
+{
+  private:
+    static constexpr uint32_t Empty = static_cast<uint32_t> (-1);
+
+    std::shared_ptr<StringDictionary> dict_;
+    std::vector<uint32_t> slots_;
+    std::vector<uint32_t> shared_;
+    std::size_t sharedCount_ = 0;
+
+    void
+    rehash (std::size_t capacity)
+    {
+        slots_.assign (capacity, Empty);
+        for (uint32_t code = 0; code < dict_->size (); ++code)
+        {
+            std::size_t i = std::hash<std::string_view> () (dict_->get (code))
+                            & (capacity - 1);
+            while (slots_[i] != Empty)
+            {
+                i = (i + 1) & (capacity - 1);
+            }
+            slots_[i] = code;
+        }
+    }
+
+  public:
+    // sharedCount 为共享字符串表的大小, 没有时为 0
+    explicit StringPool (std::size_t sharedCount = 0)
+        : dict_ (std::make_shared<StringDictionary> ()),
+          sharedCount_ (sharedCount)
+    {
+        rehash (64);
+    }
+
+    uint32_t
+    intern (std::string_view text)
+    {
+        const std::size_t mask = slots_.size () - 1;
+        std::size_t i = std::hash<std::string_view> () (text) & mask;
+        for (; slots_[i] != Empty; i = (i + 1) & mask)
+        {
+            if (dict_->get (slots_[i]) == text)
+            {
+                return slots_[i];
+            }
+        }
+
+        const auto code = static_cast<uint32_t> (dict_->size ());
+        dict_->chars.insert (dict_->chars.end (), text.begin (), text.end ());
+        dict_->offsets.push_back (static_cast<int64_t> (dict_->chars.size ()));
+        slots_[i] = code;
+        // 负载不超过 1/2
+        if (dict_->size () * 2 > slots_.size ())
+        {
+            rehash (slots_.size () * 2);
+        }
+        return code;
+    }
+
+    // 共享字符串表第 index 项, text 为其文本
+    uint32_t
+    shared (std::size_t index, std::string_view text)
+    {
+        if (index >= sharedCount_)
+        {
+            return intern (text);
+        }
+        if (shared_.empty ())
+        {
+            shared_.assign (sharedCount_, Empty);
+        }
+        auto &code = shared_[index];
+        if (code == Empty)
+        {
+            code = intern (text);
+        }
+        return code;
+    }
+
+    [[nodiscard]] std::shared_ptr<const StringDictionary>
+    dictionary () const
+    {
+        return dict_;
+    }
+};
+
+// 逐行追加单元格的列构建器, 列类型在构造时给定 (见 TypeSampler)
+// 与列类型不同的单元格只在取样之外出现; 能够表示的按列类型转换,
+// 无法表示的 (如数值列中的文本) 记为空值
+// STRING 列中的字符串单元格保存原文 (text ()), 不按推断出的数值重新格式化
+// pool 不为空时字符串列按字典编码, 字典由 pool 持有
+class ColumnBuilder
+{
+  private:
+    ColumnBuffer col_;
+    bool date1904_ = false;
+    StringPool *pool_ = nullptr;
+
+    void
+    grow (std::size_t length)
+    {
+        const std::size_t bytes = (length + 7) / 8;
+        col_.validity.resize (bytes, 0);
+        switch (col_.type)
+        {
+        case ColumnType::NUMBER:
+            col_.numbers.resize (length, 0.0);
+            break;
+        case ColumnType::BOOL:
+            col_.bools.resize (bytes, 0);
+            break;
+        case ColumnType::DATE:
+            col_.dates.resize (length, 0);
+            break;
+        case ColumnType::STRING:
+            if (pool_ != nullptr)
+            {
+                col_.codes.resize (length, 0);
+                break;
+            }
+            col_.offsets.resize (length + 1,
+                                 static_cast<int64_t> (col_.chars.size ()));
+            break;
+        case ColumnType::EMPTY:
+            break;
+        }
+    }
+
+    // 补齐到 row 行 (不含), 中间都是空值
+    void
+    padTo (std::size_t row)
+    {
+        if (row > col_.length)
+        {
+            col_.nullCount += row - col_.length;
+            col_.length = row;
+            grow (row);
+        }
+    }
+
+    void
+    appendString (std::size_t i, std::string_view text,
+                  std::size_t shared = NoSharedString)
+    {
+        if (pool_ != nullptr)
+        {
+            col_.codes[i] = shared != NoSharedString
+                                ? pool_->shared (shared, text)
+                                : pool_->intern (text);
+            return;
+        }
+        col_.chars.insert (col_.chars.end (), text.begin (), text.end ());
+        col_.offsets[i + 1] = static_cast<int64_t> (col_.chars.size ());
+    }
+
+    // 写入第 i 行, 返回是否有效
+    template <typename View>
+    bool
+    store (std::size_t i, const View &cell, CellType type, std::size_t shared)
+    {
+        switch (col_.type)
+        {
+        case ColumnType::NUMBER:
+            if (type != CellType::NUMBER && type != CellType::DATE)
+            {
+                return false;
+            }
+            col_.numbers[i] = cell.asDouble ();
+            return true;
+
+        case ColumnType::BOOL:
+            if (type != CellType::BOOL)
+            {
+                return false;
+            }
+            setBit (col_.bools, i, cell.asLogical ());
+            return true;
+
+        case ColumnType::DATE:
+            if (type != CellType::DATE && type != CellType::NUMBER)
+            {
+                return false;
+            }
+            col_.dates[i] = serialToUnixMillis (cell.asDouble (), date1904_);
+            return true;
+
+        case ColumnType::STRING:
+        {
+            // 字符串单元格无论推断为何种类型都保存原文, 如 "007", "1e3"
+            const std::string_view text = cell.text ();
+            if (!text.empty ())
+            {
+                appendString (i, text, shared);
+                return true;
+            }
+            if (type == CellType::BOOL)
+            {
+                appendString (i, cell.asDouble () != 0.0 ? "TRUE" : "FALSE");
+                return true;
+            }
+            char buf[XlsCell::MaxDoubleLength];
+            appendString (i, { buf, XlsCell::formatDouble (cell.asDouble (),
+                                                           buf) });
+            return true;
+        }
+
+        case ColumnType::EMPTY:
+            break;
+        }
+        return false;
+    }
+
+  public:
+    explicit ColumnBuilder (ColumnType type, bool date1904,
+                            StringPool *pool = nullptr)
+        : date1904_ (date1904), pool_ (pool)
+    {
+        col_.type = type;
+    }
+
+    void
+    reserve (std::size_t rows)
+    {
+        col_.validity.reserve ((rows + 7) / 8);
+    }
+
+    // View 为 XlsCellView 或 XlsxCellView; shared 为单元格引用的共享
+    // 字符串表下标
+    template <typename View>
+    void
+    append (std::size_t row, const View &cell,
+            std::size_t shared = NoSharedString)
+    {
+        const CellType type = cell.type ();
+        if (type == CellType::BLANK || type == CellType::UNKNOWN)
+        {
+            return;
+        }
+
+        padTo (row);
+        const std::size_t i = col_.length;
+        col_.length = i + 1;
+        grow (col_.length);
+        if (store (i, cell, type, shared))
+        {
+            setBit (col_.validity, i, true);
+        }
+        else
+        {
+            ++col_.nullCount;
+        }
+    }
+
+    ColumnBuffer
+    finish (std::size_t rows)
+    {
+        padTo (rows);
+        if (pool_ != nullptr && col_.type == ColumnType::STRING)
+        {
+            col_.dictionary = pool_->dictionary ();
+        }
+        return std::move (col_);
+    }
+};
+
+// [first, last) 为按 (row, col) 排序的单元格
+// 先取样第 [skipRows, skipRows + sampleRows) 行, 与 csv::inferColumnTypes
+// 一样用 TypeSampler 确定每列类型; 再遍历一次按列写入
+// view (cell) 返回单元格视图, shared (cell) 返回共享字符串表下标
+template <typename Cell, typename ViewOf, typename SharedOf>
+SheetColumns
+collectColumns (const Cell *first, const Cell *last, std::size_t rowCount,
+                std::size_t colCount, bool date1904, std::size_t skipRows,
+                std::size_t sampleRows, StringPool *pool, ViewOf &&view,
+                SharedOf &&shared)
+{
+    SheetColumns out;
+    out.rows = rowCount > skipRows ? rowCount - skipRows : 0;
+
+    std::vector<TypeSampler> samplers (colCount);
+    for (const Cell *cell = first; cell != last; ++cell)
+    {
+        if (cell->row < skipRows)
+        {
+            continue;
+        }
+        if (cell->row - skipRows >= sampleRows)
+        {
+            break;
+        }
+        samplers[cell->col].observe (view (*cell).type ());
+    }
+
+    std::vector<ColumnBuilder> builders;
+    builders.reserve (colCount);
+    for (const auto &sampler : samplers)
+    {
+        builders.emplace_back (sampler.type (), date1904, pool);
+        builders.back ().reserve (out.rows);
+    }
+
+    for (const Cell *cell = first; cell != last; ++cell)
+    {
+        if (cell->row < skipRows)
+        {
+            continue;
+        }
+        builders[cell->col].append (cell->row - skipRows, view (*cell),
+                                    shared (*cell));
+    }
+
+    out.columns.reserve (builders.size ());
+    for (auto &builder : builders)
+    {
+        out.columns.push_back (builder.finish (out.rows));
+    }
+    return out;
+}
+
+} // namespace columnar
+
+// 稀疏单元格按列写入类型化的连续缓冲区
+// formats 为工作簿格式表, 用于识别日期列; date1904 为工作簿的日期系统
+// 前 skipRows 行 (如表头) 不参与取样和导出; 列类型由之后 sampleRows 行
+// 决定, 默认取样全部行, 类型混合的列为 STRING, 不丢失任何值
+// DICTIONARY: 字符串列共用一个字典, 引用 SST 的单元格按 SST 下标驻留
+inline SheetColumns
+readColumns (const SparseSheet &sheet, const DateFormatCache *formats,
+             bool date1904 = false, std::size_t skipRows = 0,
+             StringEncoding encoding = StringEncoding::PLAIN,
+             std::size_t sampleRows = columnar::SampleAllRows)
+{
+    const auto *sst = sheet.sharedStrings ();
+    columnar::StringPool pool (sst != nullptr ? sst->count : 0);
+    const auto cells = sheet.cells ();
+    return columnar::collectColumns (
+        cells.begin (), cells.end (), sheet.rowCount (), sheet.colCount (),
+        date1904, skipRows, sampleRows,
+        encoding == StringEncoding::DICTIONARY ? &pool : nullptr,
+        [formats] (const xls::xlsCell &cell)
+        { return XlsCellView (&cell, formats); },
+        [&sheet] (const xls::xlsCell &cell)
+        {
+            return sheet.sharesString (cell)
+                       ? static_cast<std::size_t> (cell.l)
+                       : columnar::NoSharedString;
+        });
+}
+
+// XLSX 工作表按列导出, 日期格式取自工作表引用的工作簿格式表
+// 取样与列类型同上
+// DICTIONARY: t="s" 的单元格按 sharedStrings.xml 下标驻留
+inline SheetColumns
+readColumns (const XlsxSheet &sheet, bool date1904 = false,
+             std::size_t skipRows = 0,
+             StringEncoding encoding = StringEncoding::PLAIN,
+             std::size_t sampleRows = columnar::SampleAllRows)
+{
+    const auto *shared = sheet.sharedStrings ();
+    columnar::StringPool pool (shared != nullptr ? shared->size () : 0);
+    return columnar::collectColumns (
+        sheet.begin (), sheet.end (), sheet.rowCount (), sheet.colCount (),
+        date1904, skipRows, sampleRows,
+        encoding == StringEncoding::DICTIONARY ? &pool : nullptr,
+        [&sheet] (const XlsxCell &cell)
+        { return XlsxCellView (&cell, &sheet); },
+        [] (const XlsxCell &cell)
+        {
+            return cell.value == XlsxValue::SHARED
+                       ? static_cast<std::size_t> (cell.str)
+                       : columnar::NoSharedString;
+        });
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef CSVCOLUMNS_H
+#define CSVCOLUMNS_H
+
+#include "ColumnBuffer.h"
+#include "CsvParser.h"
+#include "NumberParse.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CSV 的列式读取
+// 先取样开头若干条记录, 每列按 columnar::TypeSampler 确定类型; 之后每个
+// 字段只按所在列的类型解析一次: 数值列只做数值解析, 布尔列只比较
+// TRUE / FALSE, 字符串列直接复制, 不再逐个字段尝试所有类型
+// 与列类型不符的值 (如数值列中的 "N/A") 记为空值, 与 ColumnBuilder 相同
+namespace csv
+{
+
+// 默认取样的记录数
+constexpr std::size_t DefaultSampleRows = 1000;
+
+// 取样第 [first, first + sampleRows) 条记录, 推断每列类型
+inline std::vector<ColumnType>
+inferColumnTypes (std::string_view text, const CsvIndex &index,
+                  const Dialect &dialect, std::size_t first = 0,
+                  std::size_t sampleRows = DefaultSampleRows)
+{
+    std::vector<columnar::TypeSampler> samplers (index.columns);
+    const std::size_t rows = index.rowCount ();
+    first = std::min (first, rows);
+    const std::size_t last = std::min (rows - first, sampleRows) + first;
+    std::string scratch;
+    forEachRecordIn (text, index, first, last, dialect,
+                     [&] (const CsvRow &row)
+                     {
+                         for (std::size_t col = 0; col < row.size (); ++col)
+                         {
+                             samplers[col].observe (row[col].value (scratch));
+                         }
+                     });
+
+    std::vector<ColumnType> types;
+    types.reserve (samplers.size ());
+    for (const auto &sampler : samplers)
+    {
+        types.push_back (sampler.type ());
+    }
+    return types;
+}
+
+namespace detail
+{
+
+// 按固定的列类型把记录写入各列缓冲区
+class ColumnWriter
+{
+  private:
+    SheetColumns &out_;
+    std::vector<std::size_t> valid_;
+    std::string scratch_;
+
+    bool
+    store (ColumnBuffer &col, std::size_t i, std::string_view text)
+    {
+        switch (col.type)
+        {
+        case ColumnType::NUMBER:
+            return numparse::parseNumericText (text, col.numbers[i]);
+
+        case ColumnType::BOOL:
+        {
+            bool flag;
+            if (!numparse::parseBoolText (text, flag))
+            {
+                return false;
+            }
+            columnar::setBit (col.bools, i, flag);
+            return true;
+        }
+
+        case ColumnType::STRING:
+            col.chars.insert (col.chars.end (), text.begin (), text.end ());
+            return true;
+
+        case ColumnType::DATE:
+        case ColumnType::EMPTY:
+            break;
+        }
+        return false;
+    }
+
+  public:
+    ColumnWriter (SheetColumns &out, const std::vector<ColumnType> &types)
+        : out_ (out), valid_ (types.size (), 0)
+    {
+        const std::size_t rows = out_.rows;
+        out_.columns.resize (types.size ());
+        for (std::size_t c = 0; c < types.size (); ++c)
+        {
+            auto &col = out_.columns[c];
+            col.type = types[c];
+            col.length = rows;
+            col.validity.assign ((rows + 7) / 8, 0);
+            switch (col.type)
+            {
+            case ColumnType::NUMBER:
+                col.numbers.assign (rows, 0.0);
+                break;
+            case ColumnType::BOOL:
+                col.bools.assign ((rows + 7) / 8, 0);
+                break;
+            case ColumnType::STRING:
+                col.offsets.assign (rows + 1, 0);
+                break;
+            case ColumnType::DATE:
+            case ColumnType::EMPTY:
+                break;
+            }
+        }
+    }
+
+    // 写入第 i 行; 缺少的字段和空字段为空值
+    void
+    write (std::size_t i, const CsvRow &row)
+    {
+        for (std::size_t c = 0; c < out_.columns.size (); ++c)
+        {
+            auto &col = out_.columns[c];
+            const auto text = row[c].value (scratch_);
+            if (!text.empty () && store (col, i, text))
+            {
+                columnar::setBit (col.validity, i, true);
+                ++valid_[c];
+            }
+            if (col.type == ColumnType::STRING)
+            {
+                col.offsets[i + 1] = static_cast<int64_t> (col.chars.size ());
+            }
+        }
+    }
+
+    void
+    finish ()
+    {
+        for (std::size_t c = 0; c < out_.columns.size (); ++c)
+        {
+            out_.columns[c].nullCount = out_.rows - valid_[c];
+        }
+    }
+};
+
+} // namespace detail
+
+// 全部记录读成列, 前 skipRows 条记录 (如表头) 不参与取样和导出
+// 列数为所有记录中最多的字段数
+inline SheetColumns
+readColumns (std::string_view text, const CsvIndex &index,
+             const Dialect &dialect, std::size_t skipRows = 0,
+             std::size_t sampleRows = DefaultSampleRows)
+{
+    const std::size_t rows = index.rowCount ();
+    skipRows = std::min (skipRows, rows);
+
+    SheetColumns out;
+    out.rows = rows - skipRows;
+    detail::ColumnWriter writer (
+        out, inferColumnTypes (text, index, dialect, skipRows, sampleRows));
+    forEachRecordIn (text, index, skipRows, rows, dialect,
+                     [&] (const CsvRow &row)
+                     { writer.write (row.index () - skipRows, row); });
+    writer.finish ();
+    return out;
+}
+
+} // namespace csv
+
+#endif
@@ -0,0 +1,657 @@
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include "CsvSimd.h"
+#include "Parallel.h"
+#include "XlsCell.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// CSV 分词 (RFC 4180, 宽松处理)
+// 字段以 string_view 指向输入, 只有含 "" 转义的字段在取值时才复制
+// 记录以 "\n", "\r\n" 或单独的 "\r" 结束; 引号内的换行属于字段内容
+// 整段文本的分词和建索引按 CsvSimd.h 的块位图进行, 遇到位图无法处理的
+// 引号时从当前记录起改用逐字节的 parseRecord, 两者结果相同
+namespace csv
+{
+
+struct Dialect
+{
+    char delimiter = ',';
+    char quote = '"';
+};
+
+// 一个字段
+// 未加引号, 或加引号但不含转义时, raw 就是字段值 (不含引号);
+// escaped 时 raw 为开引号之后到字段结束的原文, 由 value () 解码
+struct CsvField
+{
+    std::string_view raw;
+    bool quoted = false;
+    bool escaped = false;
+    char quote = '"';
+
+    // 字段值; 需要解码时写入 scratch 并指向它
+    std::string_view
+    value (std::string &scratch) const
+    {
+        if (!escaped)
+        {
+            return raw;
+        }
+        scratch.clear ();
+        bool inQuote = true;
+        for (std::size_t i = 0; i < raw.size (); ++i)
+        {
+            const char c = raw[i];
+            if (c != quote)
+            {
+                scratch.push_back (c);
+            }
+            else if (inQuote && i + 1 < raw.size () && raw[i + 1] == quote)
+            {
+                scratch.push_back (quote);
+                ++i;
+            }
+            else
+            {
+                inQuote = !inQuote;
+            }
+        }
+        return scratch;
+    }
+
+    [[nodiscard]] std::string
+    text () const
+    {
+        std::string scratch;
+        const auto v = value (scratch);
+        return escaped ? scratch : std::string (v);
+    }
+
+    [[nodiscard]] bool
+    empty () const
+    {
+        return raw.empty ();
+    }
+};
+
+// 按字段内容推断类型, 见 inferTextType
+inline CellType
+classify (std::string_view text)
+{
+    return inferTextType (text);
+}
+
+inline CellType
+classify (const CsvField &field)
+{
+    std::string scratch;
+    return classify (field.value (scratch));
+}
+
+// 跳过开头的 UTF-8 BOM
+inline std::size_t
+bomLength (std::string_view text)
+{
+    return text.substr (0, 3) == "\xEF\xBB\xBF" ? 3 : 0;
+}
+
+// 解析 p 开始的一条记录, 对每个字段调用 fn(const CsvField&),
+// 返回下一条记录的起点; 调用方保证 p < end
+template <typename Fn>
+const char *
+parseRecord (const char *p, const char *end, const Dialect &dialect, Fn &&fn)
+{
+    const char delimiter = dialect.delimiter;
+    const char quote = dialect.quote;
+    for (;;)
+    {
+        CsvField field;
+        field.quote = quote;
+        const char *q = p;
+        if (p < end && *p == quote)
+        {
+            const char *begin = ++p;
+            for (;;)
+            {
+                p = static_cast<const char *> (std::memchr (
+                    p, quote, static_cast<std::size_t> (end - p)));
+                if (p == nullptr)
+                {
+                    p = end;
+                    break;
+                }
+                if (p + 1 < end && p[1] == quote)
+                {
+                    field.escaped = true;
+                    p += 2;
+                    continue;
+                }
+                break;
+            }
+            const char *close = p;
+            q = p < end ? p + 1 : end;
+            // 闭引号之后到分隔符之间的字符按原样接在值后面
+            const char *after = q;
+            while (q < end && *q != delimiter && *q != '\n' && *q != '\r')
+            {
+                ++q;
+            }
+            field.quoted = true;
+            field.escaped = field.escaped || q != after;
+            field.raw = { begin, static_cast<std::size_t> (
+                                     (field.escaped ? q : close) - begin) };
+        }
+        else
+        {
+            while (q < end && *q != delimiter && *q != '\n' && *q != '\r')
+            {
+                ++q;
+            }
+            field.raw = { p, static_cast<std::size_t> (q - p) };
+        }
+        fn (static_cast<const CsvField &> (field));
+
+        if (q < end && *q == delimiter)
+        {
+            p = q + 1;
+            continue;
+        }
+        if (q < end && *q == '\r')
+        {
+            ++q;
+        }
+        if (q < end && *q == '\n')
+        {
+            ++q;
+        }
+        return q;
+    }
+}
+
+// 字段 [begin, end) 的原文 (含引号) 转为 CsvField, 与 parseRecord 一致
+inline CsvField
+makeField (const char *begin, const char *end, char quote)
+{
+    CsvField field;
+    field.quote = quote;
+    if (begin == end || *begin != quote)
+    {
+        field.raw = { begin, static_cast<std::size_t> (end - begin) };
+        return field;
+    }
+    field.quoted = true;
+    const char *inner = begin + 1;
+    const char *stop = end > inner && end[-1] == quote ? end - 1 : end;
+    // 内部还有引号: "" 转义, 或闭引号之后还有字符
+    if (std::memchr (inner, quote, static_cast<std::size_t> (stop - inner))
+        != nullptr)
+    {
+        field.escaped = true;
+        stop = end;
+    }
+    field.raw = { inner, static_cast<std::size_t> (stop - inner) };
+    return field;
+}
+
+// 从记录开头分词 [begin, end), 依次调用
+//   sink.field (const CsvField&)       每个字段
+//   sink.record (const char *next)     记录结束, next 为下一条记录的起点;
+//                                      返回 false 时停止
+//   sink.restart ()                    改用标量分词前, 丢弃未结束记录中
+//                                      已经送出的字段
+template <typename Sink>
+void
+tokenize (const char *begin, const char *end, const Dialect &dialect,
+          Sink &sink, const csvsimd::Kernels &kernels = csvsimd::active ())
+{
+    const char quote = dialect.quote;
+    const char *recordStart = begin;
+    const char *fieldBegin = begin;
+    // 标量级别直接逐字节分词, 逐字节建位图比 parseRecord 慢
+    if (kernels.level != csvsimd::Level::SCALAR)
+    {
+        csvsimd::StructureScanner scanner (begin, end, dialect.delimiter,
+                                           quote, kernels);
+        csvsimd::Block block;
+        while (scanner.next (block))
+        {
+            for (uint64_t bits = block.delimiters | block.terminators;
+                 bits != 0; bits &= bits - 1)
+            {
+                const unsigned i = csvsimd::lowestBit (bits);
+                const char *pos = block.base + i;
+                sink.field (makeField (fieldBegin, pos, quote));
+                if ((block.terminators >> i & 1) == 0)
+                {
+                    fieldBegin = pos + 1;
+                    continue;
+                }
+                const char *next = pos + 1;
+                if (*pos == '\r' && next < end && *next == '\n')
+                {
+                    ++next;
+                }
+                recordStart = fieldBegin = next;
+                if (!sink.record (next))
+                {
+                    return;
+                }
+            }
+        }
+        if (!scanner.malformed ())
+        {
+            if (recordStart < end)
+            {
+                sink.field (makeField (fieldBegin, end, quote));
+                sink.record (end);
+            }
+            return;
+        }
+        sink.restart ();
+    }
+
+    for (const char *p = recordStart; p < end;)
+    {
+        p = parseRecord (p, end, dialect,
+                         [&sink] (const CsvField &field)
+                         { sink.field (field); });
+        if (!sink.record (p))
+        {
+            return;
+        }
+    }
+}
+
+// 记录起点索引: 第 i 条记录为 [starts[i], starts[i + 1])
+// 末尾的换行不产生空记录, 中间的空行是只有一个空字段的记录
+struct CsvIndex
+{
+    std::vector<std::size_t> starts;
+    std::size_t columns = 0;
+
+    [[nodiscard]] std::size_t
+    rowCount () const
+    {
+        return starts.empty () ? 0 : starts.size () - 1;
+    }
+};
+
+namespace detail
+{
+
+// 从记录开头 p 起逐字节建索引, 直到记录起点不小于 limit 或到达 end;
+// 返回停下时的记录起点 (或 end)
+inline const char *
+indexScalar (const char *begin, const char *p, const char *limit,
+             const char *end, const Dialect &dialect, CsvIndex &index)
+{
+    while (p < limit && p < end)
+    {
+        index.starts.push_back (static_cast<std::size_t> (p - begin));
+        std::size_t fields = 0;
+        p = parseRecord (p, end, dialect,
+                         [&fields] (const CsvField &) { ++fields; });
+        index.columns = std::max (index.columns, fields);
+    }
+    return p;
+}
+
+// 同 indexScalar, 按块位图统计: 只取出记录结束位, 其前面的分隔符个数
+// 用 popcount 得到, 不逐个生成字段
+inline const char *
+indexRange (const char *begin, const char *from, const char *limit,
+            const char *end, const Dialect &dialect,
+            const csvsimd::Kernels &kernels, CsvIndex &index)
+{
+    if (kernels.level == csvsimd::Level::SCALAR)
+    {
+        return indexScalar (begin, from, limit, end, dialect, index);
+    }
+    if (from >= limit || from >= end)
+    {
+        return from;
+    }
+    const std::size_t firstRow = index.starts.size ();
+    index.starts.push_back (static_cast<std::size_t> (from - begin));
+
+    const char *recordStart = from;
+    std::size_t delimiters = 0;
+    csvsimd::StructureScanner scanner (from, end, dialect.delimiter,
+                                       dialect.quote, kernels);
+    csvsimd::Block block;
+    while (scanner.next (block))
+    {
+        uint64_t pending = block.delimiters;
+        for (uint64_t bits = block.terminators; bits != 0; bits &= bits - 1)
+        {
+            const unsigned i = csvsimd::lowestBit (bits);
+            const uint64_t before = (uint64_t (1) << i) - 1;
+            delimiters += csvsimd::popCount (pending & before);
+            pending &= ~before;
+            index.columns = std::max (index.columns, delimiters + 1);
+            delimiters = 0;
+
+            const char *next = block.base + i + 1;
+            if (next[-1] == '\r' && next < end && *next == '\n')
+            {
+                ++next;
+            }
+            recordStart = next;
+            if (next >= limit || next >= end)
+            {
+                return next;
+            }
+            index.starts.push_back (static_cast<std::size_t> (next - begin));
+        }
+        delimiters += csvsimd::popCount (pending);
+    }
+
+    if (scanner.malformed ())
+    {
+        // 当前记录已经登记过起点, 由逐字节分词重新登记
+        if (index.starts.size () > firstRow)
+        {
+            index.starts.pop_back ();
+        }
+        return indexScalar (begin, recordStart, limit, end, dialect, index);
+    }
+    index.columns = std::max (index.columns, delimiters + 1);
+    return end;
+}
+
+// 按开头 64 KiB 的平均行长估计记录数, 用于预留索引
+inline std::size_t
+estimateRecords (std::string_view text)
+{
+    const auto sample = text.substr (0, 65536);
+    const auto lines = static_cast<std::size_t> (
+        std::count (sample.begin (), sample.end (), '\n'));
+    return lines == 0 ? 0 : text.size () / sample.size () * lines + lines + 2;
+}
+
+} // namespace detail
+
+inline CsvIndex
+indexRecords (std::string_view text, const Dialect &dialect = {},
+              const csvsimd::Kernels &kernels = csvsimd::active ())
+{
+    CsvIndex index;
+    index.starts.reserve (detail::estimateRecords (text));
+    const char *begin = text.data ();
+    const char *end = begin + text.size ();
+    detail::indexRange (begin, begin + bomLength (text), end, end, dialect,
+                        kernels, index);
+    index.starts.push_back (text.size ());
+    return index;
+}
+
+namespace detail
+{
+
+// 文本按字节均分为 chunks 块, 用 threads 个线程建索引
+// 第 i 块负责起点落在 [b_i, b_(i+1)) 中的记录; 块起点是否在引号内事先
+// 不知道, 先推测 b_i 之后的第一个 '\n' 结束一条记录, 各块并行建索引
+// 合并时依次检查: 前一块停下的位置 (真实的记录起点) 与本块推测的
+// 起点相同时两者从同一记录起点开始, 结果一致; 不同时 (推测落在引号内
+// 的换行或 '\r' 结尾的记录上) 从前一块停下的位置重建本块
+inline CsvIndex
+indexChunks (std::string_view text, const Dialect &dialect,
+             std::size_t chunks, std::size_t threads,
+             const csvsimd::Kernels &kernels)
+{
+    chunks = std::max<std::size_t> (1, std::min (chunks, text.size ()));
+    const char *begin = text.data ();
+    const char *end = begin + text.size ();
+    std::vector<const char *> bounds (chunks + 1);
+    for (std::size_t i = 0; i <= chunks; ++i)
+    {
+        bounds[i] = begin + text.size () / chunks * i;
+    }
+    bounds[0] = begin + bomLength (text);
+    bounds[chunks] = end;
+
+    std::vector<CsvIndex> parts (chunks);
+    std::vector<const char *> firsts (chunks);
+    std::vector<const char *> stops (chunks);
+    auto build = [&] (std::size_t i, const char *first)
+    {
+        parts[i] = CsvIndex ();
+        firsts[i] = first;
+        stops[i] = indexRange (begin, first, bounds[i + 1], end, dialect,
+                               kernels, parts[i]);
+    };
+    parallelFor (chunks, threads,
+                 [&] (std::size_t i)
+                 {
+                     const char *first = bounds[i];
+                     if (i > 0)
+                     {
+                         const auto *lf = static_cast<const char *> (
+                             std::memchr (first - 1, '\n',
+                                          static_cast<std::size_t> (
+                                              end - first + 1)));
+                         first = lf != nullptr ? lf + 1 : end;
+                     }
+                     build (i, first);
+                 });
+
+    CsvIndex index;
+    index.starts.reserve (estimateRecords (text));
+    for (std::size_t i = 0; i < chunks; ++i)
+    {
+        if (i > 0 && firsts[i] != stops[i - 1])
+        {
+            build (i, stops[i - 1]);
+        }
+        index.starts.insert (index.starts.end (), parts[i].starts.begin (),
+                             parts[i].starts.end ());
+        index.columns = std::max (index.columns, parts[i].columns);
+    }
+    index.starts.push_back (text.size ());
+    return index;
+}
+
+} // namespace detail
+
+// 多线程建索引, 结果与 indexRecords 相同; 每块至少 1 MiB,
+// threads <= 1 或文本较小时直接调用 indexRecords
+inline CsvIndex
+indexRecordsParallel (std::string_view text, const Dialect &dialect,
+                      std::size_t threads,
+                      const csvsimd::Kernels &kernels = csvsimd::active ())
+{
+    constexpr std::size_t MinChunk = std::size_t (1) << 20;
+    const std::size_t chunks = std::min (threads, text.size () / MinChunk);
+    if (chunks <= 1)
+    {
+        return indexRecords (text, dialect, kernels);
+    }
+    return detail::indexChunks (text, dialect, chunks, threads, kernels);
+}
+
+// 一条记录的全部字段, 字段指向输入文本
+// 可以反复用于不同的记录, 避免重新分配
+class CsvRow
+{
+  private:
+    // 只增不减的字段缓冲, used_ 之后是之前的行留下的旧值
+    std::vector<CsvField> fields_;
+    std::size_t used_ = 0;
+    std::size_t index_ = 0;
+
+  public:
+    // 分词第 row 条记录
+    void
+    parse (std::string_view text, const CsvIndex &index, std::size_t row,
+           const Dialect &dialect)
+    {
+        struct Sink
+        {
+            CsvRow &row;
+            void
+            field (const CsvField &field)
+            {
+                row.push (field);
+            }
+            bool
+            record (const char *)
+            {
+                return false;
+            }
+            void
+            restart ()
+            {
+                row.used_ = 0;
+            }
+        } sink{ *this };
+
+        reset (row);
+        tokenize (text.data () + index.starts[row],
+                  text.data () + index.starts[row + 1], dialect, sink);
+    }
+
+    void
+    reset (std::size_t row)
+    {
+        used_ = 0;
+        index_ = row;
+    }
+
+    void
+    push (const CsvField &field)
+    {
+        if (used_ == fields_.size ())
+        {
+            fields_.resize (fields_.size () * 2 + 8);
+        }
+        fields_[used_++] = field;
+    }
+
+    // 记录序号, 从 0 开始
+    [[nodiscard]] std::size_t
+    index () const
+    {
+        return index_;
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return used_;
+    }
+
+    // 超出本行字段数时返回空字段
+    [[nodiscard]] CsvField
+    operator[] (std::size_t col) const
+    {
+        return col < used_ ? fields_[col] : CsvField ();
+    }
+
+    [[nodiscard]] const CsvField *
+    begin () const
+    {
+        return fields_.data ();
+    }
+
+    [[nodiscard]] const CsvField *
+    end () const
+    {
+        return fields_.data () + used_;
+    }
+};
+
+namespace detail
+{
+
+// 把分词结果送入行对象, 每条记录结束时调用 fn; row 为第一条记录的序号
+template <typename Fn>
+struct RowSink
+{
+    CsvRow row;
+    Fn &fn;
+    std::size_t count;
+
+    RowSink (Fn &fn, std::size_t first) : fn (fn), count (first)
+    {
+        row.reset (first);
+    }
+
+    void
+    field (const CsvField &field)
+    {
+        row.push (field);
+    }
+    bool
+    record (const char *)
+    {
+        fn (static_cast<const CsvRow &> (row));
+        row.reset (++count);
+        return true;
+    }
+    void
+    restart ()
+    {
+        row.reset (count);
+    }
+};
+
+} // namespace detail
+
+// 顺序分词整段文本, 每条记录调用 fn(const CsvRow&), 行对象在调用之间复用
+template <typename Fn>
+void
+forEachRecord (std::string_view text, const Dialect &dialect, Fn &&fn)
+{
+    detail::RowSink<Fn> sink (fn, 0);
+    const char *begin = text.data () + bomLength (text);
+    tokenize (begin, text.data () + text.size (), dialect, sink);
+}
+
+// 分词第 [first, last) 条记录, 每条记录调用 fn(const CsvRow&)
+// row.index () 为整个文件中的记录序号
+template <typename Fn>
+void
+forEachRecordIn (std::string_view text, const CsvIndex &index,
+                 std::size_t first, std::size_t last, const Dialect &dialect,
+                 Fn &&fn)
+{
+    if (first >= last)
+    {
+        return;
+    }
+    detail::RowSink<Fn> sink (fn, first);
+    tokenize (text.data () + index.starts[first],
+              text.data () + index.starts[last], dialect, sink);
+}
+
+// 按记录索引把全部记录分成若干段, 用 threads 个线程并发分词
+// fn(const CsvRow&) 会在多个线程中同时调用, 只有同一段内按记录顺序;
+// row.index () 为整个文件中的记录序号
+template <typename Fn>
+void
+forEachRecordParallel (std::string_view text, const CsvIndex &index,
+                       const Dialect &dialect, std::size_t threads, Fn &&fn)
+{
+    const std::size_t rows = index.rowCount ();
+    // 段数多于线程数, 行长不均时各线程负担更平均
+    const std::size_t segments
+        = std::min (rows, std::max<std::size_t> (threads, 1) * 4);
+    parallelFor (segments, threads,
+                 [&] (std::size_t s)
+                 {
+                     forEachRecordIn (text, index, rows * s / segments,
+                                      rows * (s + 1) / segments, dialect,
+                                      fn);
+                 });
+}
+
+} // namespace csv
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include "CsvStrategy.h"
+#include "Exceptions.h"
+#include "reader.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+// CSV 文件作为只有一张工作表的表格读取, 接口与 XLSXReader 相同
+class CSVReader : public TableReader
+{
+  private:
+    std::unique_ptr<CSVReadStrategy> m_strategy;
+    fs::path path_;
+    Span<const std::byte> data_;
+    bool fromMemory_ = false;
+    csv::Dialect dialect_;
+    std::size_t parallelism_;
+    std::size_t sheetCounts_ = 0;
+
+  public:
+    // parallelism: 建索引和 forEachRowParallel 使用的线程数
+    explicit CSVReader (const fs::path &p, const csv::Dialect &dialect = {},
+                        std::size_t parallelism = 1)
+        : path_ (p), dialect_ (dialect), parallelism_ (parallelism)
+    {
+    }
+
+    // 读取内存中的 CSV 文本, 不复制; data 在本对象析构前必须有效
+    explicit CSVReader (Span<const std::byte> data,
+                        const csv::Dialect &dialect = {},
+                        std::size_t parallelism = 1)
+        : data_ (data), fromMemory_ (true), dialect_ (dialect),
+          parallelism_ (parallelism)
+    {
+    }
+
+    bool
+    open () override
+    {
+        try
+        {
+            m_strategy = fromMemory_ ? std::make_unique<CSVReadStrategy> (
+                                           data_, dialect_, parallelism_)
+                                     : std::make_unique<CSVReadStrategy> (
+                                           path_, dialect_, parallelism_);
+        }
+        catch (const ExcelReader::FailedOpenException &)
+        {
+            sheetCounts_ = 0;
+            return false;
+        }
+        sheetCounts_ = m_strategy->sheetCount ();
+        return true;
+    }
+
+    std::size_t
+    getSheetsCount () const override
+    {
+        return sheetCounts_;
+    }
+
+    std::string
+    getSheetName (std::size_t index) const
+    {
+        return m_strategy->getSheetName (index);
+    }
+
+    // 行列从 0 开始; 类型按字段内容推断, 见 csv::classify
+    CellType
+    readCell (std::size_t index, std::size_t row, std::size_t col)
+    {
+        return m_strategy->readCell (index, row, col);
+    }
+
+    // 批量读取, 第 i 个位置的结果写入 out[i]
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<csv::CsvField> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<CellType> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    // 读取区域, 如 "A1:Z100", "C:C", "3:5"; 行优先的稠密块
+    CellBlock<csv::CsvField>
+    readRange (std::size_t index, std::string_view range) const
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    CellBlock<csv::CsvField>
+    readRange (std::size_t index, const CellRange &range) const
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    // 字段指向文件映射, 不能在本对象之后使用
+    csv::CsvField
+    field (std::size_t index, std::size_t row, std::size_t col)
+    {
+        return m_strategy->field (index, row, col);
+    }
+
+    // 按列导出, skipRows 为跳过的表头行数
+    SheetColumns
+    readColumns (std::size_t index, std::size_t skipRows = 0) const
+    {
+        return m_strategy->readColumns (index, skipRows);
+    }
+
+    [[nodiscard]] std::size_t
+    rowCount () const
+    {
+        return m_strategy->rowCount ();
+    }
+
+    [[nodiscard]] std::size_t
+    colCount () const
+    {
+        return m_strategy->colCount ();
+    }
+
+    template <typename Fn>
+    void
+    forEachRow (std::size_t index, Fn &&fn)
+    {
+        m_strategy->forEachRow (index, std::forward<Fn> (fn));
+    }
+
+    // fn 在多个线程中同时调用, 见 CSVReadStrategy::forEachRowParallel
+    template <typename Fn>
+    void
+    forEachRowParallel (std::size_t index, Fn &&fn)
+    {
+        m_strategy->forEachRowParallel (index, std::forward<Fn> (fn));
+    }
+};
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef CSVSIMD_H
+#define CSVSIMD_H
+
+#include "SimdLevel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// CSV 结构字符的块分类 (simdcsv 的做法)
+// 每 64 字节得到引号, 分隔符, '\n', '\r' 四个位图; 引号位图的前缀异或
+// 就是 "在引号内" 的位图, 带进位跨块传递, 引号内的分隔符和换行被屏蔽
+// 前缀异或在支持 PCLMULQDQ 的 CPU 上用无进位乘法 (与全 1 相乘) 计算
+// 级别和 CPU 检测见 SimdLevel.h
+namespace csvsimd
+{
+
+using simd::Level;
+using simd::levelName;
+using simd::lowestBit;
+using simd::popCount;
+
+struct BlockMasks
+{
+    uint64_t quote = 0;
+    uint64_t delimiter = 0;
+    uint64_t newline = 0;
+    uint64_t cr = 0;
+};
+
+struct Kernels
+{
+    Level level;
+    // 分类 p 开始的完整 64 字节
+    void (*classify) (const char *p, char delimiter, char quote,
+                      BlockMasks &out);
+    // 第 i 位为 bits 第 0..i 位的异或
+    uint64_t (*prefixXor) (uint64_t bits);
+};
+
+namespace detail
+{
+
+inline void
+classifyTail (const char *p, std::size_t n, char delimiter, char quote,
+              BlockMasks &out)
+{
+    out = BlockMasks ();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const uint64_t bit = uint64_t (1) << i;
+        const char c = p[i];
+        if (c == quote)
+        {
+            out.quote |= bit;
+        }
+        else if (c == delimiter)
+        {
+            out.delimiter |= bit;
+        }
+        else if (c == '\n')
+        {
+            out.newline |= bit;
+        }
+        else if (c == '\r')
+        {
+            out.cr |= bit;
+        }
+    }
+}
+
+inline void
+classifyScalar (const char *p, char delimiter, char quote, BlockMasks &out)
+{
+    classifyTail (p, 64, delimiter, quote, out);
+}
+
+inline uint64_t
+prefixXorShift (uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+#if SIMD_X86
+
+inline void
+classifySse2 (const char *p, char delimiter, char quote, BlockMasks &out)
+{
+    const __m128i q = _mm_set1_epi8 (quote);
+    const __m128i d = _mm_set1_epi8 (delimiter);
+    const __m128i lf = _mm_set1_epi8 ('\n');
+    const __m128i cr = _mm_set1_epi8 ('\r');
+    out = BlockMasks ();
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i block
+            = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (p + 16 * i));
+        const int shift = 16 * i;
+        auto mask = [&] (__m128i c)
+        {
+            return uint64_t (uint16_t (
+                       _mm_movemask_epi8 (_mm_cmpeq_epi8 (block, c))))
+                   << shift;
+        };
+        out.quote |= mask (q);
+        out.delimiter |= mask (d);
+        out.newline |= mask (lf);
+        out.cr |= mask (cr);
+    }
+}
+
+__attribute__ ((target ("avx2"))) inline uint64_t
+matchAvx2 (__m256i lo, __m256i hi, __m256i c)
+{
+    const auto low
+        = uint32_t (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (lo, c)));
+    const auto high
+        = uint32_t (_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (hi, c)));
+    return uint64_t (low) | uint64_t (high) << 32;
+}
+
+__attribute__ ((target ("avx2"))) inline void
+classifyAvx2 (const char *p, char delimiter, char quote, BlockMasks &out)
+{
+    const __m256i lo
+        = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (p));
+    const __m256i hi
+        = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (p + 32));
+    out.quote = matchAvx2 (lo, hi, _mm256_set1_epi8 (quote));
+    out.delimiter = matchAvx2 (lo, hi, _mm256_set1_epi8 (delimiter));
+    out.newline = matchAvx2 (lo, hi, _mm256_set1_epi8 ('\n'));
+    out.cr = matchAvx2 (lo, hi, _mm256_set1_epi8 ('\r'));
+}
+
+#if defined(__x86_64__)
+
+__attribute__ ((target ("pclmul"))) inline uint64_t
+prefixXorClmul (uint64_t bits)
+{
+    const __m128i all = _mm_set1_epi8 (static_cast<char> (0xFF));
+    const __m128i x = _mm_set_epi64x (0, static_cast<long long> (bits));
+    return static_cast<uint64_t> (
+        _mm_cvtsi128_si64 (_mm_clmulepi64_si128 (x, all, 0)));
+}
+
+inline uint64_t (*prefixXorBest ()) (uint64_t)
+{
+    __builtin_cpu_init ();
+    return __builtin_cpu_supports ("pclmul") ? prefixXorClmul
+                                             : prefixXorShift;
+}
+
+#else
+
+inline uint64_t (*prefixXorBest ()) (uint64_t) { return prefixXorShift; }
+
+#endif
+
+#endif // SIMD_X86
+
+} // namespace detail
+
+// 指定级别的内核; 超出 CPU 支持范围时降级
+inline const Kernels &
+kernels (Level level)
+{
+    static const Kernels scalar{ Level::SCALAR, detail::classifyScalar,
+                                 detail::prefixXorShift };
+#if SIMD_X86
+    static const Kernels sse2{ Level::SSE2, detail::classifySse2,
+                               detail::prefixXorBest () };
+    static const Kernels avx2{ Level::AVX2, detail::classifyAvx2,
+                               sse2.prefixXor };
+    static const Level best = simd::detect ();
+    if (level > best)
+    {
+        level = best;
+    }
+    switch (level)
+    {
+    case Level::AVX2:
+        return avx2;
+    case Level::SSE2:
+        return sse2;
+    default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return scalar;
+}
+
+namespace detail
+{
+
+inline const Kernels *&
+activeSlot ()
+{
+    static const Kernels *active = &kernels (simd::detect ());
+    return active;
+}
+
+} // namespace detail
+
+// CSV 分词默认使用的内核, 首次调用时按 CPU 选择
+inline const Kernels &
+active ()
+{
+    return *detail::activeSlot ();
+}
+
+// 切换默认内核 (性能对比和测试用), 返回实际使用的级别
+// 不能与正在进行的解析并发调用
+inline Level
+setActive (Level level)
+{
+    detail::activeSlot () = &kernels (level);
+    return active ().level;
+}
+
+// 一个块中引号外的结构字符
+//   delimiters    分隔符
+//   terminators   记录结束: '\n', '\r'; "\r\n" 只记 '\r'
+struct Block
+{
+    const char *base;
+    std::size_t size;
+    uint64_t delimiters;
+    uint64_t terminators;
+};
+
+// 从记录开头逐块扫描 [begin, end)
+// 开引号只能出现在字段开头 (或紧跟另一个引号, 即转义的 "");
+// 出现在其它位置时按位图无法得到与标量分词相同的结果, 扫描停止并
+// 置 malformed (), 调用方从当前记录开头改用标量分词
+class StructureScanner
+{
+  private:
+    const char *pos_;
+    const char *end_;
+    const Kernels *kernels_;
+    char delimiter_;
+    char quote_;
+    uint64_t inQuote_ = 0;   // 全 0 或全 1
+    uint64_t prevBreak_ = 1; // 上一块末字节是否为结构字符或引号
+    uint64_t prevCr_ = 0;
+    bool malformed_ = false;
+
+  public:
+    StructureScanner (const char *begin, const char *end, char delimiter,
+                      char quote, const Kernels &kernels = active ())
+        : pos_ (begin), end_ (end), kernels_ (&kernels),
+          delimiter_ (delimiter), quote_ (quote)
+    {
+    }
+
+    bool
+    next (Block &out)
+    {
+        if (pos_ >= end_ || malformed_)
+        {
+            return false;
+        }
+        BlockMasks masks;
+        std::size_t size = static_cast<std::size_t> (end_ - pos_);
+        if (size >= 64)
+        {
+            size = 64;
+            kernels_->classify (pos_, delimiter_, quote_, masks);
+        }
+        else
+        {
+            detail::classifyTail (pos_, size, delimiter_, quote_, masks);
+        }
+
+        const uint64_t inside = kernels_->prefixXor (masks.quote) ^ inQuote_;
+        const uint64_t breaks
+            = masks.delimiter | masks.newline | masks.cr | masks.quote;
+        if ((masks.quote & inside & ~((breaks << 1) | prevBreak_)) != 0)
+        {
+            malformed_ = true;
+            return false;
+        }
+        inQuote_ = uint64_t (0) - (inside >> 63);
+        prevBreak_ = breaks >> 63;
+        const uint64_t crlf = masks.newline & ((masks.cr << 1) | prevCr_);
+        prevCr_ = masks.cr >> 63;
+
+        out.base = pos_;
+        out.size = size;
+        out.delimiters = masks.delimiter & ~inside;
+        out.terminators = (masks.newline | masks.cr) & ~inside & ~crlf;
+        pos_ += size;
+        return true;
+    }
+
+    [[nodiscard]] bool
+    malformed () const
+    {
+        return malformed_;
+    }
+};
+
+} // namespace csvsimd
+
+#endif
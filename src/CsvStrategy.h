@@ -0,0 +1,282 @@
+#ifndef CSVSTRATEGY_H
+#define CSVSTRATEGY_H
+
+#include "CsvColumns.h"
+#include "CsvParser.h"
+#include "Exceptions.h"
+#include "MappedFile.h"
+#include "strategy.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+// CSV 读取: 文件整体只读映射 (或直接使用调用方的内存), 打开时扫描一遍
+// 建立记录起点索引, 之后按行号定位记录并就地分词, 字段是指向数据的
+// string_view
+// CSV 只有一张工作表, 下标只能为 0
+// parallelism > 1 时索引分块并行建立, forEachRowParallel 默认使用同样的
+// 线程数; 结果与单线程相同
+class CSVReadStrategy : public ReadStrategy
+{
+  private:
+    InputBuffer input_;
+    csv::Dialect dialect_;
+    csv::CsvIndex index_;
+    csv::CsvRow row_;
+    std::string name_;
+    std::size_t parallelism_;
+
+    void
+    checkIndex (std::size_t pos) const
+    {
+        if (pos != 0)
+        {
+            throw ExcelReader::IndexOutException (
+                "sheets[" + std::to_string (pos) + "]");
+        }
+    }
+
+    template <typename Out, typename Convert>
+    void
+    readCellsAs (std::size_t pos, Span<const CellPosition> cells,
+                 Span<Out> out, Convert convert)
+    {
+        checkIndex (pos);
+        batch::checkRequest (cells, out);
+        batch::forEachRow (
+            cells,
+            [&] (std::size_t row, const uint32_t *first, const uint32_t *last)
+            {
+                if (row < index_.rowCount ()
+                    && (row_.size () == 0 || row_.index () != row))
+                {
+                    row_.parse (input_.view (), index_, row, dialect_);
+                }
+                const bool exists = row < index_.rowCount ();
+                for (; first != last; ++first)
+                {
+                    out[*first] = convert (exists ? row_[cells[*first].col]
+                                                  : csv::CsvField ());
+                }
+            });
+    }
+
+    CSVReadStrategy (InputBuffer input, std::string name,
+                     const csv::Dialect &dialect, std::size_t parallelism)
+        : input_ (std::move (input)), dialect_ (dialect),
+          name_ (std::move (name)),
+          parallelism_ (std::max<std::size_t> (parallelism, 1))
+    {
+        index_ = csv::indexRecordsParallel (input_.view (), dialect_,
+                                            parallelism_);
+    }
+
+  public:
+    explicit CSVReadStrategy (const fs::path &path,
+                              const csv::Dialect &dialect = {},
+                              std::size_t parallelism = 1)
+        : CSVReadStrategy (InputBuffer (path), path.stem ().string (),
+                           dialect, parallelism)
+    {
+    }
+
+    // 读取内存中的 CSV 文本, data 在本对象析构前必须有效; 工作表名为空
+    explicit CSVReadStrategy (Span<const std::byte> data,
+                              const csv::Dialect &dialect = {},
+                              std::size_t parallelism = 1)
+        : CSVReadStrategy (InputBuffer (data), std::string (), dialect,
+                           parallelism)
+    {
+    }
+
+    ~CSVReadStrategy () override = default;
+
+    CellType
+    readCell (const std::size_t pos, const std::size_t row,
+              const std::size_t col) override
+    {
+        return csv::classify (field (pos, row, col));
+    }
+
+    CellType
+    readCell (const std::size_t pos, const std::string &addr) override
+    {
+        return readCell (pos, CellPosition (addr));
+    }
+
+    CellType
+    readCell (const std::size_t pos, const CellPosition &cpos) override
+    {
+        if (!cpos.valid ())
+        {
+            throw ExcelReader::ParseAddrException ("empty position");
+        }
+        return readCell (pos, cpos.row, cpos.col);
+    }
+
+    // 单个字段, 超出范围时为空字段; 指向映射区, 生命周期同本对象
+    csv::CsvField
+    field (std::size_t pos, std::size_t row, std::size_t col)
+    {
+        checkIndex (pos);
+        if (row >= index_.rowCount ())
+        {
+            return {};
+        }
+        if (row_.size () == 0 || row_.index () != row)
+        {
+            row_.parse (input_.view (), index_, row, dialect_);
+        }
+        return row_[col];
+    }
+
+    // 批量读取字段, 第 i 个位置写入 out[i]; 同一行的请求只分词一次
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<csv::CsvField> out)
+    {
+        readCellsAs (pos, cells, out,
+                     [] (const csv::CsvField &field) { return field; });
+    }
+
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<CellType> out) override
+    {
+        readCellsAs (pos, cells, out,
+                     [] (const csv::CsvField &field)
+                     { return csv::classify (field); });
+    }
+
+    // 读取区域内的全部字段, 行优先的稠密块; 区域内的记录连续分词一遍
+    // 整行 / 整列区域截到记录数和最多的字段数
+    CellBlock<csv::CsvField>
+    readRange (std::size_t pos, const CellRange &range) const
+    {
+        checkIndex (pos);
+        CellBlock<csv::CsvField> block;
+        block.range = range.clamp (index_.rowCount (), index_.columns);
+        block.rows = block.range.rowCount ();
+        block.cols = block.range.colCount ();
+        block.cells.resize (block.rows * block.cols);
+        if (block.cols == 0)
+        {
+            return block;
+        }
+        const std::size_t first = block.range.firstRow;
+        const std::size_t last
+            = std::min (first + block.rows, index_.rowCount ());
+        csv::forEachRecordIn (
+            input_.view (), index_, first, last, dialect_,
+            [&] (const csv::CsvRow &row)
+            {
+                auto *out = block.cells.data ()
+                            + (row.index () - first) * block.cols;
+                const std::size_t end = std::min<std::size_t> (
+                    row.size (), std::size_t (block.range.lastCol) + 1);
+                for (std::size_t c = block.range.firstCol; c < end; ++c)
+                {
+                    out[c - block.range.firstCol] = row[c];
+                }
+            });
+        return block;
+    }
+
+    CellBlock<csv::CsvField>
+    readRange (std::size_t pos, std::string_view range) const
+    {
+        return readRange (pos, parseRange (range));
+    }
+
+    // 按记录顺序调用 fn(const csv::CsvRow&), 行对象在调用之间复用
+    // 整个文件连续分词一遍, 不经过记录索引
+    template <typename Fn>
+    void
+    forEachRow (std::size_t pos, Fn &&fn) const
+    {
+        checkIndex (pos);
+        csv::forEachRecord (input_.view (), dialect_, fn);
+    }
+
+    // 按记录索引分段, 多线程并发分词; fn 会被同时调用, 须自行同步
+    // row.index () 为记录序号, 不保证调用顺序
+    template <typename Fn>
+    void
+    forEachRowParallel (std::size_t pos, Fn &&fn) const
+    {
+        forEachRowParallel (pos, parallelism_, std::forward<Fn> (fn));
+    }
+
+    template <typename Fn>
+    void
+    forEachRowParallel (std::size_t pos, std::size_t threads, Fn &&fn) const
+    {
+        checkIndex (pos);
+        csv::forEachRecordParallel (input_.view (), index_, dialect_, threads,
+                                    fn);
+    }
+
+    // 按列导出, 每列类型由取样的记录确定, 见 CsvColumns.h
+    // skipRows 为跳过的表头行数
+    SheetColumns
+    readColumns (std::size_t pos, std::size_t skipRows = 0) const
+    {
+        checkIndex (pos);
+        return csv::readColumns (input_.view (), index_, dialect_, skipRows);
+    }
+
+    [[nodiscard]] std::size_t
+    rowCount () const
+    {
+        return index_.rowCount ();
+    }
+
+    // 所有记录中最多的字段数
+    [[nodiscard]] std::size_t
+    colCount () const
+    {
+        return index_.columns;
+    }
+
+    [[nodiscard]] std::size_t
+    sheetCount () const
+    {
+        return 1;
+    }
+
+    // 工作表名取文件名 (不含扩展名)
+    std::string
+    getSheetName (std::size_t pos) const
+    {
+        checkIndex (pos);
+        return name_;
+    }
+
+    [[nodiscard]] std::size_t
+    parallelism () const
+    {
+        return parallelism_;
+    }
+
+    const csv::Dialect &
+    dialect () const
+    {
+        return dialect_;
+    }
+
+    // 整个文件内容
+    [[nodiscard]] std::string_view
+    text () const
+    {
+        return input_.view ();
+    }
+};
+
+#endif
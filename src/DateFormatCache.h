@@ -0,0 +1,110 @@
+#ifndef DATEFORMATCACHE_H
+#define DATEFORMATCACHE_H
+
+#include "utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio> // xls.h 会在 namespace xls 内包含 stdio.h, 需先包含
+#include <string_view>
+#include <vector>
+
+extern "C"
+{
+#include "xls.h"
+}
+
+// 工作簿的数字格式表, 打开工作簿时构建一次
+//   formatKinds_ 格式 id -> 种类, 内置格式来自 builtinFormatKind,
+//                工作簿中的 FORMAT 记录按格式字符串分类 (可覆盖内置格式)
+//   xfKinds_     XF 下标 -> 种类, 即 xfs.xf[i].format 对应的种类
+// XLSX 由 styles.xml 通过 setFormat / addXf 构建
+// 单元格只保存 XF 下标, 判断时只需一次数组访问
+class DateFormatCache
+{
+  private:
+    std::vector<NumberKind> formatKinds_;
+    std::vector<NumberKind> xfKinds_;
+
+  public:
+    DateFormatCache ()
+    {
+        formatKinds_.resize (BuiltinFormatCount);
+        for (int id = 0; id < BuiltinFormatCount; ++id)
+        {
+            formatKinds_[id] = builtinFormatKind (id);
+        }
+    }
+
+    explicit DateFormatCache (const xls::xlsWorkBook *wb) : DateFormatCache ()
+    {
+        if (wb == nullptr)
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < wb->formats.count; ++i)
+        {
+            const auto &format = wb->formats.format[i];
+            setFormat (format.index, format.value != nullptr
+                                         ? std::string_view (format.value)
+                                         : std::string_view ());
+        }
+
+        xfKinds_.reserve (wb->xfs.count);
+        for (std::size_t i = 0; i < wb->xfs.count; ++i)
+        {
+            addXf (wb->xfs.xf[i].format);
+        }
+    }
+
+    // 工作簿自定义的格式 (XLS 的 FORMAT 记录, XLSX 的 numFmt),
+    // 须在引用它的 XF 加入之前设置
+    void
+    setFormat (std::size_t formatId, std::string_view code)
+    {
+        if (formatId >= formatKinds_.size ())
+        {
+            formatKinds_.resize (formatId + 1u, NumberKind::NUMBER);
+        }
+        formatKinds_[formatId] = code.empty () ? NumberKind::NUMBER
+                                               : classifyFormatCode (code);
+    }
+
+    // 追加下一个 XF, 其数字格式为 formatId
+    void
+    addXf (std::size_t formatId)
+    {
+        xfKinds_.push_back (formatKind (formatId));
+    }
+
+    [[nodiscard]] NumberKind
+    formatKind (std::size_t formatId) const
+    {
+        return formatId < formatKinds_.size () ? formatKinds_[formatId]
+                                               : NumberKind::NUMBER;
+    }
+
+    [[nodiscard]] bool
+    isDateFormat (std::size_t formatId) const
+    {
+        auto kind = formatKind (formatId);
+        return kind == NumberKind::DATE || kind == NumberKind::TIME;
+    }
+
+    // 按单元格的 XF 下标查种类, 不存在的 XF 视为普通数值
+    [[nodiscard]] NumberKind
+    xfKind (std::size_t xf) const
+    {
+        return xf < xfKinds_.size () ? xfKinds_[xf] : NumberKind::NUMBER;
+    }
+
+    [[nodiscard]] bool
+    isDateXf (std::size_t xf) const
+    {
+        auto kind = xfKind (xf);
+        return kind == NumberKind::DATE || kind == NumberKind::TIME;
+    }
+};
+
+#endif
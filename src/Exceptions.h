@@ -69,4 +69,11 @@ class ParseAddrException : public ExcelException
         : ExcelException ("Parse error: " + msg) {};
 };
 
+class ParseSheetException : public ExcelException
+{
+  public:
+    explicit ParseSheetException (const std::string &msg)
+        : ExcelException ("Parse sheet error: " + msg) {};
+};
+
 } // namespace ExcelReader
@@ -0,0 +1,212 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "Exceptions.h"
+#include "Span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// 只读内存映射文件, 内容直到析构前都有效
+// 空文件不做映射, data () 为 nullptr, size () 为 0
+class MappedFile
+{
+  private:
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+
+    void
+    unmap () noexcept
+    {
+        if (data_ == nullptr)
+        {
+            return;
+        }
+#ifdef _WIN32
+        UnmapViewOfFile (data_);
+#else
+        munmap (const_cast<char *> (data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+  public:
+    MappedFile () = default;
+
+    explicit MappedFile (const fs::path &path)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileW (path.c_str (), GENERIC_READ,
+                                   FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx (file, &size) == 0)
+        {
+            CloseHandle (file);
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+        size_ = static_cast<std::size_t> (size.QuadPart);
+        if (size_ > 0)
+        {
+            HANDLE mapping = CreateFileMappingW (file, nullptr, PAGE_READONLY,
+                                                 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                data_ = static_cast<const char *> (
+                    MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle (mapping);
+            }
+        }
+        CloseHandle (file);
+#else
+        const int fd = ::open (path.c_str (), O_RDONLY);
+        if (fd < 0)
+        {
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+        struct stat st;
+        if (fstat (fd, &st) != 0)
+        {
+            ::close (fd);
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+        size_ = static_cast<std::size_t> (st.st_size);
+        if (size_ > 0)
+        {
+            void *addr = mmap (nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED)
+            {
+                data_ = static_cast<const char *> (addr);
+                // 按顺序扫描为主, 提示内核加大预读
+                madvise (addr, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close (fd);
+#endif
+        if (size_ > 0 && data_ == nullptr)
+        {
+            size_ = 0;
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+    }
+
+    MappedFile (const MappedFile &) = delete;
+    MappedFile &operator= (const MappedFile &) = delete;
+
+    MappedFile (MappedFile &&other) noexcept
+        : data_ (std::exchange (other.data_, nullptr)),
+          size_ (std::exchange (other.size_, 0))
+    {
+    }
+
+    MappedFile &
+    operator= (MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap ();
+            data_ = std::exchange (other.data_, nullptr);
+            size_ = std::exchange (other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile () { unmap (); }
+
+    [[nodiscard]] const char *
+    data () const
+    {
+        return data_;
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] std::string_view
+    view () const
+    {
+        return { data_, size_ };
+    }
+};
+
+// 文件的读取方式
+enum class OpenMode : uint8_t
+{
+    STREAM = 0, // 解析库自己打开文件, 按需 fseek / fread
+    MAPPED      // 整个文件只读映射, 解析库直接读内存
+};
+
+// 待解析的整块数据: 持有的文件映射, 或借用调用方的内存 (如对象存储缓存,
+// 上传内容), 借用时不复制, 调用方须保证数据在使用期间有效
+// 移动后 view () 不变 (映射地址不随对象移动)
+class InputBuffer
+{
+  private:
+    MappedFile file_;
+    std::string_view data_;
+
+  public:
+    InputBuffer () = default;
+
+    explicit InputBuffer (const fs::path &path)
+        : file_ (path), data_ (file_.view ())
+    {
+    }
+
+    explicit InputBuffer (Span<const std::byte> bytes)
+        : data_ (reinterpret_cast<const char *> (bytes.data ()),
+                 bytes.size ())
+    {
+    }
+
+    [[nodiscard]] const char *
+    data () const
+    {
+        return data_.data ();
+    }
+
+    [[nodiscard]] const unsigned char *
+    bytes () const
+    {
+        return reinterpret_cast<const unsigned char *> (data_.data ());
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return data_.size ();
+    }
+
+    [[nodiscard]] std::string_view
+    view () const
+    {
+        return data_;
+    }
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef NUMBERPARSE_H
+#define NUMBERPARSE_H
+
+#include "SimdLevel.h"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+// 文本到数值的转换, 不抛异常, 不分配内存
+// XLSX 的 <v> 值, CSV 字段, XLS 字符串单元格共用
+namespace numparse
+{
+
+// 解析十进制数字串 [p, p + n), n 不超过 19; 含非数字时返回 false
+// 小端 x86 上每次处理 8 位 (SWAR), 其它平台逐位处理
+inline bool
+parseDigits (const char *p, std::size_t n, uint64_t &out)
+{
+    uint64_t value = 0;
+#if SIMD_X86
+    for (; n >= 8; p += 8, n -= 8)
+    {
+        uint64_t chunk;
+        std::memcpy (&chunk, p, 8);
+        // 每个字节都在 '0'..'9' 之间
+        if ((((chunk & 0xF0F0F0F0F0F0F0F0ull)
+              | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull)
+                 >> 4))
+             != 0x3333333333333333ull))
+        {
+            return false;
+        }
+        chunk = ((chunk & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+        chunk = ((chunk & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+        chunk = ((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+        value = value * 100000000ull + chunk;
+    }
+#endif
+    for (; n > 0; ++p, --n)
+    {
+        const auto digit = static_cast<unsigned> (*p - '0');
+        if (digit > 9)
+        {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+// 数值文本转 double, 整个文本须是 from_chars 接受的形式
+// 快速路径: [-]digits[.digits] 且有效数字不超过 15 位时, 整数和小数部分
+// 合成整数 m (< 2^53, 精确), 结果 m / 10^k 是一次正确舍入的除法, 与
+// from_chars 的结果相同; 其它形式 (指数, 更多位数) 交给 from_chars
+inline bool
+parseNumber (std::string_view text, double &out)
+{
+    static constexpr uint64_t Pow10Int[]
+        = { 1ull,           10ull,           100ull,           1000ull,
+            10000ull,       100000ull,       1000000ull,       10000000ull,
+            100000000ull,   1000000000ull,   10000000000ull,   100000000000ull,
+            1000000000000ull, 10000000000000ull, 100000000000000ull,
+            1000000000000000ull };
+    static constexpr double Pow10[]
+        = { 1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+
+    const char *p = text.data ();
+    std::size_t n = text.size ();
+    const bool negative = n > 0 && *p == '-';
+    if (negative)
+    {
+        ++p;
+        --n;
+    }
+    const auto *dot = static_cast<const char *> (std::memchr (p, '.', n));
+    const std::size_t intLen = dot != nullptr ? std::size_t (dot - p) : n;
+    const std::size_t fracLen = dot != nullptr ? n - intLen - 1 : 0;
+    uint64_t intPart = 0;
+    uint64_t fracPart = 0;
+    if (intLen > 0 && intLen + fracLen <= 15
+        && (dot == nullptr || fracLen > 0) && parseDigits (p, intLen, intPart)
+        && (dot == nullptr || parseDigits (dot + 1, fracLen, fracPart)))
+    {
+        const double value
+            = static_cast<double> (intPart * Pow10Int[fracLen] + fracPart)
+              / Pow10[fracLen];
+        out = negative ? -value : value;
+        return true;
+    }
+
+    const char *last = text.data () + text.size ();
+    auto [ptr, ec] = std::from_chars (text.data (), last, out);
+    return ec == std::errc () && ptr == last && !text.empty ();
+}
+
+// 用户输入的数值文本 (CSV 字段, 字符串单元格): 以数字或 '.' 开头
+// (可带 '-'), 不接受 inf, nan 和十六进制
+inline bool
+parseNumericText (std::string_view text, double &out)
+{
+    if (text.empty ())
+    {
+        return false;
+    }
+    const char first = text[text[0] == '-' && text.size () > 1 ? 1 : 0];
+    if ((first < '0' || first > '9') && first != '.')
+    {
+        return false;
+    }
+    return parseNumber (text, out);
+}
+
+inline bool
+equalsIgnoreCase (std::string_view text, std::string_view upper)
+{
+    if (text.size () != upper.size ())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < text.size (); ++i)
+    {
+        char c = text[i];
+        if (c >= 'a' && c <= 'z')
+        {
+            c = static_cast<char> (c - 'a' + 'A');
+        }
+        if (c != upper[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// TRUE / FALSE, 不区分大小写
+inline bool
+parseBoolText (std::string_view text, bool &out)
+{
+    if (equalsIgnoreCase (text, "TRUE"))
+    {
+        out = true;
+        return true;
+    }
+    if (equalsIgnoreCase (text, "FALSE"))
+    {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace numparse
+
+#endif
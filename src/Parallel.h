@@ -0,0 +1,79 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 默认线程数: 硬件并发数, 取不到时为 1
+inline std::size_t
+defaultThreadCount ()
+{
+    return std::max<std::size_t> (1, std::thread::hardware_concurrency ());
+}
+
+// 用 threads 个工作线程执行 fn(0) .. fn(count - 1)
+// 任务按下标动态领取, 调用方线程也参与执行
+// 任一任务抛出异常时, 其余未开始的任务不再执行, 第一个异常在返回前重新抛出
+template <typename Fn>
+void
+parallelFor (std::size_t count, std::size_t threads, Fn &&fn)
+{
+    threads = std::min (std::max<std::size_t> (threads, 1), count);
+    if (threads <= 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            fn (i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    auto worker = [&] ()
+    {
+        for (std::size_t i = next++; i < count && !failed; i = next++)
+        {
+            try
+            {
+                fn (i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard (errorLock);
+                if (!error)
+                {
+                    error = std::current_exception ();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve (threads - 1);
+    for (std::size_t t = 1; t < threads; ++t)
+    {
+        pool.emplace_back (worker);
+    }
+    worker ();
+    for (auto &thread : pool)
+    {
+        thread.join ();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception (error);
+    }
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef ROWVIEW_H
+#define ROWVIEW_H
+
+#include "SparseSheet.h"
+#include "XlsCellView.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// 行内单元格迭代器, 解引用得到 XlsCellView
+class XlsCellIterator
+{
+  private:
+    const xls::xlsCell *pos_ = nullptr;
+    const DateFormatCache *formats_ = nullptr;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = XlsCellView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = XlsCellView;
+
+    XlsCellIterator () = default;
+    explicit XlsCellIterator (const xls::xlsCell *pos,
+                              const DateFormatCache *formats = nullptr)
+        : pos_ (pos), formats_ (formats)
+    {
+    }
+
+    XlsCellView
+    operator* () const
+    {
+        return XlsCellView (pos_, formats_);
+    }
+
+    XlsCellView
+    operator[] (difference_type n) const
+    {
+        return XlsCellView (pos_ + n, formats_);
+    }
+
+    XlsCellIterator &
+    operator++ ()
+    {
+        ++pos_;
+        return *this;
+    }
+
+    XlsCellIterator
+    operator++ (int)
+    {
+        auto tmp = *this;
+        ++pos_;
+        return tmp;
+    }
+
+    XlsCellIterator &
+    operator-- ()
+    {
+        --pos_;
+        return *this;
+    }
+
+    XlsCellIterator
+    operator-- (int)
+    {
+        auto tmp = *this;
+        --pos_;
+        return tmp;
+    }
+
+    XlsCellIterator &
+    operator+= (difference_type n)
+    {
+        pos_ += n;
+        return *this;
+    }
+
+    XlsCellIterator &
+    operator-= (difference_type n)
+    {
+        pos_ -= n;
+        return *this;
+    }
+
+    XlsCellIterator
+    operator+ (difference_type n) const
+    {
+        return XlsCellIterator (pos_ + n, formats_);
+    }
+
+    friend XlsCellIterator
+    operator+ (difference_type n, const XlsCellIterator &it)
+    {
+        return it + n;
+    }
+
+    XlsCellIterator
+    operator- (difference_type n) const
+    {
+        return XlsCellIterator (pos_ - n, formats_);
+    }
+
+    difference_type
+    operator- (const XlsCellIterator &other) const
+    {
+        return pos_ - other.pos_;
+    }
+
+    bool
+    operator== (const XlsCellIterator &other) const
+    {
+        return pos_ == other.pos_;
+    }
+
+    bool
+    operator!= (const XlsCellIterator &other) const
+    {
+        return pos_ != other.pos_;
+    }
+
+    bool
+    operator< (const XlsCellIterator &other) const
+    {
+        return pos_ < other.pos_;
+    }
+
+    bool
+    operator<= (const XlsCellIterator &other) const
+    {
+        return pos_ <= other.pos_;
+    }
+
+    bool
+    operator> (const XlsCellIterator &other) const
+    {
+        return pos_ > other.pos_;
+    }
+
+    bool
+    operator>= (const XlsCellIterator &other) const
+    {
+        return pos_ >= other.pos_;
+    }
+};
+
+// 行视图: 借用 SparseSheet 中的单元格, 不复制也不推断类型
+// 生命周期不能超过所属的 XLSReader
+class XlsRowView
+{
+  private:
+    SparseRow cells_;
+    const DateFormatCache *formats_ = nullptr;
+
+  public:
+    XlsRowView () = default;
+    explicit XlsRowView (SparseRow cells,
+                         const DateFormatCache *formats = nullptr)
+        : cells_ (cells), formats_ (formats)
+    {
+    }
+
+    [[nodiscard]] std::size_t
+    index () const
+    {
+        return cells_.empty () ? 0 : cells_.first->row;
+    }
+
+    [[nodiscard]] XlsCellIterator
+    begin () const
+    {
+        return XlsCellIterator (cells_.begin (), formats_);
+    }
+
+    [[nodiscard]] XlsCellIterator
+    end () const
+    {
+        return XlsCellIterator (cells_.end (), formats_);
+    }
+
+    [[nodiscard]] SparseRow
+    cells () const
+    {
+        return cells_;
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return cells_.size ();
+    }
+
+    [[nodiscard]] bool
+    empty () const
+    {
+        return cells_.empty ();
+    }
+
+    // 按列查找, 不存在时返回无效视图
+    [[nodiscard]] XlsCellView
+    find (std::size_t col) const
+    {
+        const auto *it = std::lower_bound (
+            cells_.begin (), cells_.end (), col,
+            [] (const xls::xlsCell &cell, std::size_t c)
+            { return cell.col < c; });
+        return XlsCellView (
+            (it != cells_.end () && it->col == col) ? it : nullptr, formats_);
+    }
+};
+
+// 按行顺序遍历工作表中所有非空行
+class XlsRowIterator
+{
+  private:
+    const SparseSheet *sheet_ = nullptr;
+    const DateFormatCache *formats_ = nullptr;
+    const xls::xlsCell *pos_ = nullptr;
+    XlsRowView row_;
+
+    void
+    load ()
+    {
+        row_ = pos_ == sheet_->cells ().end ()
+                   ? XlsRowView ()
+                   : XlsRowView (sheet_->row (pos_->row), formats_);
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = XlsRowView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const XlsRowView *;
+    using reference = const XlsRowView &;
+
+    XlsRowIterator () = default;
+    XlsRowIterator (const SparseSheet *sheet, const DateFormatCache *formats,
+                    const xls::xlsCell *pos)
+        : sheet_ (sheet), formats_ (formats), pos_ (pos)
+    {
+        load ();
+    }
+
+    reference
+    operator* () const
+    {
+        return row_;
+    }
+
+    pointer
+    operator->() const
+    {
+        return &row_;
+    }
+
+    XlsRowIterator &
+    operator++ ()
+    {
+        pos_ = row_.cells ().end ();
+        load ();
+        return *this;
+    }
+
+    XlsRowIterator
+    operator++ (int)
+    {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool
+    operator== (const XlsRowIterator &other) const
+    {
+        return pos_ == other.pos_;
+    }
+
+    bool
+    operator!= (const XlsRowIterator &other) const
+    {
+        return pos_ != other.pos_;
+    }
+};
+
+class XlsSheetRows
+{
+  private:
+    const SparseSheet *sheet_;
+    const DateFormatCache *formats_;
+
+  public:
+    // formats 为空时日期按内置格式 id 判断
+    explicit XlsSheetRows (const SparseSheet &sheet,
+                           const DateFormatCache *formats = nullptr)
+        : sheet_ (&sheet), formats_ (formats)
+    {
+    }
+
+    [[nodiscard]] XlsRowIterator
+    begin () const
+    {
+        return { sheet_, formats_, sheet_->cells ().begin () };
+    }
+
+    [[nodiscard]] XlsRowIterator
+    end () const
+    {
+        return { sheet_, formats_, sheet_->cells ().end () };
+    }
+};
+
+// 对每个非空行调用 fn(const XlsRowView &)
+// fn 返回 bool 时, 返回 false 提前结束遍历
+template <typename Fn>
+void
+forEachRow (const SparseSheet &sheet, Fn &&fn,
+            const DateFormatCache *formats = nullptr)
+{
+    for (const auto &row : XlsSheetRows (sheet, formats))
+    {
+        if constexpr (std::is_same_v<
+                          std::invoke_result_t<Fn &, const XlsRowView &>,
+                          bool>)
+        {
+            if (!fn (row))
+            {
+                return;
+            }
+        }
+        else
+        {
+            fn (row);
+        }
+    }
+}
+
+#endif
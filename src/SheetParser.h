@@ -0,0 +1,599 @@
+#ifndef SHEETPARSER_H
+#define SHEETPARSER_H
+
+#include "SparseSheet.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+extern "C"
+{
+#include "xls.h"
+}
+
+// 单元格解析方式
+// 两种方式下 LABELSST 单元格都不复制字符串: str 指向工作簿共享字符串表
+// (SST) 的表项, l 为表中下标, SparseSheet 据此判断 str 是否需要释放
+// (见 SparseSheet::shareString). 这与 libxls 不同: libxls 的 l 是用
+// sscanf 从文本读出的整数, 需要时对 str 自行转换
+// FULL         除 LABELSST 的 l 外与 libxls 相同: 每个单元格都带
+//              xls_getfcell 生成的文本 (数值单元格是 "%lf" 格式的字符串),
+//              字符串单元格的 d (LABEL / RSTRING 还有 l) 是用 sscanf 从
+//              文本读出的值
+// VALUES_ONLY  数值, 数值公式和空白单元格只保存 d, str 为 nullptr;
+//              字符串单元格只保存文本. 本库的 XlsCell / XlsCellView 只从 d
+//              取数值, 需要显示文本时 (asStdString) 才格式化, 结果相同;
+//              省去每个数值单元格一次 malloc + sprintf + free
+enum class ParseMode
+{
+    FULL,
+    VALUES_ONLY
+};
+
+// BIFF 记录解析, 直接写入 SparseSheet, 不经过 libxls 的稠密表
+namespace biff
+{
+
+inline uint16_t
+readU16 (const xls::BYTE *p)
+{
+    return static_cast<uint16_t> (p[0] | (p[1] << 8));
+}
+
+inline uint32_t
+readU32 (const xls::BYTE *p)
+{
+    return static_cast<uint32_t> (p[0]) | (static_cast<uint32_t> (p[1]) << 8)
+           | (static_cast<uint32_t> (p[2]) << 16)
+           | (static_cast<uint32_t> (p[3]) << 24);
+}
+
+inline double
+readF64 (const xls::BYTE *p)
+{
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i)
+    {
+        bits = (bits << 8) | p[i];
+    }
+    double value = 0.0;
+    std::memcpy (&value, &bits, sizeof (value));
+    return value;
+}
+
+// 同 libxls 的 NumFromRk
+inline double
+rkToDouble (uint32_t rk)
+{
+    double value = 0.0;
+    if ((rk & 0x02) != 0)
+    {
+        value = static_cast<double> (static_cast<int32_t> (rk) >> 2);
+    }
+    else
+    {
+        uint64_t bits = static_cast<uint64_t> (rk & 0xfffffffc) << 32;
+        std::memcpy (&value, &bits, sizeof (value));
+    }
+    if ((rk & 0x01) != 0)
+    {
+        value /= 100.0;
+    }
+    return value;
+}
+
+// 同 libxls 的 xls_isCellTooSmall
+inline bool
+cellTooSmall (const xls::xlsWorkBook *wb, uint16_t id, uint16_t size,
+              const xls::BYTE *buf)
+{
+    constexpr uint16_t ColSize = 6;
+    if (size < ColSize)
+    {
+        return true;
+    }
+
+    switch (id)
+    {
+    case XLS_RECORD_FORMULA:
+    case XLS_RECORD_FORMULA_ALT:
+        return size < sizeof (xls::FORMULA);
+    case XLS_RECORD_LABELSST:
+        return size < ColSize + (wb->is5ver ? 2 : 4);
+    case XLS_RECORD_LABEL:
+    case XLS_RECORD_RSTRING:
+    {
+        if (size < ColSize + 2)
+        {
+            return true;
+        }
+        std::size_t len = readU16 (buf + ColSize);
+        if (wb->is5ver)
+        {
+            return size < ColSize + 2 + len;
+        }
+        if (size < ColSize + 3)
+        {
+            return true;
+        }
+        std::size_t width = (buf[ColSize + 2] & 0x01) != 0 ? 2 : 1;
+        return size < ColSize + 3 + width * len;
+    }
+    case XLS_RECORD_RK:
+        return size < sizeof (xls::RK);
+    case XLS_RECORD_NUMBER:
+        return size < sizeof (xls::BR_NUMBER);
+    case XLS_RECORD_BOOLERR:
+        return size < sizeof (xls::BOOLERR);
+    default:
+        return false;
+    }
+}
+
+inline void
+setStr (xls::xlsCell &cell, char *str)
+{
+    std::free (cell.str);
+    cell.str = str;
+}
+
+// xlstool.h 中以 C 的 struct st_cell_data 声明, 在 C++ 中与 xlsCell 不是同一类型
+// xls_getfcell 只读取 label
+inline char *
+formatCell (xls::xlsWorkBook *wb, xls::xlsCell &cell, const xls::BYTE *label)
+{
+    return xls::xls_getfcell (wb,
+                              reinterpret_cast<xls::st_cell_data *> (&cell),
+                              const_cast<xls::BYTE *> (label));
+}
+
+// 解码一个单元格记录, FULL 模式下除 LABELSST 的 l (共享字符串下标) 外
+// 语义与 libxls 的 xls_addCell 保持一致
+// 返回最后写入的单元格下标; 解析失败, 或 MULRK / MULBLANK 不含单元格时
+// 返回 -1
+inline long
+addCell (xls::xlsWorkBook *wb, SparseSheet &sheet, uint16_t id,
+         uint16_t size, const xls::BYTE *buf,
+         ParseMode mode = ParseMode::FULL)
+{
+    if (cellTooSmall (wb, id, size, buf))
+    {
+        return -1;
+    }
+    const bool display = mode == ParseMode::FULL;
+
+    const uint16_t row = readU16 (buf);
+    const uint16_t col = readU16 (buf + 2);
+    const uint16_t xf = readU16 (buf + 4);
+
+    switch (id)
+    {
+    case XLS_RECORD_MULRK:
+    {
+        long last = -1;
+        for (int i = 0; i < (size - 6) / 6; ++i)
+        {
+            const xls::BYTE *rk = buf + 4 + i * 6;
+            const auto index
+                = sheet.append (row, static_cast<uint16_t> (col + i),
+                                XLS_RECORD_RK, readU16 (rk));
+            auto &cell = sheet.at (index);
+            cell.d = rkToDouble (readU32 (rk + 2));
+            if (display)
+            {
+                setStr (cell, formatCell (wb, cell, nullptr));
+            }
+            last = static_cast<long> (index);
+        }
+        return last;
+    }
+    case XLS_RECORD_MULBLANK:
+    {
+        long last = -1;
+        for (int i = 0; i < (size - 6) / 2; ++i)
+        {
+            const auto index
+                = sheet.append (row, static_cast<uint16_t> (col + i),
+                                XLS_RECORD_BLANK, readU16 (buf + 4 + i * 2));
+            if (display)
+            {
+                auto &cell = sheet.at (index);
+                setStr (cell, formatCell (wb, cell, nullptr));
+            }
+            last = static_cast<long> (index);
+        }
+        return last;
+    }
+    default:
+        break;
+    }
+
+    auto index = sheet.append (row, col, id, xf);
+    auto &cell = sheet.at (index);
+
+    switch (id)
+    {
+    case XLS_RECORD_FORMULA:
+    case XLS_RECORD_FORMULA_ALT:
+    {
+        // FORMULA: row col xf | result(8) | flags ...
+        const xls::BYTE *result = buf + 6;
+        cell.id = XLS_RECORD_FORMULA;
+        if (readU16 (result + 6) != 0xffff)
+        {
+            cell.l = 0;
+            cell.d = readF64 (result);
+            if (display)
+            {
+                cell.id = XLS_RECORD_NUMBER;
+                setStr (cell, formatCell (wb, cell, nullptr));
+            }
+            cell.id = id;
+        }
+        else
+        {
+            cell.l = 0xFFFF;
+            switch (result[0])
+            {
+            case 0: // 字符串, 值在随后的 STRING 记录中
+                break;
+            case 1:
+                cell.d = result[2];
+                setStr (cell, strdup ("bool"));
+                break;
+            case 2:
+                cell.d = result[2];
+                setStr (cell, strdup ("error"));
+                break;
+            case 3:
+                setStr (cell, strdup (""));
+                break;
+            default:
+                break;
+            }
+        }
+        break;
+    }
+    case XLS_RECORD_LABELSST:
+        // 引用共享字符串表, 不像 xls_getfcell 那样复制一份
+        sheet.shareString (index, wb->is5ver ? readU16 (buf + 6)
+                                             : readU32 (buf + 6));
+        if (display && cell.str != nullptr)
+        {
+            std::sscanf (cell.str, "%lf", &cell.d);
+        }
+        break;
+    case XLS_RECORD_LABEL:
+    case XLS_RECORD_RSTRING:
+        setStr (cell, formatCell (wb, cell, buf + 6));
+        if (display && cell.str != nullptr)
+        {
+            std::sscanf (cell.str, "%d", &cell.l);
+            std::sscanf (cell.str, "%lf", &cell.d);
+        }
+        break;
+    case XLS_RECORD_RK:
+        cell.d = rkToDouble (readU32 (buf + 6));
+        if (display)
+        {
+            setStr (cell, formatCell (wb, cell, nullptr));
+        }
+        break;
+    case XLS_RECORD_BLANK:
+        break;
+    case XLS_RECORD_NUMBER:
+        cell.d = readF64 (buf + 6);
+        if (display)
+        {
+            setStr (cell, formatCell (wb, cell, nullptr));
+        }
+        break;
+    case XLS_RECORD_BOOLERR:
+        cell.d = buf[6];
+        setStr (cell, strdup (buf[7] != 0 ? "error" : "bool"));
+        break;
+    default:
+        setStr (cell, formatCell (wb, cell, nullptr));
+        break;
+    }
+    return static_cast<long> (index);
+}
+
+// DIMENSIONS 记录 (0x0200): 工作表的已用区域, 上界不含
+constexpr uint16_t DimensionsRecord = 0x0200;
+
+struct Dimensions
+{
+    uint32_t firstRow = 0;
+    uint32_t lastRow = 0;
+    uint16_t firstCol = 0;
+    uint16_t lastCol = 0;
+
+    [[nodiscard]] std::size_t
+    cellCount () const
+    {
+        return std::size_t (lastRow - firstRow) * (lastCol - firstCol);
+    }
+};
+
+// BIFF8 的行号为 32 位, BIFF5 为 16 位
+// 记录过短, 区域颠倒或超出 65536 行 / 256 列时返回 false
+inline bool
+readDimensions (const xls::xlsWorkBook *wb, uint16_t size,
+                const xls::BYTE *buf, Dimensions &out)
+{
+    Dimensions dims;
+    if (wb->is5ver)
+    {
+        if (size < 8)
+        {
+            return false;
+        }
+        dims.firstRow = readU16 (buf);
+        dims.lastRow = readU16 (buf + 2);
+        dims.firstCol = readU16 (buf + 4);
+        dims.lastCol = readU16 (buf + 6);
+    }
+    else
+    {
+        if (size < 12)
+        {
+            return false;
+        }
+        dims.firstRow = readU32 (buf);
+        dims.lastRow = readU32 (buf + 4);
+        dims.firstCol = readU16 (buf + 8);
+        dims.lastCol = readU16 (buf + 10);
+    }
+    if (dims.firstRow > dims.lastRow || dims.lastRow > 65536
+        || dims.firstCol > dims.lastCol || dims.lastCol > 256)
+    {
+        return false;
+    }
+    out = dims;
+    return true;
+}
+
+// 逐条解码工作表记录到稀疏存储, 记录可以来自内存, 也可以直接来自 OLE 流
+// DIMENSIONS 有效时按其区域一次预留单元格, 但不超过 maxCells (剩余记录流
+// 最多能容纳的单元格数, MULBLANK 每格 2 字节), 因此错误的 DIMENSIONS
+// 只影响预留量, 不影响结果; 没有或无效时存储按需增长
+// LABEL / STRING 记录的文本转换会用到 wb 中惰性创建的 iconv 句柄,
+// 多线程解码时需要传入 textLock 串行化; 单元格文本的取舍见 ParseMode
+class SheetDecoder
+{
+  private:
+    xls::xlsWorkBook *wb_;
+    SparseSheet &out_;
+    std::size_t maxCells_;
+    std::mutex *textLock_;
+    ParseMode mode_;
+    long lastCell_ = -1;
+
+    std::unique_lock<std::mutex>
+    lockText () const
+    {
+        return textLock_ != nullptr ? std::unique_lock<std::mutex> (*textLock_)
+                                    : std::unique_lock<std::mutex> ();
+    }
+
+  public:
+    SheetDecoder (xls::xlsWorkBook *wb, SparseSheet &out,
+                  std::size_t maxCells, std::mutex *textLock = nullptr,
+                  ParseMode mode = ParseMode::FULL)
+        : wb_ (wb), out_ (out), maxCells_ (maxCells), textLock_ (textLock),
+          mode_ (mode)
+    {
+        out_.clear ();
+        out_.setSharedStrings (&wb_->sst);
+    }
+
+    // 解码一条记录; 单元格记录不完整时返回 false
+    bool
+    record (uint16_t id, uint16_t size, const xls::BYTE *buf)
+    {
+        switch (id)
+        {
+        case DimensionsRecord:
+        {
+            Dimensions dims;
+            if (readDimensions (wb_, size, buf, dims))
+            {
+                out_.reserve (std::min (dims.cellCount (), maxCells_));
+            }
+            return true;
+        }
+
+        case XLS_RECORD_LABEL:
+        case XLS_RECORD_RSTRING:
+        {
+            auto guard = lockText ();
+            lastCell_ = addCell (wb_, out_, id, size, buf, mode_);
+            return lastCell_ >= 0;
+        }
+
+        case XLS_RECORD_MULRK:
+        case XLS_RECORD_MULBLANK:
+            // 与 libxls 相同, 不含单元格的记录不算错误; 之后的 STRING
+            // 记录没有所属的公式单元格
+            lastCell_ = addCell (wb_, out_, id, size, buf, mode_);
+            return lastCell_ >= 0 || !cellTooSmall (wb_, id, size, buf);
+
+        case XLS_RECORD_NUMBER:
+        case XLS_RECORD_BOOLERR:
+        case XLS_RECORD_RK:
+        case XLS_RECORD_LABELSST:
+        case XLS_RECORD_BLANK:
+        case XLS_RECORD_FORMULA:
+        case XLS_RECORD_FORMULA_ALT:
+            lastCell_ = addCell (wb_, out_, id, size, buf, mode_);
+            return lastCell_ >= 0;
+
+        case XLS_RECORD_STRING:
+            if (lastCell_ >= 0)
+            {
+                auto &cell = out_.at (static_cast<std::size_t> (lastCell_));
+                if (cell.id == XLS_RECORD_FORMULA
+                    || cell.id == XLS_RECORD_FORMULA_ALT)
+                {
+                    auto guard = lockText ();
+                    setStr (cell, xls::get_string (
+                                      reinterpret_cast<const char *> (buf),
+                                      size,
+                                      static_cast<xls::BYTE> (!wb_->is5ver),
+                                      wb_));
+                }
+            }
+            return true;
+
+        default:
+            return true;
+        }
+    }
+
+    void
+    finish ()
+    {
+        out_.finalize ();
+    }
+};
+
+} // namespace biff
+
+// 读取工作表的 BIFF 记录流 (从 BOF 到 EOF) 到内存
+// 会移动 wb->olestr 的读取位置, 不能与同一工作簿上的其它读取并发
+// 读取与解码分开, 供 parseAllSheets 串行读取后并行解码
+inline xls::xls_error_t
+readSheetStream (xls::xlsWorkSheet *ws, std::vector<xls::BYTE> &out)
+{
+    if (ws == nullptr || ws->workbook == nullptr)
+    {
+        return xls::LIBXLS_ERROR_NULL_ARGUMENT;
+    }
+
+    auto *stream = ws->workbook->olestr;
+    out.clear ();
+
+    if (xls::ole2_seek (stream, ws->filepos) == -1)
+    {
+        return xls::LIBXLS_ERROR_SEEK;
+    }
+
+    uint16_t id = 0;
+    do
+    {
+        const std::size_t offset = out.size ();
+        out.resize (offset + 4);
+        if (xls::ole2_read (out.data () + offset, 1, 4, stream) != 4)
+        {
+            return xls::LIBXLS_ERROR_READ;
+        }
+        id = biff::readU16 (out.data () + offset);
+        const uint16_t size = biff::readU16 (out.data () + offset + 2);
+
+        out.resize (offset + 4 + size);
+        if (size != 0
+            && xls::ole2_read (out.data () + offset + 4, 1, size, stream)
+                   != size)
+        {
+            return xls::LIBXLS_ERROR_READ;
+        }
+    }
+    while (stream->eof == 0 && id != XLS_RECORD_EOF);
+
+    return xls::LIBXLS_OK;
+}
+
+// 解码内存中的记录流到稀疏存储, 见 biff::SheetDecoder
+// 只读取 wb 的 SST / XF 等全局表
+inline xls::xls_error_t
+decodeSheetStream (xls::xlsWorkBook *wb, const std::vector<xls::BYTE> &data,
+                   SparseSheet &out, std::mutex *textLock = nullptr,
+                   ParseMode mode = ParseMode::FULL)
+{
+    biff::SheetDecoder decoder (wb, out, data.size () / 2, textLock, mode);
+
+    std::size_t offset = 0;
+    while (offset + 4 <= data.size ())
+    {
+        const uint16_t id = biff::readU16 (data.data () + offset);
+        const uint16_t size = biff::readU16 (data.data () + offset + 2);
+        if (offset + 4 + size > data.size ())
+        {
+            return xls::LIBXLS_ERROR_PARSE;
+        }
+        if (!decoder.record (id, size, data.data () + offset + 4))
+        {
+            return xls::LIBXLS_ERROR_PARSE;
+        }
+        offset += 4u + size;
+    }
+
+    decoder.finish ();
+    return xls::LIBXLS_OK;
+}
+
+// 单遍解析工作表到稀疏存储, 替代 xls_parseWorkSheet
+// xls_parseWorkSheet 先由 xls_preparseWorkSheet 读一遍记录流求出
+// lastrow / lastcol, 再回到开头经 ole2_read 读第二遍; 这里每条记录读出后
+// 立即解码, 记录流只读一遍, 也不缓存整个流; 容量取自 DIMENSIONS
+// 只分配实际存在的单元格; 不处理 MERGEDCELLS / COLINFO 等显示属性
+inline xls::xls_error_t
+parseSparseSheet (xls::xlsWorkSheet *ws, SparseSheet &out,
+                  ParseMode mode = ParseMode::FULL)
+{
+    if (ws == nullptr || ws->workbook == nullptr)
+    {
+        return xls::LIBXLS_ERROR_NULL_ARGUMENT;
+    }
+
+    auto *stream = ws->workbook->olestr;
+    if (xls::ole2_seek (stream, ws->filepos) == -1)
+    {
+        return xls::LIBXLS_ERROR_SEEK;
+    }
+
+    const std::size_t remaining
+        = stream->size > ws->filepos ? stream->size - ws->filepos : 0;
+    biff::SheetDecoder decoder (ws->workbook, out, remaining / 2, nullptr,
+                                mode);
+
+    // 记录体缓冲区, 按出现过的最大记录复用
+    std::vector<xls::BYTE> body;
+    xls::BYTE header[4];
+    uint16_t id = 0;
+    do
+    {
+        if (xls::ole2_read (header, 1, 4, stream) != 4)
+        {
+            return xls::LIBXLS_ERROR_READ;
+        }
+        id = biff::readU16 (header);
+        const uint16_t size = biff::readU16 (header + 2);
+
+        if (size > body.size ())
+        {
+            body.resize (size);
+        }
+        if (size != 0
+            && xls::ole2_read (body.data (), 1, size, stream) != size)
+        {
+            return xls::LIBXLS_ERROR_READ;
+        }
+        if (!decoder.record (id, size, body.data ()))
+        {
+            return xls::LIBXLS_ERROR_PARSE;
+        }
+    }
+    while (stream->eof == 0 && id != XLS_RECORD_EOF);
+
+    decoder.finish ();
+    return xls::LIBXLS_OK;
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SIMDLEVEL_H
+#define SIMDLEVEL_H
+
+#include <cstdint>
+
+// 向量化扫描共用的指令集级别和 CPU 检测 (XmlSimd.h, CsvSimd.h)
+// 只在 GCC / Clang 的 x86 目标上编译向量版本 (使用 target 属性,
+// 不需要全局的 -mavx2), 其它平台只有标量版本
+#if (defined(__GNUC__) || defined(__clang__))                                  \
+    && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+namespace simd
+{
+
+enum class Level : uint8_t
+{
+    SCALAR = 0,
+    SSE2,
+    AVX2
+};
+
+inline const char *
+levelName (Level level)
+{
+    switch (level)
+    {
+    case Level::SSE2:
+        return "sse2";
+    case Level::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+// 当前 CPU 支持的最高级别
+inline Level
+detect ()
+{
+#if SIMD_X86
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2"))
+    {
+        return Level::AVX2;
+    }
+    if (__builtin_cpu_supports ("sse2"))
+    {
+        return Level::SSE2;
+    }
+#endif
+    return Level::SCALAR;
+}
+
+inline unsigned
+lowestBit (uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned> (__builtin_ctzll (bits));
+#else
+    unsigned n = 0;
+    for (; (bits & 1u) == 0; bits >>= 1)
+    {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// 没有 -mpopcnt 时 __builtin_popcountll 会变成 libgcc 的查表调用,
+// 这里用位运算代替
+inline unsigned
+popCount (uint64_t bits)
+{
+#if defined(__POPCNT__) || (defined(__GNUC__) && defined(__aarch64__))
+    return static_cast<unsigned> (__builtin_popcountll (bits));
+#else
+    bits -= (bits >> 1) & 0x5555555555555555ull;
+    bits = (bits & 0x3333333333333333ull)
+           + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned> ((bits * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+} // namespace simd
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// 连续内存的视图 (指针 + 长度), C++20 std::span 的最小子集
+// 不拥有内存; Span<const T> 可以由 vector<T> / array / C 数组隐式构造
+template <typename T>
+class Span
+{
+  private:
+    T *data_ = nullptr;
+    std::size_t size_ = 0;
+
+  public:
+    constexpr Span () = default;
+
+    constexpr Span (T *data, std::size_t size) : data_ (data), size_ (size)
+    {
+    }
+
+    template <std::size_t N>
+    constexpr Span (T (&array)[N]) : data_ (array), size_ (N)
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<
+                              std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span (std::vector<U> &vec) : data_ (vec.data ()), size_ (vec.size ())
+    {
+    }
+
+    template <typename U, typename = std::enable_if_t<
+                              std::is_convertible_v<const U (*)[], T (*)[]>>>
+    Span (const std::vector<U> &vec)
+        : data_ (vec.data ()), size_ (vec.size ())
+    {
+    }
+
+    template <typename U, std::size_t N,
+              typename = std::enable_if_t<
+                  std::is_convertible_v<U (*)[], T (*)[]>>>
+    constexpr Span (std::array<U, N> &array)
+        : data_ (array.data ()), size_ (N)
+    {
+    }
+
+    template <typename U, std::size_t N,
+              typename = std::enable_if_t<
+                  std::is_convertible_v<const U (*)[], T (*)[]>>>
+    constexpr Span (const std::array<U, N> &array)
+        : data_ (array.data ()), size_ (N)
+    {
+    }
+
+    [[nodiscard]] constexpr T *
+    data () const
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr std::size_t
+    size () const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr bool
+    empty () const
+    {
+        return size_ == 0;
+    }
+
+    constexpr T &
+    operator[] (std::size_t i) const
+    {
+        return data_[i];
+    }
+
+    [[nodiscard]] constexpr T *
+    begin () const
+    {
+        return data_;
+    }
+
+    [[nodiscard]] constexpr T *
+    end () const
+    {
+        return data_ + size_;
+    }
+};
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef SPARSESHEET_H
+#define SPARSESHEET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio> // xls.h 会在 namespace xls 内包含 stdio.h, 需先包含
+#include <cstdlib>
+#include <vector>
+
+extern "C"
+{
+#include "xls.h"
+}
+
+// 一行中实际存在的单元格, 按列升序
+struct SparseRow
+{
+    const xls::xlsCell *first = nullptr;
+    const xls::xlsCell *last = nullptr;
+
+    [[nodiscard]] const xls::xlsCell *
+    begin () const
+    {
+        return first;
+    }
+
+    [[nodiscard]] const xls::xlsCell *
+    end () const
+    {
+        return last;
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return static_cast<std::size_t> (last - first);
+    }
+
+    [[nodiscard]] bool
+    empty () const
+    {
+        return first == last;
+    }
+};
+
+// 稀疏单元格存储
+// libxls 的 xls_makeTable 会按 (lastrow+1)*(lastcol+1) 分配整张表,
+// 这里只保存实际出现过的单元格:
+//   cells_      所有单元格, 按 (row, col) 排序, 连续存放
+//   rowOffsets_ 第 r 行位于 [rowOffsets_[r], rowOffsets_[r+1])
+// 行查找 O(1); 行内若列连续则直接下标访问, 否则二分查找
+// 单元格的 str 归本对象所有 (free 释放), 引用共享字符串表的 LABELSST
+// 单元格除外, 见 shareString
+class SparseSheet
+{
+  private:
+    std::vector<xls::xlsCell> cells_;
+    std::vector<uint32_t> rowOffsets_;
+    const xls::st_sst *sharedStrings_ = nullptr;
+    uint16_t lastRow_ = 0;
+    uint16_t lastCol_ = 0;
+    bool ordered_ = true;
+    bool finalized_ = false;
+
+    static bool
+    cellLess (const xls::xlsCell &lhs, const xls::xlsCell &rhs)
+    {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.col < rhs.col;
+    }
+
+    void
+    freeStr (xls::xlsCell &cell) const
+    {
+        if (!sharesString (cell))
+        {
+            std::free (cell.str);
+        }
+        cell.str = nullptr;
+    }
+
+    void
+    release ()
+    {
+        for (auto &cell : cells_)
+        {
+            freeStr (cell);
+        }
+        std::vector<xls::xlsCell> ().swap (cells_);
+        std::vector<uint32_t> ().swap (rowOffsets_);
+    }
+
+  public:
+    SparseSheet () = default;
+    SparseSheet (const SparseSheet &) = delete;
+    SparseSheet &operator= (const SparseSheet &) = delete;
+
+    SparseSheet (SparseSheet &&other) noexcept
+        : cells_ (std::move (other.cells_)),
+          rowOffsets_ (std::move (other.rowOffsets_)),
+          sharedStrings_ (other.sharedStrings_), lastRow_ (other.lastRow_),
+          lastCol_ (other.lastCol_), ordered_ (other.ordered_),
+          finalized_ (other.finalized_)
+    {
+        other.cells_.clear ();
+        other.rowOffsets_.clear ();
+    }
+
+    SparseSheet &
+    operator= (SparseSheet &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release ();
+            cells_ = std::move (other.cells_);
+            rowOffsets_ = std::move (other.rowOffsets_);
+            sharedStrings_ = other.sharedStrings_;
+            lastRow_ = other.lastRow_;
+            lastCol_ = other.lastCol_;
+            ordered_ = other.ordered_;
+            finalized_ = other.finalized_;
+            other.cells_.clear ();
+            other.rowOffsets_.clear ();
+        }
+        return *this;
+    }
+
+    ~SparseSheet () { release (); }
+
+    void
+    clear ()
+    {
+        release ();
+        sharedStrings_ = nullptr;
+        lastRow_ = 0;
+        lastCol_ = 0;
+        ordered_ = true;
+        finalized_ = false;
+    }
+
+    // 预留单元格容量, 如按 DIMENSIONS 记录的区域; 不改变内容
+    void
+    reserve (std::size_t cells)
+    {
+        cells_.reserve (cells);
+    }
+
+    // 追加一个单元格, 返回其在 cells_ 中的下标
+    // str 的所有权转移给 SparseSheet (使用 free 释放)
+    std::size_t
+    append (uint16_t row, uint16_t col, uint16_t id, uint16_t xf)
+    {
+        xls::xlsCell cell{};
+        cell.id = id;
+        cell.row = row;
+        cell.col = col;
+        cell.xf = xf;
+
+        if (!cells_.empty () && ordered_ && !cellLess (cells_.back (), cell))
+        {
+            ordered_ = false;
+        }
+        lastRow_ = std::max (lastRow_, row);
+        lastCol_ = std::max (lastCol_, col);
+        finalized_ = false;
+
+        cells_.push_back (cell);
+        return cells_.size () - 1;
+    }
+
+    [[nodiscard]] xls::xlsCell &
+    at (std::size_t index)
+    {
+        return cells_[index];
+    }
+
+    // 工作簿的共享字符串表 (SST), 须在添加单元格前设置, 且比本对象
+    // 存活更久 (XLSReadStrategy 中工作簿在工作表之后析构)
+    void
+    setSharedStrings (const xls::st_sst *sst)
+    {
+        sharedStrings_ = sst;
+    }
+
+    [[nodiscard]] const xls::st_sst *
+    sharedStrings () const
+    {
+        return sharedStrings_;
+    }
+
+    // 单元格的 str 是否借用共享字符串表第 l 项 (不归本对象所有)
+    [[nodiscard]] bool
+    sharesString (const xls::xlsCell &cell) const
+    {
+        return cell.id == XLS_RECORD_LABELSST && sharedStrings_ != nullptr
+               && cell.l >= 0
+               && static_cast<uint32_t> (cell.l) < sharedStrings_->count
+               && cell.str == sharedStrings_->string[cell.l].str;
+    }
+
+    // 第 index 个单元格引用共享字符串 sstIndex: l 为下标, str 指向表项,
+    // 不复制字符串. 下标越界或没有设置表时 str 为 nullptr, l 为 -1
+    void
+    shareString (std::size_t index, uint32_t sstIndex)
+    {
+        auto &cell = cells_[index];
+        freeStr (cell);
+        if (sharedStrings_ != nullptr && sstIndex < sharedStrings_->count
+            && sstIndex <= INT32_MAX)
+        {
+            cell.l = static_cast<int32_t> (sstIndex);
+            cell.str = sharedStrings_->string[sstIndex].str;
+        }
+        else
+        {
+            cell.l = -1;
+        }
+    }
+
+    // 排序, 去重 (同一位置以后出现的记录为准), 建立行索引
+    void
+    finalize ()
+    {
+        if (!ordered_)
+        {
+            std::stable_sort (cells_.begin (), cells_.end (), cellLess);
+        }
+
+        auto out = cells_.begin ();
+        for (auto it = cells_.begin (); it != cells_.end (); ++it)
+        {
+            auto next = it + 1;
+            if (next != cells_.end () && !cellLess (*it, *next))
+            {
+                freeStr (*it);
+                continue;
+            }
+            *out++ = *it;
+        }
+        cells_.erase (out, cells_.end ());
+        cells_.shrink_to_fit ();
+
+        rowOffsets_.assign (cells_.empty () ? 1 : lastRow_ + 2u, 0);
+        for (const auto &cell : cells_)
+        {
+            ++rowOffsets_[cell.row + 1u];
+        }
+        for (std::size_t r = 1; r < rowOffsets_.size (); ++r)
+        {
+            rowOffsets_[r] += rowOffsets_[r - 1];
+        }
+
+        ordered_ = true;
+        finalized_ = true;
+    }
+
+    [[nodiscard]] bool
+    finalized () const
+    {
+        return finalized_;
+    }
+
+    [[nodiscard]] SparseRow
+    row (std::size_t r) const
+    {
+        if (r + 1 >= rowOffsets_.size ())
+        {
+            return {};
+        }
+        return { cells_.data () + rowOffsets_[r],
+                 cells_.data () + rowOffsets_[r + 1] };
+    }
+
+    // 全部单元格, 按 (row, col) 排序
+    [[nodiscard]] SparseRow
+    cells () const
+    {
+        return { cells_.data (), cells_.data () + cells_.size () };
+    }
+
+    [[nodiscard]] const xls::xlsCell *
+    find (std::size_t r, std::size_t c) const
+    {
+        auto cells = row (r);
+        if (cells.empty () || c < cells.first->col
+            || c > (cells.last - 1)->col)
+        {
+            return nullptr;
+        }
+
+        // 列连续的行直接按偏移访问
+        std::size_t span = (cells.last - 1)->col - cells.first->col + 1u;
+        if (span == cells.size ())
+        {
+            return cells.first + (c - cells.first->col);
+        }
+
+        const auto *it = std::lower_bound (
+            cells.first, cells.last, c,
+            [] (const xls::xlsCell &cell, std::size_t col)
+            { return cell.col < col; });
+        return (it != cells.last && it->col == c) ? it : nullptr;
+    }
+
+    [[nodiscard]] std::size_t
+    rowCount () const
+    {
+        return cells_.empty () ? 0 : lastRow_ + 1u;
+    }
+
+    [[nodiscard]] std::size_t
+    colCount () const
+    {
+        return cells_.empty () ? 0 : lastCol_ + 1u;
+    }
+
+    [[nodiscard]] std::size_t
+    cellCount () const
+    {
+        return cells_.size ();
+    }
+
+    // 不含单元格字符串的内存占用 (字节)
+    [[nodiscard]] std::size_t
+    memoryUsage () const
+    {
+        return cells_.capacity () * sizeof (xls::xlsCell)
+               + rowOffsets_.capacity () * sizeof (uint32_t);
+    }
+};
+
+#endif
@@ -1,19 +1,22 @@
 #pragma once
 
 #include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <iomanip>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <optional>
-#include <sstream>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <variant>
 
+#include "DateFormatCache.h"
+#include "NumberParse.h"
 #include "utils.h"
 
 enum class CellType : uint8_t
@@ -26,121 +29,241 @@ enum class CellType : uint8_t
     DATE
 };
 
+// 按文本内容推断类型: 空为 BLANK, TRUE / FALSE 为 BOOL, 数值为 NUMBER,
+// 其余为 STRING (与 Excel 打开 CSV 时的判断一致, 不识别日期); 不抛异常
+inline CellType
+inferTextType (std::string_view text)
+{
+    if (text.empty ())
+    {
+        return CellType::BLANK;
+    }
+    bool flag;
+    if (numparse::parseBoolText (text, flag))
+    {
+        return CellType::BOOL;
+    }
+    double number;
+    return numparse::parseNumericText (text, number) ? CellType::NUMBER
+                                                     : CellType::STRING;
+}
+
+// 字符串单元格去掉首尾空格和制表符后的文本
+inline std::string_view
+trimLabel (std::string_view text)
+{
+    const auto first = text.find_first_not_of (" \t");
+    return first == std::string_view::npos
+               ? std::string_view ()
+               : text.substr (first, text.find_last_not_of (" \t") - first + 1);
+}
+
+// 字符串单元格 (XLS 的 LABEL / LABELSST, XLSX 的 t="s" / 内联字符串) 的
+// 类型: 只含空白字符为 BLANK, 否则按 trimLabel 后的文本推断
+inline CellType
+inferLabelType (std::string_view text)
+{
+    for (char c : text)
+    {
+        if (std::isspace (static_cast<unsigned char> (c)) == 0)
+        {
+            return inferTextType (trimLabel (text));
+        }
+    }
+    return CellType::BLANK;
+}
+
+// 字符串单元格表示的数值, TRUE 为 1, 其它文本为 0
+inline double
+labelValue (std::string_view text)
+{
+    text = trimLabel (text);
+    double value = 0.0;
+    if (numparse::parseNumericText (text, value))
+    {
+        return value;
+    }
+    bool flag = false;
+    return numparse::parseBoolText (text, flag) && flag ? 1.0 : 0.0;
+}
+
+// 单元格位置, 行列从 0 开始, 共 8 字节
+// A1 形式的地址只在调用 addr () 时计算, 构造时不分配内存
 struct CellPosition
 {
   public:
-    std::optional<std::size_t> row;
-    std::optional<std::size_t> col;
-    std::optional<std::string> addr; // Like A1
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max ();
+    // 列名最多 7 个字母, 行号最多 10 位
+    static constexpr std::size_t MaxAddrLength = 17;
+
+    uint32_t row = npos;
+    uint32_t col = npos;
 
-    explicit CellPosition (std::nullopt_t /*unused*/)
-        : row (std::nullopt), col (std::nullopt), addr (std::nullopt) {};
+    constexpr CellPosition () = default;
 
-    explicit CellPosition (std::size_t rowVal, std::size_t colVal)
-        : row (rowVal), col (colVal), addr (std::nullopt)
+    explicit constexpr CellPosition (std::nullopt_t /*unused*/) {}
+
+    template <typename T1, typename T2,
+              typename = std::enable_if_t<std::is_integral_v<T1>
+                                          && std::is_integral_v<T2>>>
+    explicit constexpr CellPosition (T1 rowVal, T2 colVal)
+        : row (static_cast<uint32_t> (rowVal)),
+          col (static_cast<uint32_t> (colVal))
     {
-        calculateExcelAddress ();
     }
 
     template <typename T1, typename T2>
-    explicit CellPosition (T1 rowVal, T2 colVal)
+    explicit constexpr CellPosition (std::pair<T1, T2> loc)
+        : CellPosition (loc.first, loc.second)
     {
-        row = convertToSizef (rowVal);
-        col = convertToSizef (colVal);
-        if (row.has_value () || col.has_value ())
+    }
+
+    // 解析地址 A1 -> (0,0), B2 -> (1,1); 格式错误抛出 ParseAddrException
+    explicit CellPosition (std::string_view addr)
+    {
+        auto pos = fromAddress (addr);
+        if (!pos.has_value ())
         {
-            calculateExcelAddress ();
+            throw ExcelReader::ParseAddrException (std::string (addr));
         }
+        *this = *pos;
     }
 
-    template <typename T1, typename T2>
-    explicit CellPosition (std::pair<T1, T2> loc)
-        : row (static_cast<std::size_t> (loc.first)),
-          col (static_cast<std::size_t> (loc.second)), addr (std::nullopt)
+    explicit CellPosition (const std::string &addr)
+        : CellPosition (std::string_view (addr))
+    {
+    }
+
+    explicit CellPosition (const char *addr)
+        : CellPosition (std::string_view (addr))
+    {
+    }
+
+    [[nodiscard]] constexpr bool
+    valid () const
     {
-        calculateExcelAddress ();
+        return row != npos && col != npos;
     }
 
-    explicit CellPosition (const std::string &addr) : addr (addr)
+    // 解析 A1 形式的地址, 列名不区分大小写; 格式错误或越界返回空
+    static constexpr std::optional<CellPosition>
+    fromAddress (std::string_view addr)
     {
-        // 解析地址 A1 -> (0,0), B2 -> (1,1)
-        std::string col_part;
-        std::string row_part;
-        size_t idx = 0;
-        while (idx < addr.length () && (std::isalpha (addr[idx]) != 0))
+        std::size_t idx = 0;
+        uint64_t colNum = 0;
+        while (idx < addr.size () && isAlpha (addr[idx]))
         {
-            col_part += addr[idx];
-            idx++;
+            colNum = colNum * 26 + (toUpper (addr[idx]) - 'A' + 1);
+            if (colNum > npos)
+            {
+                return std::nullopt;
+            }
+            ++idx;
         }
-        while (idx < addr.length () && (std::isdigit (addr[idx]) != 0))
+
+        const std::size_t digitsBegin = idx;
+        uint64_t rowNum = 0;
+        while (idx < addr.size () && addr[idx] >= '0' && addr[idx] <= '9')
         {
-            row_part += addr[idx];
-            idx++;
+            rowNum = rowNum * 10 + static_cast<uint64_t> (addr[idx] - '0');
+            if (rowNum > npos)
+            {
+                return std::nullopt;
+            }
+            ++idx;
         }
 
-        int col_num = 0;
-        for (char chr : col_part)
+        if (colNum == 0 || idx == digitsBegin || idx != addr.size ()
+            || rowNum == 0)
         {
-            col_num = col_num * 26 + (chr - 'A' + 1);
+            return std::nullopt;
         }
+        return CellPosition (rowNum - 1, colNum - 1);
+    }
 
-        if (!row_part.empty ())
+    // 列号转列名 (0 -> A, 26 -> AA), 写入 out, 返回长度
+    // out 至少需要 7 字节
+    static constexpr std::size_t
+    columnName (uint32_t colNum, char *out)
+    {
+        char buf[7] = {};
+        std::size_t len = 0;
+        uint64_t n = static_cast<uint64_t> (colNum) + 1;
+        while (n > 0)
         {
-            row = std::stoi (row_part) - 1;
+            buf[len++] = static_cast<char> ('A' + (n - 1) % 26);
+            n = (n - 1) / 26;
         }
-        else
+        for (std::size_t i = 0; i < len; ++i)
         {
-            row = 0;
+            out[i] = buf[len - 1 - i];
         }
+        return len;
+    }
 
-        col = col_num >= 0 ? static_cast<std::size_t> (col_num - 1) : 0;
-    };
-
-    ~CellPosition () = default;
-
-  private:
-    void
-    calculateExcelAddress ()
+    // 地址写入 out (至少 MaxAddrLength 字节, 不追加 '\0'), 返回长度
+    // 无效位置返回 0
+    constexpr std::size_t
+    formatAddress (char *out) const
     {
-        if (!row.has_value () && !col.has_value ())
+        if (!valid ())
         {
-            addr = std::nullopt;
-            return;
+            return 0;
         }
 
-        std::string colPart;
-        std::size_t colNum = col.value ();
-
-        while (true)
+        std::size_t len = columnName (col, out);
+        char digits[10] = {};
+        std::size_t count = 0;
+        uint64_t n = static_cast<uint64_t> (row) + 1;
+        while (n > 0)
         {
-            colPart += static_cast<char> ('A' + (colNum % 26));
-            if (colNum < 26)
-            {
-                break;
-            }
-            colNum = colNum / 26 - 1;
+            digits[count++] = static_cast<char> ('0' + n % 10);
+            n /= 10;
         }
-        std::reverse (colPart.begin (), colPart.end ());
-        this->addr = colPart + std::to_string (row.value () + 1);
+        while (count > 0)
+        {
+            out[len++] = digits[--count];
+        }
+        return len;
     }
 
-    template <typename T>
-    static std::optional<std::size_t>
-    convertToSizef (T value)
+    // A1 形式的地址, 无效位置返回空字符串
+    [[nodiscard]] std::string
+    addr () const
     {
-        if constexpr (std::is_same_v<T, std::nullopt_t>)
-        {
-            return std::nullopt;
-        }
-        else if constexpr (std::is_integral_v<T>)
-        {
-            return static_cast<std::size_t> (value);
-        }
+        char buf[MaxAddrLength] = {};
+        return { buf, formatAddress (buf) };
+    }
 
-        return std::nullopt;
+    constexpr bool
+    operator== (const CellPosition &other) const
+    {
+        return row == other.row && col == other.col;
+    }
+
+    constexpr bool
+    operator!= (const CellPosition &other) const
+    {
+        return !(*this == other);
+    }
+
+  private:
+    static constexpr bool
+    isAlpha (char chr)
+    {
+        return (chr >= 'A' && chr <= 'Z') || (chr >= 'a' && chr <= 'z');
+    }
+
+    static constexpr char
+    toUpper (char chr)
+    {
+        return (chr >= 'a' && chr <= 'z') ? static_cast<char> (chr - 'a' + 'A')
+                                          : chr;
     }
 };
 
+static_assert (sizeof (CellPosition) == 8, "CellPosition must stay packed");
+
 class XlsCell
 {
   private:
@@ -148,7 +271,17 @@ class XlsCell
     CellPosition location_;
     std::optional<CellType> type_;
     std::variant<std::monostate, std::string, double, bool> value_;
+    const DateFormatCache *formats_ = nullptr;
 
+    // 没有格式表时按内置格式 id 判断
+    [[nodiscard]] bool
+    isDateXf () const
+    {
+        return formats_ != nullptr ? formats_->isDateXf (cell_->xf)
+                                   : isDateTime (cell_->xf);
+    }
+
+    // 数值和 TRUE / FALSE 按去掉首尾空格和制表符后的文本判断
     void
     inferValueFromStringCell (bool trimWs)
     {
@@ -157,36 +290,26 @@ class XlsCell
         {
             type_ = CellType::BLANK;
             value_ = std::monostate{};
-        }
-        try
-        {
-            auto tmp = std::stod (s);
-            if (tmp < std::numeric_limits<double>::epsilon ())
-            {
-                value_ = tmp;
-                type_ = CellType::NUMBER;
-            }
-        }
-        catch (...)
-        {
+            return;
         }
 
-        try
+        const std::string_view text = trimLabel (s);
+        double number;
+        if (numparse::parseNumericText (text, number))
         {
-            auto strlower = tolower (s);
-            auto tmp = std::equal (strlower.begin (), strlower.end (), "bool");
-            if (tmp)
-            {
-                value_ = tmp;
-                type_ = CellType::BOOL;
-            }
+            type_ = CellType::NUMBER;
+            value_ = number;
+            return;
         }
-
-        catch (...)
+        bool flag;
+        if (numparse::parseBoolText (text, flag))
         {
+            type_ = CellType::BOOL;
+            value_ = flag;
+            return;
         }
         type_ = CellType::STRING;
-        value_ = trimWs ? trim (s) : s;
+        value_ = trimWs ? std::string (text) : s;
     };
     void
     inferValueFromFormulaCell ()
@@ -204,8 +327,7 @@ class XlsCell
                 value_ = std::monostate{};
                 return;
             }
-            auto format = cell_->xf;
-            type_ = (isDateTime (format)) ? CellType::DATE : CellType::NUMBER;
+            type_ = isDateXf () ? CellType::DATE : CellType::NUMBER;
             value_ = cell_->d;
             return;
         }
@@ -261,8 +383,7 @@ class XlsCell
             value_ = std::monostate{};
             return;
         }
-        int format = cell_->xf;
-        type_ = (isDateTime (format)) ? CellType::DATE : CellType::NUMBER;
+        type_ = isDateXf () ? CellType::DATE : CellType::NUMBER;
         value_ = cell_->d;
     };
     void
@@ -372,7 +493,10 @@ class XlsCell
         {
             boolValue = *b;
         }
-        boolValue = cell_->d != 0.0;
+        else
+        {
+            boolValue = cell_->d != 0.0;
+        }
 
         return boolValue ? "TRUE" : "FALSE";
     }
@@ -382,11 +506,16 @@ class XlsCell
     {
         double value = 0.0;
 
+        // 字符串单元格推断出的数值只在 value_ 中, VALUES_ONLY 模式下
+        // cell_->d 不含文本的值
         if (const auto *d = std::get_if<double> (&value_))
         {
             value = *d;
         }
-        value = cell_->d;
+        else
+        {
+            value = cell_->d;
+        }
 
         return formatDouble (value);
     }
@@ -411,46 +540,8 @@ class XlsCell
     [[nodiscard]] static std::string
     formatDouble (double value)
     {
-        std::ostringstream oss;
-
-        // 检查是否为整数
-        double intpart;
-        if (std::modf (value, &intpart) == 0.0)
-        {
-            // 整数值：使用整数格式化
-            if (value >= std::numeric_limits<int64_t>::min ()
-                && value <= double (std::numeric_limits<int64_t>::max ()))
-            {
-                oss << static_cast<int64_t> (value);
-            }
-            else
-            {
-                oss << std::fixed << std::setprecision (0) << value;
-            }
-        }
-        else
-        {
-            // 浮点值：智能格式化
-            oss << std::setprecision (15) << value;
-
-            std::string str = oss.str ();
-
-            // 移除尾随的0
-            if (str.find ('.') != std::string::npos)
-            {
-                // 移除尾随的0
-                str.erase (str.find_last_not_of ('0') + 1, std::string::npos);
-                // 如果最后是小数点，也移除
-                if (!str.empty () && str.back () == '.')
-                {
-                    str.pop_back ();
-                }
-            }
-
-            return str;
-        }
-
-        return oss.str ();
+        char buf[MaxDoubleLength];
+        return { buf, formatDouble (value, buf) };
     }
 
     void
@@ -479,31 +570,76 @@ class XlsCell
     XlsCell (XlsCell &&) = default;
     XlsCell &operator= (const XlsCell &) = default;
     XlsCell &operator= (XlsCell &&) = default;
-    explicit XlsCell (xls::xlsCell *cell)
-        : location_ (CellPosition (std::nullopt))
+    // formats 为工作簿的格式表, 用于把 XF 下标解析为日期等格式
+    explicit XlsCell (xls::xlsCell *cell,
+                      const DateFormatCache *formats = nullptr)
+        : location_ (CellPosition (std::nullopt)), formats_ (formats)
     {
         initialize (cell);
     }
 
-    [[nodiscard]] int
-    row () const
+    // formatDouble 输出的最大长度 (-DBL_MAX 的定点表示为 310 字符)
+    static constexpr std::size_t MaxDoubleLength = 320;
+
+    // 数值写入 out (至少 MaxDoubleLength 字节, 不追加 '\0'), 返回长度
+    // 整数按整数输出, 其它按 15 位有效数字 (同 %.15g) 并移除尾随的 0
+    static std::size_t
+    formatDouble (double value, char *out)
     {
-        if (location_.row.has_value ())
+        char *last = out + MaxDoubleLength;
+        std::to_chars_result res{};
+
+        // 检查是否为整数
+        double intpart;
+        if (std::modf (value, &intpart) == 0.0)
+        {
+            // int64 范围内按整数格式化, 超出范围 (含 inf) 按定点格式化
+            if (value >= -0x1p63 && value < 0x1p63)
+            {
+                res = std::to_chars (out, last, static_cast<int64_t> (value));
+            }
+            else
+            {
+                res = std::to_chars (out, last, value, std::chars_format::fixed,
+                                     0);
+            }
+            return static_cast<std::size_t> (res.ptr - out);
+        }
+
+        res = std::to_chars (out, last, value, std::chars_format::general, 15);
+        std::size_t len = static_cast<std::size_t> (res.ptr - out);
+
+        // 移除尾随的0, 如果最后是小数点也移除
+        if (std::memchr (out, '.', len) != nullptr)
         {
-            return location_.row.value ();
+            while (len > 0 && out[len - 1] == '0')
+            {
+                --len;
+            }
+            if (len > 0 && out[len - 1] == '.')
+            {
+                --len;
+            }
         }
-        return -1;
+        return len;
+    }
+
+    [[nodiscard]] int
+    row () const
+    {
+        return location_.valid () ? static_cast<int> (location_.row) : -1;
     }
 
     [[nodiscard]] int
     col () const
     {
-        if (location_.col.has_value ())
-        {
+        return location_.valid () ? static_cast<int> (location_.col) : -1;
+    }
 
-            return location_.col.value ();
-        }
-        return -1;
+    [[nodiscard]] CellType
+    type () const
+    {
+        return type_.value_or (CellType::UNKNOWN);
     }
 
     // 如果trim那么意味着推到字符串可能代码的值，例如" 123"代表123
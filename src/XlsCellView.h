@@ -0,0 +1,262 @@
+#ifndef XLSCELLVIEW_H
+#define XLSCELLVIEW_H
+
+#include "DateFormatCache.h"
+#include "XlsCell.h"
+
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// 单元格视图: 只保存指向已解析单元格和工作簿日期格式表的指针,
+// 可平凡复制, 不分配内存
+// 类型和值在访问时才计算; 生命周期不能超过所属的 XLSReader
+// (或 releaseSheet 之前)
+// 需要独立保存单元格时使用 toCell () 得到 XlsCell
+class XlsCellView
+{
+  private:
+    const xls::xlsCell *cell_ = nullptr;
+    const DateFormatCache *formats_ = nullptr;
+
+    [[nodiscard]] bool
+    strEquals (std::string_view expected) const
+    {
+        return cell_->str != nullptr && std::string_view (cell_->str) == expected;
+    }
+
+    [[nodiscard]] bool
+    strBlank () const
+    {
+        if (cell_->str == nullptr)
+        {
+            return true;
+        }
+        for (const char *p = cell_->str; *p != '\0'; ++p)
+        {
+            if (std::isspace (static_cast<unsigned char> (*p)) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool
+    isLabel () const
+    {
+        return cell_->id == XLS_RECORD_LABELSST
+               || cell_->id == XLS_RECORD_LABEL
+               || cell_->id == XLS_RECORD_RSTRING;
+    }
+
+    [[nodiscard]] std::string_view
+    str () const
+    {
+        return cell_->str != nullptr ? std::string_view (cell_->str)
+                                     : std::string_view ();
+    }
+
+    // 数值: 字符串单元格取文本表示的值 (TRUE 为 1), 其它取 d
+    [[nodiscard]] double
+    number () const
+    {
+        return isLabel () ? labelValue (str ()) : cell_->d;
+    }
+
+    [[nodiscard]] CellType
+    numberType () const
+    {
+        auto kind = numberKind ();
+        return (kind == NumberKind::DATE || kind == NumberKind::TIME)
+                   ? CellType::DATE
+                   : CellType::NUMBER;
+    }
+
+  public:
+    XlsCellView () = default;
+    explicit XlsCellView (const xls::xlsCell *cell,
+                          const DateFormatCache *formats = nullptr)
+        : cell_ (cell), formats_ (formats)
+    {
+    }
+
+    // 视图是否指向实际存在的单元格
+    [[nodiscard]] bool
+    valid () const
+    {
+        return cell_ != nullptr;
+    }
+
+    [[nodiscard]] const xls::xlsCell *
+    raw () const
+    {
+        return cell_;
+    }
+
+    [[nodiscard]] int
+    row () const
+    {
+        return cell_ == nullptr ? -1 : cell_->row;
+    }
+
+    [[nodiscard]] int
+    col () const
+    {
+        return cell_ == nullptr ? -1 : cell_->col;
+    }
+
+    // 单元格 XF 对应的数字格式种类, 只对数值单元格有意义
+    // 没有格式表时按内置格式 id 判断 (与 XlsCell 一致)
+    [[nodiscard]] NumberKind
+    numberKind () const
+    {
+        if (cell_ == nullptr)
+        {
+            return NumberKind::NUMBER;
+        }
+        return formats_ != nullptr ? formats_->xfKind (cell_->xf)
+                                   : builtinFormatKind (cell_->xf);
+    }
+
+    [[nodiscard]] CellType
+    type () const
+    {
+        if (cell_ == nullptr)
+        {
+            return CellType::BLANK;
+        }
+
+        switch (cell_->id)
+        {
+        case XLS_RECORD_LABELSST:
+        case XLS_RECORD_LABEL:
+        case XLS_RECORD_RSTRING:
+            // 与 XlsCell / XlsxCellView 相同, 按文本内容推断
+            return inferLabelType (str ());
+
+        case XLS_RECORD_MULBLANK:
+        case XLS_RECORD_BLANK:
+            return strBlank () ? CellType::BLANK : CellType::STRING;
+
+        case XLS_RECORD_FORMULA:
+        case XLS_RECORD_FORMULA_ALT:
+            // l == 0 表示公式结果为数值, 否则 str 为 "bool" / "error" / 文本
+            if (cell_->l == 0)
+            {
+                return numberType ();
+            }
+            if (strEquals ("bool"))
+            {
+                return CellType::BOOL;
+            }
+            if (strEquals ("error") || strBlank ())
+            {
+                return CellType::BLANK;
+            }
+            return CellType::STRING;
+
+        case XLS_RECORD_MULRK:
+        case XLS_RECORD_NUMBER:
+        case XLS_RECORD_RK:
+            return numberType ();
+
+        case XLS_RECORD_BOOLERR:
+            return strEquals ("bool") ? CellType::BOOL : CellType::BLANK;
+
+        default:
+            return CellType::UNKNOWN;
+        }
+    }
+
+    [[nodiscard]] double
+    asDouble () const
+    {
+        switch (type ())
+        {
+        case CellType::NUMBER:
+        case CellType::DATE:
+            return number ();
+        case CellType::BOOL:
+            return number () != 0.0 ? 1.0 : 0.0;
+        default:
+            return 0.0;
+        }
+    }
+
+    [[nodiscard]] bool
+    asLogical () const
+    {
+        switch (type ())
+        {
+        case CellType::NUMBER:
+        case CellType::BOOL:
+            return number () != 0.0;
+        default:
+            return false;
+        }
+    }
+
+    // 单元格的原始文本, 指向解析结果中的内存: 字符串记录 (LABEL /
+    // LABELSST / RSTRING) 无论推断为何种类型都返回原文, 如 "007";
+    // 字符串公式结果等 STRING 单元格返回其文本; 其它返回空
+    [[nodiscard]] std::string_view
+    text () const
+    {
+        if (cell_ == nullptr || (!isLabel () && type () != CellType::STRING))
+        {
+            return {};
+        }
+        return str ();
+    }
+
+    // 显示文本 (会分配内存), 用于列名等: 字符串记录为原文; 布尔为
+    // TRUE / FALSE; 数值和日期按 XlsCell::formatDouble 格式化, 不用
+    // FULL 模式下 libxls 以 "%lf" 生成的字符串, 结果与解析模式无关;
+    // 空白为空串
+    [[nodiscard]] std::string
+    displayText () const
+    {
+        if (cell_ == nullptr)
+        {
+            return {};
+        }
+        if (isLabel ())
+        {
+            return std::string (str ());
+        }
+        switch (type ())
+        {
+        case CellType::BOOL:
+            return asLogical () ? "TRUE" : "FALSE";
+        case CellType::NUMBER:
+        case CellType::DATE:
+        {
+            char buf[XlsCell::MaxDoubleLength];
+            return { buf, XlsCell::formatDouble (asDouble (), buf) };
+        }
+        case CellType::STRING:
+            return std::string (text ());
+        default:
+            return {};
+        }
+    }
+
+    // 复制为独立的 XlsCell (会分配内存)
+    [[nodiscard]] XlsCell
+    toCell () const
+    {
+        if (cell_ == nullptr)
+        {
+            throw ExcelReader::NullCellException ("");
+        }
+        return XlsCell (const_cast<xls::xlsCell *> (cell_), formats_);
+    }
+};
+
+static_assert (std::is_trivially_copyable_v<XlsCellView>,
+               "XlsCellView must stay trivially copyable");
+
+#endif
@@ -0,0 +1,1091 @@
+#ifndef XLSXPARSER_H
+#define XLSXPARSER_H
+
+#include "DateFormatCache.h"
+#include "NumberParse.h"
+#include "XlsCell.h"
+#include "XlsxSheet.h"
+#include "XmlSimd.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// XLSX 各部件 XML 的最小解析器
+// 只识别读取需要的元素和属性, 不校验文档, 不建立 DOM;
+// 元素和属性的命名空间前缀 (如 x:c, r:id) 被忽略
+namespace xlsx
+{
+
+// XLSX 最多 1048576 行, 16384 列; 超出的行列来自损坏或恶意构造的文件
+constexpr uint32_t MaxRows = 1048576;
+constexpr uint32_t MaxColumns = 16384;
+
+// Unicode 码点编码为 UTF-8 写入 out (至少 4 字节), 返回字节数
+inline std::size_t
+encodeUtf8 (uint32_t cp, char *out)
+{
+    if (cp < 0x80)
+    {
+        out[0] = static_cast<char> (cp);
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        out[0] = static_cast<char> (0xC0 | (cp >> 6));
+        out[1] = static_cast<char> (0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        out[0] = static_cast<char> (0xE0 | (cp >> 12));
+        out[1] = static_cast<char> (0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char> (0x80 | (cp & 0x3F));
+        return 3;
+    }
+    if (cp < 0x110000)
+    {
+        out[0] = static_cast<char> (0xF0 | (cp >> 18));
+        out[1] = static_cast<char> (0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char> (0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char> (0x80 | (cp & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+// 解码实体引用 name (不含 & 和 ;), 结果写入 out, 无法识别时返回 0
+inline std::size_t
+decodeEntity (std::string_view name, char *out)
+{
+    if (name == "amp" || name == "lt" || name == "gt" || name == "quot"
+        || name == "apos")
+    {
+        switch (name[0])
+        {
+        case 'a':
+            out[0] = name[1] == 'm' ? '&' : '\'';
+            break;
+        case 'l':
+            out[0] = '<';
+            break;
+        case 'g':
+            out[0] = '>';
+            break;
+        default:
+            out[0] = '"';
+            break;
+        }
+        return 1;
+    }
+    if (name.size () < 2 || name[0] != '#')
+    {
+        return 0;
+    }
+
+    const char *first = name.data () + 1;
+    const char *last = name.data () + name.size ();
+    int base = 10;
+    if (*first == 'x' || *first == 'X')
+    {
+        ++first;
+        base = 16;
+    }
+    uint32_t cp = 0;
+    auto [ptr, ec] = std::from_chars (first, last, cp, base);
+    if (ec != std::errc () || ptr != last || first == last)
+    {
+        return 0;
+    }
+    return encodeUtf8 (cp, out);
+}
+
+// 解码文本或属性值中的实体引用, 结果按片段交给 emit(std::string_view)
+// 无法识别的 '&' 原样保留
+template <typename Emit>
+void
+decodeText (std::string_view text, Emit &&emit)
+{
+    while (!text.empty ())
+    {
+        const auto amp = text.find ('&');
+        if (amp == std::string_view::npos)
+        {
+            emit (text);
+            return;
+        }
+        if (amp > 0)
+        {
+            emit (text.substr (0, amp));
+        }
+        text.remove_prefix (amp);
+
+        char buf[4];
+        std::size_t len = 0;
+        const auto semi = text.find (';');
+        if (semi != std::string_view::npos && semi <= 12)
+        {
+            len = decodeEntity (text.substr (1, semi - 1), buf);
+        }
+        if (len == 0)
+        {
+            emit (text.substr (0, 1));
+            text.remove_prefix (1);
+            continue;
+        }
+        emit (std::string_view (buf, len));
+        text.remove_prefix (semi + 1);
+    }
+}
+
+inline std::string
+decodeString (std::string_view text)
+{
+    std::string out;
+    decodeText (text, [&out] (std::string_view part) { out.append (part); });
+    return out;
+}
+
+template <typename T>
+bool
+parseUnsigned (std::string_view text, T &out)
+{
+    const char *last = text.data () + text.size ();
+    auto [ptr, ec] = std::from_chars (text.data (), last, out);
+    return ec == std::errc () && ptr == last && !text.empty ();
+}
+
+using numparse::parseNumber;
+
+// 公历日期距 1970-01-01 的天数
+constexpr int64_t
+daysFromCivil (int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2 ? 1 : 0;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned> (y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t> (doe) - 719468;
+}
+
+// t="d" 单元格的 ISO 8601 文本: YYYY-MM-DD, 可带 Thh:mm[:ss[.fff]];
+// 或只有时间 hh:mm[:ss[.fff]]. 时区后缀 (Z, +hh:mm) 被忽略
+// 结果为 date1904 对应日期系统的序列号, 与 t="n" 的日期单元格一致;
+// 只有时间时为一天中的比例
+inline bool
+parseIsoDate (std::string_view text, bool date1904, double &serial)
+{
+    std::size_t pos = 0;
+    auto digits = [&text, &pos] (std::size_t count, unsigned &out)
+    {
+        if (pos + count > text.size ())
+        {
+            return false;
+        }
+        out = 0;
+        for (const std::size_t end = pos + count; pos < end; ++pos)
+        {
+            if (text[pos] < '0' || text[pos] > '9')
+            {
+                return false;
+            }
+            out = out * 10 + static_cast<unsigned> (text[pos] - '0');
+        }
+        return true;
+    };
+    auto skip = [&text, &pos] (char c)
+    {
+        if (pos < text.size () && text[pos] == c)
+        {
+            ++pos;
+            return true;
+        }
+        return false;
+    };
+
+    double days = 0.0;
+    if (text.size () >= 5 && text[4] == '-')
+    {
+        constexpr unsigned char MonthDays[]
+            = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        unsigned y = 0;
+        unsigned m = 0;
+        unsigned d = 0;
+        if (!digits (4, y) || !skip ('-') || !digits (2, m) || !skip ('-')
+            || !digits (2, d) || m < 1 || m > 12 || d < 1
+            || d > MonthDays[m - 1]
+            || (m == 2 && d == 29 && (y % 4 != 0 || (y % 100 == 0
+                                                     && y % 400 != 0))))
+        {
+            return false;
+        }
+        days = static_cast<double> (daysFromCivil (y, m, d))
+               + (date1904 ? 24107.0 : 25569.0);
+        if (pos == text.size ())
+        {
+            serial = days;
+            return true;
+        }
+        if (!skip ('T'))
+        {
+            return false;
+        }
+    }
+
+    unsigned h = 0;
+    unsigned mi = 0;
+    unsigned sec = 0;
+    double fraction = 0.0;
+    if (!digits (2, h) || !skip (':') || !digits (2, mi) || h > 24 || mi > 59)
+    {
+        return false;
+    }
+    if (skip (':'))
+    {
+        if (!digits (2, sec) || sec > 60)
+        {
+            return false;
+        }
+        if (skip ('.'))
+        {
+            const std::size_t start = pos;
+            for (double scale = 0.1;
+                 pos < text.size () && text[pos] >= '0' && text[pos] <= '9';
+                 ++pos, scale /= 10.0)
+            {
+                fraction += (text[pos] - '0') * scale;
+            }
+            if (pos == start)
+            {
+                return false;
+            }
+        }
+    }
+    if (pos < text.size () && text[pos] != 'Z' && text[pos] != '+'
+        && text[pos] != '-')
+    {
+        return false;
+    }
+    serial = days + (h * 3600.0 + mi * 60.0 + sec + fraction) / 86400.0;
+    return true;
+}
+
+inline bool
+isXmlSpace (char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline std::string_view
+localName (std::string_view name)
+{
+    const auto colon = name.find (':');
+    return colon == std::string_view::npos ? name : name.substr (colon + 1);
+}
+
+// 标签扫描器: next () 依次停在每个开始 / 结束标签上
+// 文本内容不逐字符处理, 需要时由 text () / content () 取出; 注释,
+// 处理指令, DOCTYPE 和 CDATA 段不作为标签返回
+// '<', 标签结束和引号的查找通过 XmlSimd.h 的分类位图完成,
+// 分类内核按 CPU 选择 (AVX2 / SSE2 / 标量)
+class XmlScanner
+{
+  private:
+    const char *pos_;
+    const char *end_;
+    xmlsimd::BlockCursor cursor_;
+    std::string_view name_;
+    std::string_view attrs_;
+    bool closing_ = false;
+    bool selfClosing_ = false;
+    std::string decoded_;
+
+    const char *
+    find (std::string_view token, const char *from) const
+    {
+        std::string_view rest (from, static_cast<std::size_t> (end_ - from));
+        const auto at = rest.find (token);
+        return at == std::string_view::npos ? end_
+                                            : from + at + token.size ();
+    }
+
+  public:
+    explicit XmlScanner (std::string_view xml,
+                         const xmlsimd::Kernels &kernels = xmlsimd::active ())
+        : pos_ (xml.data ()), end_ (xml.data () + xml.size ()),
+          cursor_ (end_, kernels)
+    {
+    }
+
+    // 移动到下一个标签, 文档结束时返回 false
+    bool
+    next ()
+    {
+        for (;;)
+        {
+            const char *lt = cursor_.find (pos_, &xmlsimd::BlockMasks::lt);
+            if (lt + 1 >= end_)
+            {
+                pos_ = end_;
+                return false;
+            }
+
+            const char *p = lt + 1;
+            if (*p == '?')
+            {
+                pos_ = find ("?>", p);
+                continue;
+            }
+            if (*p == '!')
+            {
+                std::string_view rest (p, static_cast<std::size_t> (end_ - p));
+                if (rest.substr (0, 3) == "!--")
+                {
+                    pos_ = find ("-->", p);
+                }
+                else if (rest.substr (0, 8) == "![CDATA[")
+                {
+                    pos_ = find ("]]>", p);
+                }
+                else
+                {
+                    pos_ = find (">", p);
+                }
+                continue;
+            }
+
+            closing_ = *p == '/';
+            if (closing_)
+            {
+                ++p;
+            }
+            const char *nameBegin = p;
+            while (p < end_ && !isXmlSpace (*p) && *p != '/' && *p != '>')
+            {
+                ++p;
+            }
+            name_ = localName (
+                { nameBegin, static_cast<std::size_t> (p - nameBegin) });
+
+            // 属性值中允许出现未转义的 '>', 跳过引号之间的内容
+            const char *attrBegin = p;
+            for (;;)
+            {
+                p = cursor_.find (p, &xmlsimd::BlockMasks::tagEnd);
+                if (p >= end_ || *p == '>')
+                {
+                    break;
+                }
+                const char quote = *p;
+                do
+                {
+                    p = cursor_.find (p + 1, &xmlsimd::BlockMasks::quote);
+                } while (p < end_ && *p != quote);
+                if (p < end_)
+                {
+                    ++p;
+                }
+            }
+            if (p >= end_)
+            {
+                pos_ = end_;
+                return false;
+            }
+
+            selfClosing_ = p > attrBegin && p[-1] == '/';
+            attrs_ = { attrBegin, static_cast<std::size_t> (
+                                      p - attrBegin - (selfClosing_ ? 1 : 0)) };
+            pos_ = p + 1;
+            return true;
+        }
+    }
+
+    [[nodiscard]] std::string_view
+    name () const
+    {
+        return name_;
+    }
+
+    [[nodiscard]] bool
+    closing () const
+    {
+        return closing_;
+    }
+
+    [[nodiscard]] bool
+    selfClosing () const
+    {
+        return selfClosing_;
+    }
+
+    // 当前是否为名为 name 的开始标签
+    [[nodiscard]] bool
+    opens (std::string_view name) const
+    {
+        return !closing_ && name_ == name;
+    }
+
+    // 当前是否为名为 name 的结束标签
+    [[nodiscard]] bool
+    closes (std::string_view name) const
+    {
+        return closing_ && name_ == name;
+    }
+
+    // 当前标签之后, 下一个标签之前的原始文本 (未解码)
+    [[nodiscard]] std::string_view
+    text ()
+    {
+        return { pos_, static_cast<std::size_t> (
+                           cursor_.find (pos_, &xmlsimd::BlockMasks::lt)
+                           - pos_) };
+    }
+
+    // 当前标签之后, 下一个标签之前的文本内容, 按片段交给
+    // emit(std::string_view): 实体被解码, CDATA 段原样保留, 注释跳过
+    template <typename Emit>
+    void
+    decodeContent (Emit &&emit)
+    {
+        const char *p = pos_;
+        for (;;)
+        {
+            const char *lt = cursor_.find (p, &xmlsimd::BlockMasks::lt);
+            decodeText ({ p, static_cast<std::size_t> (lt - p) }, emit);
+            const std::string_view rest (
+                lt, static_cast<std::size_t> (end_ - lt));
+            if (rest.substr (0, 9) == "<![CDATA[")
+            {
+                const auto close = rest.find ("]]>", 9);
+                emit (rest.substr (9, close == std::string_view::npos
+                                          ? std::string_view::npos
+                                          : close - 9));
+                p = find ("]]>", lt);
+            }
+            else if (rest.substr (0, 4) == "<!--")
+            {
+                p = find ("-->", lt);
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+
+    // 解码后的文本内容, 见 decodeContent; 不含实体, CDATA 和注释时
+    // 直接指向原始文本, 否则在下次调用前有效
+    [[nodiscard]] std::string_view
+    content ()
+    {
+        const auto raw = text ();
+        const char *after = raw.data () + raw.size ();
+        if (raw.find ('&') == std::string_view::npos
+            && (end_ - after < 2 || after[1] != '!'))
+        {
+            return raw;
+        }
+        decoded_.clear ();
+        decodeContent ([this] (std::string_view part)
+                       { decoded_.append (part); });
+        return decoded_;
+    }
+
+    // 对当前标签的每个属性调用 fn(localName, rawValue), 值未解码
+    template <typename Fn>
+    void
+    forEachAttr (Fn &&fn) const
+    {
+        const char *p = attrs_.data ();
+        const char *end = p + attrs_.size ();
+        while (p < end)
+        {
+            while (p < end && isXmlSpace (*p))
+            {
+                ++p;
+            }
+            const char *nameBegin = p;
+            while (p < end && *p != '=' && !isXmlSpace (*p))
+            {
+                ++p;
+            }
+            std::string_view attrName (
+                nameBegin, static_cast<std::size_t> (p - nameBegin));
+            while (p < end && *p != '"' && *p != '\'')
+            {
+                ++p;
+            }
+            if (p >= end)
+            {
+                return;
+            }
+            const char quote = *p++;
+            const auto *close = static_cast<const char *> (
+                std::memchr (p, quote, static_cast<std::size_t> (end - p)));
+            if (close == nullptr)
+            {
+                return;
+            }
+            fn (localName (attrName),
+                std::string_view (p, static_cast<std::size_t> (close - p)));
+            p = close + 1;
+        }
+    }
+
+    // 属性的原始值, 不存在时返回空
+    [[nodiscard]] std::string_view
+    attr (std::string_view name) const
+    {
+        std::string_view found;
+        forEachAttr (
+            [&] (std::string_view key, std::string_view value)
+            {
+                if (found.data () == nullptr && key == name)
+                {
+                    found = value;
+                }
+            });
+        return found;
+    }
+
+    // 跳过当前元素的全部内容, 停在其结束标签上
+    void
+    skipElement ()
+    {
+        if (closing_ || selfClosing_)
+        {
+            return;
+        }
+        const std::string_view name = name_;
+        std::size_t depth = 1;
+        while (next ())
+        {
+            if (name_ != name || selfClosing_)
+            {
+                continue;
+            }
+            if (!closing_)
+            {
+                ++depth;
+            }
+            else if (--depth == 0)
+            {
+                return;
+            }
+        }
+    }
+};
+
+// 读取 <si> / <is> 中的文本, 富文本的各段 <r><t> 依次连接, 注音 <rPh>
+// 不计入; 扫描器停在 end 元素的结束标签上
+inline void
+readRichText (XmlScanner &scanner, std::string_view end, StringArena &out)
+{
+    while (scanner.next ())
+    {
+        if (scanner.closing ())
+        {
+            if (scanner.name () == end)
+            {
+                return;
+            }
+            continue;
+        }
+        if (scanner.name () == "t" && !scanner.selfClosing ())
+        {
+            scanner.decodeContent ([&out] (std::string_view part)
+                                   { out.append (part); });
+        }
+        else if (scanner.name () == "rPh")
+        {
+            scanner.skipElement ();
+        }
+    }
+}
+
+// xl/sharedStrings.xml: 第 i 个 <si> 成为 out 中的第 i 个字符串
+inline void
+parseSharedStrings (std::string_view xml, StringArena &out)
+{
+    XmlScanner scanner (xml);
+    while (scanner.next ())
+    {
+        if (scanner.opens ("sst"))
+        {
+            std::size_t count = 0;
+            parseUnsigned (scanner.attr ("uniqueCount"), count);
+            // 标记约占 XML 的一半, 只是预留容量的估计
+            out.reserve (count, xml.size () / 2);
+        }
+        else if (scanner.opens ("si"))
+        {
+            if (!scanner.selfClosing ())
+            {
+                readRichText (scanner, "si", out);
+            }
+            out.commit ();
+        }
+    }
+    out.shrink ();
+}
+
+// 包内部件之间的关系 (*.rels 中的 <Relationship>)
+struct Relationship
+{
+    std::string id;
+    std::string type;
+    std::string target;
+};
+
+inline std::vector<Relationship>
+parseRelationships (std::string_view xml)
+{
+    std::vector<Relationship> rels;
+    XmlScanner scanner (xml);
+    while (scanner.next ())
+    {
+        if (!scanner.opens ("Relationship"))
+        {
+            continue;
+        }
+        Relationship rel;
+        scanner.forEachAttr (
+            [&rel] (std::string_view key, std::string_view value)
+            {
+                if (key == "Id")
+                {
+                    rel.id = decodeString (value);
+                }
+                else if (key == "Type")
+                {
+                    rel.type = decodeString (value);
+                }
+                else if (key == "Target")
+                {
+                    rel.target = decodeString (value);
+                }
+            });
+        rels.push_back (std::move (rel));
+    }
+    return rels;
+}
+
+// 类型以 suffix 结尾的第一个关系, 不存在时返回空
+inline const Relationship *
+findRelationship (const std::vector<Relationship> &rels,
+                  std::string_view suffix)
+{
+    for (const auto &rel : rels)
+    {
+        std::string_view type (rel.type);
+        if (type.size () >= suffix.size ()
+            && type.substr (type.size () - suffix.size ()) == suffix)
+        {
+            return &rel;
+        }
+    }
+    return nullptr;
+}
+
+struct SheetEntry
+{
+    std::string name;
+    std::string relId;
+};
+
+struct WorkbookInfo
+{
+    std::vector<SheetEntry> sheets;
+    bool date1904 = false;
+};
+
+// xl/workbook.xml: 工作表名称, 关系 id 和日期系统
+inline WorkbookInfo
+parseWorkbook (std::string_view xml)
+{
+    WorkbookInfo info;
+    XmlScanner scanner (xml);
+    while (scanner.next ())
+    {
+        if (scanner.opens ("sheet"))
+        {
+            SheetEntry entry;
+            scanner.forEachAttr (
+                [&entry] (std::string_view key, std::string_view value)
+                {
+                    if (key == "name")
+                    {
+                        entry.name = decodeString (value);
+                    }
+                    else if (key == "id")
+                    {
+                        entry.relId = decodeString (value);
+                    }
+                });
+            info.sheets.push_back (std::move (entry));
+        }
+        else if (scanner.opens ("workbookPr"))
+        {
+            auto value = scanner.attr ("date1904");
+            info.date1904 = value == "1" || value == "true";
+        }
+        else if (scanner.closes ("sheets"))
+        {
+            // workbookPr 在 sheets 之前, 之后的部分不需要
+            break;
+        }
+    }
+    return info;
+}
+
+// xl/styles.xml: <numFmts> 中的自定义格式和 <cellXfs> 中每个 xf 的格式 id
+// (<cellStyleXfs> 中的 xf 不是单元格 s 属性的下标, 不计入)
+inline void
+parseStyles (std::string_view xml, DateFormatCache &formats)
+{
+    XmlScanner scanner (xml);
+    bool inCellXfs = false;
+    while (scanner.next ())
+    {
+        if (scanner.closing ())
+        {
+            if (scanner.name () == "cellXfs")
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (scanner.name () == "numFmt")
+        {
+            std::size_t id = 0;
+            if (parseUnsigned (scanner.attr ("numFmtId"), id))
+            {
+                formats.setFormat (
+                    id, decodeString (scanner.attr ("formatCode")));
+            }
+        }
+        else if (scanner.name () == "cellXfs")
+        {
+            inCellXfs = !scanner.selfClosing ();
+        }
+        else if (inCellXfs && scanner.name () == "xf")
+        {
+            std::size_t id = 0;
+            parseUnsigned (scanner.attr ("numFmtId"), id);
+            formats.addXf (id);
+        }
+    }
+}
+
+// 保存 <v> 中已解码的值, type 为 <c> 的 t 属性
+// t="d" 的日期按 date1904 换算为序列号, 无法识别时按文本保存
+inline void
+storeValue (XlsxSheet &sheet, uint32_t row, uint16_t col, uint16_t xf,
+            std::string_view type, std::string_view text, bool date1904)
+{
+    if (type.empty () || type == "n")
+    {
+        double value = 0.0;
+        if (parseNumber (text, value))
+        {
+            sheet.append (row, col, xf, XlsxValue::NUMBER).number = value;
+        }
+    }
+    else if (type == "s")
+    {
+        uint32_t index = 0;
+        if (parseUnsigned (text, index))
+        {
+            sheet.append (row, col, xf, XlsxValue::SHARED).str = index;
+        }
+    }
+    else if (type == "b")
+    {
+        sheet.append (row, col, xf, XlsxValue::BOOL).number
+            = (text == "1" || text == "true") ? 1.0 : 0.0;
+    }
+    else if (type == "e")
+    {
+        sheet.append (row, col, xf, XlsxValue::ERROR);
+    }
+    else
+    {
+        double serial = 0.0;
+        if (type == "d" && parseIsoDate (text, date1904, serial))
+        {
+            sheet.append (row, col, xf, XlsxValue::DATE).number = serial;
+            return;
+        }
+        // str (公式的字符串结果) 等按文本保存
+        auto &strings = sheet.inlineStrings ();
+        strings.append (text);
+        sheet.append (row, col, xf, XlsxValue::INLINE).str = strings.commit ();
+    }
+}
+
+// 读取一个 <c> 元素, row / col 为缺少 r 属性时使用的位置
+// 返回后 col 指向下一列
+inline void
+readCell (XmlScanner &scanner, XlsxSheet &sheet, uint32_t row, uint32_t &col,
+          bool date1904)
+{
+    uint16_t xf = 0;
+    std::string_view type;
+    scanner.forEachAttr (
+        [&] (std::string_view key, std::string_view value)
+        {
+            if (key == "r")
+            {
+                if (auto pos = CellPosition::fromAddress (value))
+                {
+                    row = pos->row;
+                    col = pos->col;
+                }
+            }
+            else if (key == "s")
+            {
+                parseUnsigned (value, xf);
+            }
+            else if (key == "t")
+            {
+                type = value;
+            }
+        });
+    const uint32_t cellCol = col++;
+    if (scanner.selfClosing ())
+    {
+        return;
+    }
+    if (cellCol >= MaxColumns || row >= MaxRows)
+    {
+        scanner.skipElement ();
+        return;
+    }
+
+    // 子元素: <f> 公式, <v> 值, <is> 内联字符串
+    while (scanner.next ())
+    {
+        if (scanner.closing ())
+        {
+            if (scanner.name () == "c")
+            {
+                return;
+            }
+            continue;
+        }
+        if (scanner.name () == "v" && !scanner.selfClosing ())
+        {
+            storeValue (sheet, row, static_cast<uint16_t> (cellCol), xf, type,
+                        scanner.content (), date1904);
+        }
+        else if (scanner.name () == "is" && !scanner.selfClosing ())
+        {
+            auto &strings = sheet.inlineStrings ();
+            readRichText (scanner, "is", strings);
+            sheet.append (row, static_cast<uint16_t> (cellCol), xf,
+                          XlsxValue::INLINE)
+                .str = strings.commit ();
+        }
+        else
+        {
+            scanner.skipElement ();
+        }
+    }
+}
+
+// xl/worksheets/sheetN.xml: 只扫描 <sheetData> 中的 <row> / <c>,
+// 结果写入 sheet 并建立行索引
+// 数据按解压顺序分块传入 feed, 每次在最后一个完整的 </row> 之后切分:
+// 之前的部分立即解析, 之后的部分留到下一块, 因此缓存的 XML 不超过
+// 一个数据块加一行
+class SheetStream
+{
+  private:
+    XlsxSheet &sheet_;
+    std::size_t sizeHint_;
+    bool date1904_;
+    std::string pending_;
+    uint32_t row_ = 0;
+    uint32_t nextRow_ = 0;
+    uint32_t col_ = 0;
+    bool done_ = false;
+
+    // 从 from 开始查找最后一个结束标签 </tag> (或带前缀的 </x:tag>),
+    // tag 含结尾的 '>'; 返回其后的位置, 没有时返回 npos
+    static std::size_t
+    closeBoundary (std::string_view xml, std::size_t from,
+                   std::string_view tag)
+    {
+        const std::string_view tail = xml.substr (from);
+        for (auto at = tail.rfind (tag); at != std::string_view::npos;
+             at = at == 0 ? std::string_view::npos : tail.rfind (tag, at - 1))
+        {
+            std::size_t k = from + at;
+            if (k > 0 && xml[k - 1] == ':')
+            {
+                --k;
+                while (k > 0 && xml[k - 1] != '/' && xml[k - 1] != '<'
+                       && xml[k - 1] != '>')
+                {
+                    --k;
+                }
+            }
+            if (k >= 2 && xml[k - 1] == '/' && xml[k - 2] == '<')
+            {
+                return from + at + tag.size ();
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // 可以切分的位置: 最后一个 </row> 或 </sheetData> 之后
+    // </sheetData> 只在最后一个 </row> 之后查找, 避免反向扫描整块数据
+    static std::size_t
+    boundary (std::string_view xml, std::size_t from)
+    {
+        const auto row = closeBoundary (xml, from, "row>");
+        const auto end = closeBoundary (
+            xml, row != std::string_view::npos ? row : from, "sheetData>");
+        return end != std::string_view::npos ? end : row;
+    }
+
+    // 解析以完整元素结尾的一段 XML
+    void
+    parse (std::string_view xml)
+    {
+        XmlScanner scanner (xml);
+        while (scanner.next ())
+        {
+            if (scanner.closing ())
+            {
+                if (scanner.name () == "sheetData")
+                {
+                    done_ = true;
+                    return;
+                }
+                continue;
+            }
+
+            const auto name = scanner.name ();
+            if (name == "c")
+            {
+                readCell (scanner, sheet_, row_, col_, date1904_);
+            }
+            else if (name == "row")
+            {
+                // 超出范围的行号记为 MaxRows, 其中没有 r 属性的单元格被跳过
+                uint32_t r = 0;
+                row_ = parseUnsigned (scanner.attr ("r"), r) && r > 0
+                           ? r - 1
+                           : nextRow_;
+                row_ = std::min (row_, MaxRows);
+                nextRow_ = std::min (row_ + 1, MaxRows);
+                col_ = 0;
+            }
+            else if (name == "dimension")
+            {
+                reserveFor (scanner.attr ("ref"));
+            }
+        }
+    }
+
+    // 按声明的范围预留, 以 XML 大小为上限 (每个单元格至少约 20 字节)
+    void
+    reserveFor (std::string_view ref)
+    {
+        auto colon = ref.find (':');
+        auto first = CellPosition::fromAddress (ref.substr (0, colon));
+        auto last = colon == std::string_view::npos
+                        ? first
+                        : CellPosition::fromAddress (ref.substr (colon + 1));
+        if (first && last && last->row >= first->row
+            && last->col >= first->col)
+        {
+            const std::size_t cells = std::size_t (last->row - first->row + 1)
+                                      * (last->col - first->col + 1);
+            sheet_.reserve (std::min (cells, sizeHint_ / 20));
+        }
+    }
+
+  public:
+    // sizeHint 为 XML 的预计大小, 只用于限制按 <dimension> 预留的容量
+    // date1904 为工作簿的日期系统, 用于换算 t="d" 单元格
+    SheetStream (XlsxSheet &sheet, std::size_t sizeHint, bool date1904 = false)
+        : sheet_ (sheet), sizeHint_ (sizeHint), date1904_ (date1904)
+    {
+    }
+
+    // 传入下一块数据; 读到 </sheetData> 后返回 false, 之后的数据不再需要
+    bool
+    feed (std::string_view data)
+    {
+        if (done_)
+        {
+            return false;
+        }
+        if (pending_.empty ())
+        {
+            const auto cut = boundary (data, 0);
+            if (cut != std::string_view::npos)
+            {
+                parse (data.substr (0, cut));
+                data.remove_prefix (cut);
+            }
+            if (!done_)
+            {
+                pending_.assign (data);
+            }
+            return !done_;
+        }
+
+        // 只在新数据中查找, 结束标签可能跨越两块; 前缀过长时漏掉的
+        // 切分点只会推迟解析
+        const std::size_t from
+            = pending_.size () > 16 ? pending_.size () - 16 : 0;
+        pending_.append (data);
+        const auto cut = boundary (pending_, from);
+        if (cut != std::string_view::npos)
+        {
+            parse (std::string_view (pending_).substr (0, cut));
+            pending_.erase (0, cut);
+        }
+        if (done_)
+        {
+            std::string ().swap (pending_);
+        }
+        return !done_;
+    }
+
+    // 解析剩余数据, 排序并建立行索引
+    void
+    finish ()
+    {
+        if (!done_ && !pending_.empty ())
+        {
+            parse (pending_);
+        }
+        std::string ().swap (pending_);
+        sheet_.finalize ();
+    }
+};
+
+// 解析完整的工作表 XML
+inline void
+parseSheet (std::string_view xml, XlsxSheet &sheet, bool date1904 = false)
+{
+    SheetStream stream (sheet, xml.size (), date1904);
+    stream.feed (xml);
+    stream.finish ();
+}
+
+} // namespace xlsx
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef XLSXREADER_H
+#define XLSXREADER_H
+
+#include "Exceptions.h"
+#include "XlsxStrategy.h"
+#include "reader.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+class XLSXReader : public TableReader
+{
+  private:
+    std::unique_ptr<XLSXReadStrategy> m_strategy;
+    fs::path path_;
+    Span<const std::byte> data_;
+    bool fromMemory_ = false;
+    OpenMode openMode_ = OpenMode::STREAM;
+    std::size_t sheetCounts_ = 0;
+
+  public:
+    // openMode: MAPPED 时整个文件只读映射, 解压直接读映射区
+    explicit XLSXReader (const fs::path &p,
+                         OpenMode openMode = OpenMode::STREAM)
+        : path_ (p), openMode_ (openMode)
+    {
+    }
+
+    // 从内存读取, 不复制; data 在本对象析构前必须有效
+    explicit XLSXReader (Span<const std::byte> data)
+        : data_ (data), fromMemory_ (true)
+    {
+    }
+
+    bool
+    open () override
+    {
+        try
+        {
+            m_strategy = fromMemory_
+                             ? std::make_unique<XLSXReadStrategy> (data_)
+                             : std::make_unique<XLSXReadStrategy> (
+                                   path_, openMode_);
+        }
+        catch (const ExcelReader::FailedOpenException &)
+        {
+            sheetCounts_ = 0;
+            return false;
+        }
+        sheetCounts_ = m_strategy->sheetCount ();
+        return true;
+    }
+
+    std::size_t
+    getSheetsCount () const override
+    {
+        return sheetCounts_;
+    }
+
+    std::string
+    getSheetName (std::size_t index) const
+    {
+        return m_strategy->getSheetName (index);
+    }
+
+    // 行列从 0 开始, 与 XLSReader 一致
+    CellType
+    readCell (std::size_t index, std::size_t row, std::size_t col)
+    {
+        return m_strategy->readCell (index, row, col);
+    }
+
+    // 批量读取, 第 i 个位置的结果写入 out[i]; 视图的生命周期同 rows ()
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<XlsxCellView> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<CellType> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    // 读取区域, 如 "A1:Z100", "C:C", "3:5"; 行优先的稠密块
+    CellBlock<XlsxCellView>
+    readRange (std::size_t index, std::string_view range)
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    CellBlock<XlsxCellView>
+    readRange (std::size_t index, const CellRange &range)
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    // 按列导出, skipRows 为跳过的表头行数
+    // DICTIONARY: 字符串列为 sharedStrings.xml 驻留后的编码和字典
+    SheetColumns
+    readColumns (std::size_t index, std::size_t skipRows = 0,
+                 StringEncoding encoding = StringEncoding::PLAIN)
+    {
+        return m_strategy->readColumns (index, skipRows, encoding);
+    }
+
+    void
+    releaseSheet (std::size_t index)
+    {
+        m_strategy->releaseSheet (index);
+    }
+
+    [[nodiscard]] bool
+    isSheetParsed (std::size_t index) const
+    {
+        return m_strategy->isSheetParsed (index);
+    }
+
+    // 按行遍历, 接口与 XLSReader::rows 相同
+    // 视图的生命周期不能超过本对象 (或 releaseSheet 之前)
+    XlsxSheetRows
+    rows (std::size_t index)
+    {
+        return XlsxSheetRows (m_strategy->sheet (index));
+    }
+
+    template <typename Fn>
+    void
+    forEachRow (std::size_t index, Fn &&fn)
+    {
+        ::forEachRow (m_strategy->sheet (index), std::forward<Fn> (fn));
+    }
+};
+
+#endif
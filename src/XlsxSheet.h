@@ -0,0 +1,756 @@
+#ifndef XLSXSHEET_H
+#define XLSXSHEET_H
+
+#include "DateFormatCache.h"
+#include "XlsCell.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 字符串池: 所有字符串连续存放在 chars_ 中, 第 i 个位于
+// [offsets_[i], offsets_[i+1]); 不为每个字符串单独分配内存
+class StringArena
+{
+  private:
+    std::vector<char> chars_;
+    std::vector<std::size_t> offsets_{ 0 };
+
+  public:
+    void
+    reserve (std::size_t strings, std::size_t bytes)
+    {
+        offsets_.reserve (strings + 1);
+        chars_.reserve (bytes);
+    }
+
+    // 向正在构建的字符串追加内容, 由 commit 结束
+    void
+    append (std::string_view text)
+    {
+        chars_.insert (chars_.end (), text.begin (), text.end ());
+    }
+
+    void
+    push (char c)
+    {
+        chars_.push_back (c);
+    }
+
+    // 结束当前字符串, 返回其下标
+    uint32_t
+    commit ()
+    {
+        offsets_.push_back (chars_.size ());
+        return static_cast<uint32_t> (offsets_.size () - 2);
+    }
+
+    uint32_t
+    add (std::string_view text)
+    {
+        append (text);
+        return commit ();
+    }
+
+    [[nodiscard]] std::string_view
+    get (std::size_t i) const
+    {
+        if (i + 1 >= offsets_.size ())
+        {
+            return {};
+        }
+        return { chars_.data () + offsets_[i], offsets_[i + 1] - offsets_[i] };
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return offsets_.size () - 1;
+    }
+
+    [[nodiscard]] std::size_t
+    bytes () const
+    {
+        return chars_.size ();
+    }
+
+    void
+    shrink ()
+    {
+        chars_.shrink_to_fit ();
+        offsets_.shrink_to_fit ();
+    }
+
+    void
+    clear ()
+    {
+        std::vector<char> ().swap (chars_);
+        offsets_.assign (1, 0);
+        offsets_.shrink_to_fit ();
+    }
+};
+
+// 单元格值的来源, 对应 <c t="...">
+enum class XlsxValue : uint8_t
+{
+    NUMBER = 0, // t="n" 或缺省, number 有效
+    BOOL,       // t="b", number 为 0 / 1
+    ERROR,      // t="e"
+    SHARED,     // t="s", str 为共享字符串下标
+    INLINE,     // t="inlineStr" / "str", str 为工作表字符串池下标
+    DATE        // t="d", number 为按工作簿日期系统换算的序列号
+};
+
+// 一个非空单元格, 24 字节, 连续存放
+struct XlsxCell
+{
+    uint32_t row; // 从 0 开始
+    uint16_t col; // 从 0 开始, XLSX 最多 16384 列
+    uint16_t xf;  // cellXfs 下标, 即 s 属性
+    XlsxValue value;
+    uint32_t str;
+    double number;
+};
+
+// 一张 XLSX 工作表的稀疏单元格, 结构与 SparseSheet 相同:
+//   cells_      按 (row, col) 排序
+//   rowOffsets_ 第 r 行位于 [rowOffsets_[r], rowOffsets_[r+1])
+// 字符串单元格引用工作簿的共享字符串表或本表的 inline_ 字符串池
+class XlsxSheet
+{
+  private:
+    std::vector<XlsxCell> cells_;
+    std::vector<uint32_t> rowOffsets_;
+    StringArena inline_;
+    const StringArena *shared_ = nullptr;
+    const DateFormatCache *formats_ = nullptr;
+    uint32_t lastRow_ = 0;
+    uint16_t lastCol_ = 0;
+    bool ordered_ = true;
+
+    static bool
+    cellLess (const XlsxCell &lhs, const XlsxCell &rhs)
+    {
+        return lhs.row != rhs.row ? lhs.row < rhs.row : lhs.col < rhs.col;
+    }
+
+  public:
+    XlsxSheet () = default;
+    XlsxSheet (const StringArena *shared, const DateFormatCache *formats)
+        : shared_ (shared), formats_ (formats)
+    {
+    }
+
+    void
+    reserve (std::size_t cells)
+    {
+        cells_.reserve (cells);
+    }
+
+    XlsxCell &
+    append (uint32_t row, uint16_t col, uint16_t xf, XlsxValue value)
+    {
+        XlsxCell cell{ row, col, xf, value, 0, 0.0 };
+        if (!cells_.empty () && ordered_ && !cellLess (cells_.back (), cell))
+        {
+            ordered_ = false;
+        }
+        lastRow_ = std::max (lastRow_, row);
+        lastCol_ = std::max (lastCol_, col);
+        cells_.push_back (cell);
+        return cells_.back ();
+    }
+
+    StringArena &
+    inlineStrings ()
+    {
+        return inline_;
+    }
+
+    // 排序, 去重 (同一位置以后出现的为准), 建立行索引
+    void
+    finalize ()
+    {
+        if (!ordered_)
+        {
+            std::stable_sort (cells_.begin (), cells_.end (), cellLess);
+            auto out = cells_.begin ();
+            for (auto it = cells_.begin (); it != cells_.end (); ++it)
+            {
+                auto next = it + 1;
+                if (next != cells_.end () && !cellLess (*it, *next))
+                {
+                    continue;
+                }
+                *out++ = *it;
+            }
+            cells_.erase (out, cells_.end ());
+            ordered_ = true;
+        }
+        cells_.shrink_to_fit ();
+        inline_.shrink ();
+
+        rowOffsets_.assign (cells_.empty () ? 1 : std::size_t (lastRow_) + 2,
+                            0);
+        for (const auto &cell : cells_)
+        {
+            ++rowOffsets_[cell.row + 1u];
+        }
+        for (std::size_t r = 1; r < rowOffsets_.size (); ++r)
+        {
+            rowOffsets_[r] += rowOffsets_[r - 1];
+        }
+    }
+
+    void
+    clear ()
+    {
+        std::vector<XlsxCell> ().swap (cells_);
+        std::vector<uint32_t> ().swap (rowOffsets_);
+        inline_.clear ();
+        lastRow_ = 0;
+        lastCol_ = 0;
+        ordered_ = true;
+    }
+
+    [[nodiscard]] std::pair<const XlsxCell *, const XlsxCell *>
+    row (std::size_t r) const
+    {
+        if (r + 1 >= rowOffsets_.size ())
+        {
+            return {};
+        }
+        return { cells_.data () + rowOffsets_[r],
+                 cells_.data () + rowOffsets_[r + 1] };
+    }
+
+    [[nodiscard]] const XlsxCell *
+    begin () const
+    {
+        return cells_.data ();
+    }
+
+    [[nodiscard]] const XlsxCell *
+    end () const
+    {
+        return cells_.data () + cells_.size ();
+    }
+
+    [[nodiscard]] const XlsxCell *
+    find (std::size_t r, std::size_t c) const
+    {
+        auto [first, last] = row (r);
+        const auto *it = std::lower_bound (
+            first, last, c,
+            [] (const XlsxCell &cell, std::size_t col)
+            { return cell.col < col; });
+        return (it != last && it->col == c) ? it : nullptr;
+    }
+
+    [[nodiscard]] std::string_view
+    text (const XlsxCell &cell) const
+    {
+        switch (cell.value)
+        {
+        case XlsxValue::SHARED:
+            return shared_ != nullptr ? shared_->get (cell.str)
+                                      : std::string_view ();
+        case XlsxValue::INLINE:
+            return inline_.get (cell.str);
+        default:
+            return {};
+        }
+    }
+
+    [[nodiscard]] const DateFormatCache *
+    formats () const
+    {
+        return formats_;
+    }
+
+    // 工作簿的共享字符串表, SHARED 单元格的 str 为其下标
+    [[nodiscard]] const StringArena *
+    sharedStrings () const
+    {
+        return shared_;
+    }
+
+    [[nodiscard]] std::size_t
+    rowCount () const
+    {
+        return cells_.empty () ? 0 : lastRow_ + 1u;
+    }
+
+    [[nodiscard]] std::size_t
+    colCount () const
+    {
+        return cells_.empty () ? 0 : lastCol_ + 1u;
+    }
+
+    [[nodiscard]] std::size_t
+    cellCount () const
+    {
+        return cells_.size ();
+    }
+};
+
+// XLSX 单元格视图, 接口与 XlsCellView 相同, 类型在访问时计算
+class XlsxCellView
+{
+  private:
+    const XlsxCell *cell_ = nullptr;
+    const XlsxSheet *sheet_ = nullptr;
+
+    [[nodiscard]] bool
+    isText () const
+    {
+        return cell_->value == XlsxValue::SHARED
+               || cell_->value == XlsxValue::INLINE;
+    }
+
+    // 文本单元格表示的数值 (TRUE 为 1), 其它取 number
+    [[nodiscard]] double
+    number () const
+    {
+        return isText () ? labelValue (sheet_->text (*cell_)) : cell_->number;
+    }
+
+  public:
+    XlsxCellView () = default;
+    XlsxCellView (const XlsxCell *cell, const XlsxSheet *sheet)
+        : cell_ (cell), sheet_ (sheet)
+    {
+    }
+
+    [[nodiscard]] bool
+    valid () const
+    {
+        return cell_ != nullptr;
+    }
+
+    [[nodiscard]] const XlsxCell *
+    raw () const
+    {
+        return cell_;
+    }
+
+    [[nodiscard]] int
+    row () const
+    {
+        return cell_ == nullptr ? -1 : static_cast<int> (cell_->row);
+    }
+
+    [[nodiscard]] int
+    col () const
+    {
+        return cell_ == nullptr ? -1 : cell_->col;
+    }
+
+    [[nodiscard]] NumberKind
+    numberKind () const
+    {
+        if (cell_ == nullptr)
+        {
+            return NumberKind::NUMBER;
+        }
+        const auto *formats = sheet_->formats ();
+        return formats != nullptr ? formats->xfKind (cell_->xf)
+                                  : NumberKind::NUMBER;
+    }
+
+    // 与 XLS 语义一致: 错误值和空白字符串视为空白, 文本按内容推断
+    // (见 inferLabelType), 如 "123" 为 NUMBER
+    [[nodiscard]] CellType
+    type () const
+    {
+        if (cell_ == nullptr)
+        {
+            return CellType::BLANK;
+        }
+
+        switch (cell_->value)
+        {
+        case XlsxValue::NUMBER:
+        {
+            auto kind = numberKind ();
+            return (kind == NumberKind::DATE || kind == NumberKind::TIME)
+                       ? CellType::DATE
+                       : CellType::NUMBER;
+        }
+        case XlsxValue::BOOL:
+            return CellType::BOOL;
+        case XlsxValue::DATE:
+            return CellType::DATE;
+        case XlsxValue::SHARED:
+        case XlsxValue::INLINE:
+            return inferLabelType (sheet_->text (*cell_));
+        case XlsxValue::ERROR:
+            break;
+        }
+        return CellType::BLANK;
+    }
+
+    [[nodiscard]] double
+    asDouble () const
+    {
+        switch (type ())
+        {
+        case CellType::NUMBER:
+        case CellType::DATE:
+        case CellType::BOOL:
+            return number ();
+        default:
+            return 0.0;
+        }
+    }
+
+    [[nodiscard]] bool
+    asLogical () const
+    {
+        switch (type ())
+        {
+        case CellType::NUMBER:
+        case CellType::BOOL:
+            return number () != 0.0;
+        default:
+            return false;
+        }
+    }
+
+    // 文本单元格的原文, 指向字符串池; 无论推断为何种类型都返回原文,
+    // 如 "007"; 其它单元格返回空
+    [[nodiscard]] std::string_view
+    text () const
+    {
+        if (cell_ == nullptr || !isText ())
+        {
+            return {};
+        }
+        return sheet_->text (*cell_);
+    }
+};
+
+static_assert (std::is_trivially_copyable_v<XlsxCellView>,
+               "XlsxCellView must stay trivially copyable");
+
+// 行内单元格迭代器, 解引用得到 XlsxCellView
+class XlsxCellIterator
+{
+  private:
+    const XlsxCell *pos_ = nullptr;
+    const XlsxSheet *sheet_ = nullptr;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = XlsxCellView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = XlsxCellView;
+
+    XlsxCellIterator () = default;
+    XlsxCellIterator (const XlsxCell *pos, const XlsxSheet *sheet)
+        : pos_ (pos), sheet_ (sheet)
+    {
+    }
+
+    XlsxCellView
+    operator* () const
+    {
+        return XlsxCellView (pos_, sheet_);
+    }
+
+    XlsxCellView
+    operator[] (difference_type n) const
+    {
+        return XlsxCellView (pos_ + n, sheet_);
+    }
+
+    XlsxCellIterator &
+    operator++ ()
+    {
+        ++pos_;
+        return *this;
+    }
+
+    XlsxCellIterator
+    operator++ (int)
+    {
+        auto tmp = *this;
+        ++pos_;
+        return tmp;
+    }
+
+    XlsxCellIterator &
+    operator-- ()
+    {
+        --pos_;
+        return *this;
+    }
+
+    XlsxCellIterator
+    operator-- (int)
+    {
+        auto tmp = *this;
+        --pos_;
+        return tmp;
+    }
+
+    XlsxCellIterator &
+    operator+= (difference_type n)
+    {
+        pos_ += n;
+        return *this;
+    }
+
+    XlsxCellIterator &
+    operator-= (difference_type n)
+    {
+        pos_ -= n;
+        return *this;
+    }
+
+    XlsxCellIterator
+    operator+ (difference_type n) const
+    {
+        return XlsxCellIterator (pos_ + n, sheet_);
+    }
+
+    friend XlsxCellIterator
+    operator+ (difference_type n, const XlsxCellIterator &it)
+    {
+        return it + n;
+    }
+
+    XlsxCellIterator
+    operator- (difference_type n) const
+    {
+        return XlsxCellIterator (pos_ - n, sheet_);
+    }
+
+    difference_type
+    operator- (const XlsxCellIterator &other) const
+    {
+        return pos_ - other.pos_;
+    }
+
+    bool
+    operator== (const XlsxCellIterator &other) const
+    {
+        return pos_ == other.pos_;
+    }
+
+    bool
+    operator!= (const XlsxCellIterator &other) const
+    {
+        return pos_ != other.pos_;
+    }
+
+    bool
+    operator< (const XlsxCellIterator &other) const
+    {
+        return pos_ < other.pos_;
+    }
+
+    bool
+    operator<= (const XlsxCellIterator &other) const
+    {
+        return pos_ <= other.pos_;
+    }
+
+    bool
+    operator> (const XlsxCellIterator &other) const
+    {
+        return pos_ > other.pos_;
+    }
+
+    bool
+    operator>= (const XlsxCellIterator &other) const
+    {
+        return pos_ >= other.pos_;
+    }
+};
+
+// 行视图, 接口与 XlsRowView 相同
+class XlsxRowView
+{
+  private:
+    const XlsxCell *first_ = nullptr;
+    const XlsxCell *last_ = nullptr;
+    const XlsxSheet *sheet_ = nullptr;
+
+  public:
+    XlsxRowView () = default;
+    XlsxRowView (const XlsxCell *first, const XlsxCell *last,
+                 const XlsxSheet *sheet)
+        : first_ (first), last_ (last), sheet_ (sheet)
+    {
+    }
+
+    [[nodiscard]] std::size_t
+    index () const
+    {
+        return first_ == last_ ? 0 : first_->row;
+    }
+
+    [[nodiscard]] XlsxCellIterator
+    begin () const
+    {
+        return { first_, sheet_ };
+    }
+
+    [[nodiscard]] XlsxCellIterator
+    end () const
+    {
+        return { last_, sheet_ };
+    }
+
+    [[nodiscard]] std::size_t
+    size () const
+    {
+        return static_cast<std::size_t> (last_ - first_);
+    }
+
+    [[nodiscard]] bool
+    empty () const
+    {
+        return first_ == last_;
+    }
+
+    // 按列查找, 不存在时返回无效视图
+    [[nodiscard]] XlsxCellView
+    find (std::size_t col) const
+    {
+        const auto *it = std::lower_bound (
+            first_, last_, col,
+            [] (const XlsxCell &cell, std::size_t c) { return cell.col < c; });
+        return XlsxCellView ((it != last_ && it->col == col) ? it : nullptr,
+                             sheet_);
+    }
+};
+
+// 按行顺序遍历工作表中所有非空行
+class XlsxRowIterator
+{
+  private:
+    const XlsxSheet *sheet_ = nullptr;
+    const XlsxCell *pos_ = nullptr;
+    XlsxRowView row_;
+
+    void
+    load ()
+    {
+        if (pos_ == sheet_->end ())
+        {
+            row_ = XlsxRowView ();
+            return;
+        }
+        auto [first, last] = sheet_->row (pos_->row);
+        row_ = XlsxRowView (first, last, sheet_);
+    }
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = XlsxRowView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const XlsxRowView *;
+    using reference = const XlsxRowView &;
+
+    XlsxRowIterator () = default;
+    XlsxRowIterator (const XlsxSheet *sheet, const XlsxCell *pos)
+        : sheet_ (sheet), pos_ (pos)
+    {
+        load ();
+    }
+
+    reference
+    operator* () const
+    {
+        return row_;
+    }
+
+    pointer
+    operator->() const
+    {
+        return &row_;
+    }
+
+    XlsxRowIterator &
+    operator++ ()
+    {
+        pos_ += row_.size ();
+        load ();
+        return *this;
+    }
+
+    XlsxRowIterator
+    operator++ (int)
+    {
+        auto tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool
+    operator== (const XlsxRowIterator &other) const
+    {
+        return pos_ == other.pos_;
+    }
+
+    bool
+    operator!= (const XlsxRowIterator &other) const
+    {
+        return pos_ != other.pos_;
+    }
+};
+
+class XlsxSheetRows
+{
+  private:
+    const XlsxSheet *sheet_;
+
+  public:
+    explicit XlsxSheetRows (const XlsxSheet &sheet) : sheet_ (&sheet) {}
+
+    [[nodiscard]] XlsxRowIterator
+    begin () const
+    {
+        return { sheet_, sheet_->begin () };
+    }
+
+    [[nodiscard]] XlsxRowIterator
+    end () const
+    {
+        return { sheet_, sheet_->end () };
+    }
+};
+
+// 对每个非空行调用 fn(const XlsxRowView &), 与 XLS 的 forEachRow 相同
+// fn 返回 bool 时, 返回 false 提前结束遍历
+template <typename Fn>
+void
+forEachRow (const XlsxSheet &sheet, Fn &&fn)
+{
+    for (const auto &row : XlsxSheetRows (sheet))
+    {
+        if constexpr (std::is_same_v<
+                          std::invoke_result_t<Fn &, const XlsxRowView &>,
+                          bool>)
+        {
+            if (!fn (row))
+            {
+                return;
+            }
+        }
+        else
+        {
+            fn (row);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef XLSXSTRATEGY_H
+#define XLSXSTRATEGY_H
+
+#include "ColumnBuffer.h"
+#include "Exceptions.h"
+#include "XlsxSheet.h"
+#include "XlsxWorkbook.h"
+#include "strategy.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// 基于内置 XLSX 解析器的读取 (见 XlsxParser.h)
+// 共享字符串在打开时解压到一个连续的字符串池; 工作表在第一次访问时
+// 解压并扫描 <c r= s= t=><v>, 单元格保存在稀疏存储中
+class XLSXReadStrategy : public ReadStrategy
+{
+  private:
+    XlsxWorkbook workbook_;
+    std::vector<XlsxSheet> sheets_;
+    std::vector<bool> parsedSheets_;
+
+    void
+    checkIndex (std::size_t pos) const
+    {
+        if (pos >= workbook_.sheetCount ())
+        {
+            throw ExcelReader::IndexOutException (
+                "sheets[" + std::to_string (pos) + "]");
+        }
+    }
+
+    const XlsxSheet &
+    parsedSheet (std::size_t pos)
+    {
+        checkIndex (pos);
+        if (!parsedSheets_[pos])
+        {
+            workbook_.readSheet (pos, sheets_[pos]);
+            parsedSheets_[pos] = true;
+        }
+        return sheets_[pos];
+    }
+
+    template <typename Out, typename Convert>
+    void
+    readCellsAs (std::size_t pos, Span<const CellPosition> cells,
+                 Span<Out> out, Convert convert)
+    {
+        batch::checkRequest (cells, out);
+        const auto &sheet = parsedSheet (pos);
+        batch::forEachRow (
+            cells,
+            [&] (std::size_t row, const uint32_t *first, const uint32_t *last)
+            {
+                auto [cursor, end] = sheet.row (row);
+                for (; first != last; ++first)
+                {
+                    out[*first] = convert (XlsxCellView (
+                        batch::advanceTo (cursor, end, cells[*first].col),
+                        &sheet));
+                }
+            });
+    }
+
+  public:
+    explicit XLSXReadStrategy (const fs::path &path,
+                               OpenMode mode = OpenMode::STREAM)
+        : workbook_ (path, mode)
+    {
+        sheets_.resize (workbook_.sheetCount ());
+        parsedSheets_.assign (workbook_.sheetCount (), false);
+    }
+
+    // data 在本对象析构前必须有效
+    explicit XLSXReadStrategy (Span<const std::byte> data) : workbook_ (data)
+    {
+        sheets_.resize (workbook_.sheetCount ());
+        parsedSheets_.assign (workbook_.sheetCount (), false);
+    }
+
+    ~XLSXReadStrategy () override = default;
+
+    CellType
+    readCell (const std::size_t pos, const std::size_t row,
+              const std::size_t col) override
+    {
+        const auto &sheet = parsedSheet (pos);
+        return XlsxCellView (sheet.find (row, col), &sheet).type ();
+    }
+
+    CellType
+    readCell (const std::size_t pos, const std::string &addr) override
+    {
+        return readCell (pos, CellPosition (addr));
+    }
+
+    CellType
+    readCell (const std::size_t pos, const CellPosition &cpos) override
+    {
+        if (!cpos.valid ())
+        {
+            throw ExcelReader::ParseAddrException ("empty position");
+        }
+        return readCell (pos, cpos.row, cpos.col);
+    }
+
+    // 批量读取单元格视图, 第 i 个位置写入 out[i], 不存在的单元格为空视图
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<XlsxCellView> out)
+    {
+        readCellsAs (pos, cells, out,
+                     [] (const XlsxCellView &view) { return view; });
+    }
+
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<CellType> out) override
+    {
+        readCellsAs (pos, cells, out,
+                     [] (const XlsxCellView &view) { return view.type (); });
+    }
+
+    // 读取区域内的全部单元格, 行优先的稠密块, 见 XLSReadStrategy::readRange
+    CellBlock<XlsxCellView>
+    readRange (std::size_t pos, const CellRange &range)
+    {
+        const auto &sheet = parsedSheet (pos);
+        return batch::fillRange<XlsxCellView> (
+            range.clamp (sheet.rowCount (), sheet.colCount ()),
+            [&sheet] (std::size_t row) { return sheet.row (row); },
+            [&sheet] (const XlsxCell *cell)
+            { return XlsxCellView (cell, &sheet); });
+    }
+
+    CellBlock<XlsxCellView>
+    readRange (std::size_t pos, std::string_view range)
+    {
+        return readRange (pos, parseRange (range));
+    }
+
+    // 按列导出, 见 ::readColumns; 字典编码时字典只含本表用到的字符串
+    SheetColumns
+    readColumns (std::size_t pos, std::size_t skipRows = 0,
+                 StringEncoding encoding = StringEncoding::PLAIN)
+    {
+        return ::readColumns (parsedSheet (pos), date1904 (), skipRows,
+                              encoding);
+    }
+
+    const XlsxSheet &
+    sheet (std::size_t pos)
+    {
+        return parsedSheet (pos);
+    }
+
+    const DateFormatCache &
+    dateFormats () const
+    {
+        return workbook_.dateFormats ();
+    }
+
+    bool
+    date1904 () const
+    {
+        return workbook_.date1904 ();
+    }
+
+    bool
+    isSheetParsed (std::size_t pos) const
+    {
+        checkIndex (pos);
+        return parsedSheets_[pos];
+    }
+
+    // 释放已解析工作表的内存, 再次访问时重新解析
+    // 之前取得的行视图随之失效
+    void
+    releaseSheet (std::size_t pos)
+    {
+        checkIndex (pos);
+        sheets_[pos].clear ();
+        parsedSheets_[pos] = false;
+    }
+
+    [[nodiscard]] std::size_t
+    sheetCount () const
+    {
+        return workbook_.sheetCount ();
+    }
+
+    std::string
+    getSheetName (std::size_t pos) const
+    {
+        checkIndex (pos);
+        return workbook_.sheetName (pos);
+    }
+};
+
+#endif
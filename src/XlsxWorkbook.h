@@ -0,0 +1,315 @@
+#ifndef XLSXWORKBOOK_H
+#define XLSXWORKBOOK_H
+
+#include "DateFormatCache.h"
+#include "Exceptions.h"
+#include "MappedFile.h"
+#include "XlsxParser.h"
+#include "XlsxSheet.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "miniz.h"
+
+namespace fs = std::filesystem;
+
+// XLSX 压缩包 (只读), 按部件名解压到内存
+// STREAM 由 miniz 通过 FILE* 读取; MAPPED 和内存打开时 miniz 直接读
+// input_ 中的数据, 不复制
+class XlsxArchive
+{
+  private:
+    InputBuffer input_;
+    mz_zip_archive zip_{};
+    std::vector<char> chunk_;
+
+    void
+    openMemory (const std::string &source)
+    {
+        if (mz_zip_reader_init_mem (&zip_, input_.data (), input_.size (), 0)
+            == MZ_FALSE)
+        {
+            throw ExcelReader::FailedOpenException (source);
+        }
+    }
+
+  public:
+    explicit XlsxArchive (const fs::path &path,
+                          OpenMode mode = OpenMode::STREAM)
+    {
+        if (mode == OpenMode::MAPPED)
+        {
+            input_ = InputBuffer (path);
+            openMemory (path.string ());
+            return;
+        }
+        if (mz_zip_reader_init_file (&zip_, path.string ().c_str (), 0)
+            == MZ_FALSE)
+        {
+            throw ExcelReader::FailedOpenException (path.string ());
+        }
+    }
+
+    // data 在本对象析构前必须有效
+    explicit XlsxArchive (Span<const std::byte> data) : input_ (data)
+    {
+        openMemory ("<memory>");
+    }
+
+    XlsxArchive (const XlsxArchive &) = delete;
+    XlsxArchive &operator= (const XlsxArchive &) = delete;
+
+    ~XlsxArchive () { mz_zip_reader_end (&zip_); }
+
+    // 部件解压后的预计大小, 只用于预留容量
+    // 目录中记录的大小不可信, 以压缩后大小的 MaxRatio 倍为上限
+    [[nodiscard]] std::size_t
+    sizeHint (const std::string &name)
+    {
+        constexpr mz_uint64 MaxRatio = 64;
+        const int index
+            = mz_zip_reader_locate_file (&zip_, name.c_str (), nullptr, 0);
+        mz_zip_archive_file_stat stat;
+        if (index < 0
+            || mz_zip_reader_file_stat (&zip_, static_cast<mz_uint> (index),
+                                        &stat)
+                   == MZ_FALSE)
+        {
+            return 0;
+        }
+        return static_cast<std::size_t> (
+            std::min (stat.m_uncomp_size, stat.m_comp_size * MaxRatio));
+    }
+
+    // 按块解压部件 name, 每块依次交给 fn(std::string_view), fn 返回
+    // false 时提前结束; 内存只用于一个数据块, 不按目录中的大小分配
+    // 部件不存在或数据损坏 (含 CRC 不符) 时返回 false
+    template <typename Fn>
+    bool
+    readChunks (const std::string &name, Fn &&fn)
+    {
+        constexpr std::size_t ChunkSize = 64 * 1024;
+        auto *iter = mz_zip_reader_extract_file_iter_new (&zip_, name.c_str (),
+                                                          0);
+        if (iter == nullptr)
+        {
+            return false;
+        }
+        chunk_.resize (ChunkSize);
+        bool complete = true;
+        for (;;)
+        {
+            const std::size_t n = mz_zip_reader_extract_iter_read (
+                iter, chunk_.data (), chunk_.size ());
+            if (n == 0)
+            {
+                break;
+            }
+            if (!fn (std::string_view (chunk_.data (), n)))
+            {
+                complete = false;
+                break;
+            }
+        }
+        // 提前结束时没有读完, 不检查 CRC
+        return mz_zip_reader_extract_iter_free (iter) != MZ_FALSE
+               || !complete;
+    }
+
+    // 解压部件 name 到 out, 部件不存在或数据损坏时返回 false
+    bool
+    read (const std::string &name, std::string &out)
+    {
+        out.clear ();
+        out.reserve (sizeHint (name));
+        return readChunks (name,
+                           [&out] (std::string_view chunk)
+                           {
+                               out.append (chunk);
+                               return true;
+                           });
+    }
+};
+
+// 打开时读取工作簿结构, 样式和共享字符串; 工作表按需解析
+// 工作表引用本对象中的共享字符串和格式表, 因此本对象不可移动
+class XlsxWorkbook
+{
+  private:
+    XlsxArchive archive_;
+    std::vector<std::string> names_;
+    std::vector<std::string> parts_;
+    StringArena sharedStrings_;
+    DateFormatCache formats_;
+    bool date1904_ = false;
+
+    // 关系的 Target 相对于源部件所在目录, 以 '/' 开头时相对于包根目录
+    static std::string
+    resolve (std::string_view dir, std::string_view target)
+    {
+        if (!target.empty () && target.front () == '/')
+        {
+            return std::string (target.substr (1));
+        }
+        while (target.substr (0, 3) == "../" && !dir.empty ())
+        {
+            target.remove_prefix (3);
+            dir.remove_suffix (1);
+            const auto slash = dir.rfind ('/');
+            dir = slash == std::string_view::npos ? std::string_view ()
+                                                  : dir.substr (0, slash + 1);
+        }
+        return std::string (dir) + std::string (target);
+    }
+
+    // 部件 part 的关系文件, 如 xl/workbook.xml -> xl/_rels/workbook.xml.rels
+    std::vector<xlsx::Relationship>
+    relationships (const std::string &part)
+    {
+        const auto slash = part.rfind ('/');
+        const std::string dir
+            = slash == std::string::npos ? "" : part.substr (0, slash + 1);
+        std::string xml;
+        if (!archive_.read (dir + "_rels/" + part.substr (dir.size ())
+                                + ".rels",
+                            xml))
+        {
+            return {};
+        }
+        return xlsx::parseRelationships (xml);
+    }
+
+    // source 只用于异常信息
+    void
+    load (const std::string &source)
+    {
+        std::string workbookPart = "xl/workbook.xml";
+        const auto packageRels = relationships ("");
+        if (const auto *rel
+            = xlsx::findRelationship (packageRels, "/officeDocument"))
+        {
+            workbookPart = resolve ("", rel->target);
+        }
+
+        std::string xml;
+        if (!archive_.read (workbookPart, xml))
+        {
+            throw ExcelReader::FailedOpenException (source);
+        }
+        auto info = xlsx::parseWorkbook (xml);
+        date1904_ = info.date1904;
+
+        const auto slash = workbookPart.rfind ('/');
+        const std::string dir = slash == std::string::npos
+                                    ? ""
+                                    : workbookPart.substr (0, slash + 1);
+        const auto rels = relationships (workbookPart);
+        for (auto &sheet : info.sheets)
+        {
+            for (const auto &rel : rels)
+            {
+                if (rel.id == sheet.relId)
+                {
+                    names_.push_back (std::move (sheet.name));
+                    parts_.push_back (resolve (dir, rel.target));
+                    break;
+                }
+            }
+        }
+
+        if (const auto *rel = xlsx::findRelationship (rels, "/styles");
+            rel != nullptr && archive_.read (resolve (dir, rel->target), xml))
+        {
+            xlsx::parseStyles (xml, formats_);
+        }
+        if (const auto *rel = xlsx::findRelationship (rels, "/sharedStrings");
+            rel != nullptr && archive_.read (resolve (dir, rel->target), xml))
+        {
+            xlsx::parseSharedStrings (xml, sharedStrings_);
+        }
+    }
+
+  public:
+    explicit XlsxWorkbook (const fs::path &path,
+                           OpenMode mode = OpenMode::STREAM)
+        : archive_ (path, mode)
+    {
+        load (path.string ());
+    }
+
+    // 从内存打开, data 在本对象析构前必须有效
+    explicit XlsxWorkbook (Span<const std::byte> data) : archive_ (data)
+    {
+        load ("<memory>");
+    }
+
+    XlsxWorkbook (const XlsxWorkbook &) = delete;
+    XlsxWorkbook &operator= (const XlsxWorkbook &) = delete;
+
+    XlsxArchive &
+    archive ()
+    {
+        return archive_;
+    }
+
+    [[nodiscard]] std::size_t
+    sheetCount () const
+    {
+        return names_.size ();
+    }
+
+    [[nodiscard]] const std::string &
+    sheetName (std::size_t pos) const
+    {
+        return names_[pos];
+    }
+
+    // 工作表在包内的部件名, 如 xl/worksheets/sheet1.xml
+    [[nodiscard]] const std::string &
+    sheetPart (std::size_t pos) const
+    {
+        return parts_[pos];
+    }
+
+    [[nodiscard]] const StringArena &
+    sharedStrings () const
+    {
+        return sharedStrings_;
+    }
+
+    [[nodiscard]] const DateFormatCache &
+    dateFormats () const
+    {
+        return formats_;
+    }
+
+    [[nodiscard]] bool
+    date1904 () const
+    {
+        return date1904_;
+    }
+
+    // 解压并解析第 pos 张工作表, 替换 out 原有的内容
+    void
+    readSheet (std::size_t pos, XlsxSheet &out)
+    {
+        // 边解压边解析, 不在内存中保留整个工作表 XML
+        out = XlsxSheet (&sharedStrings_, &formats_);
+        xlsx::SheetStream stream (out, archive_.sizeHint (parts_[pos]),
+                                  date1904_);
+        if (!archive_.readChunks (parts_[pos],
+                                  [&stream] (std::string_view chunk)
+                                  { return stream.feed (chunk); }))
+        {
+            throw ExcelReader::ParseSheetException (names_[pos]);
+        }
+        stream.finish ();
+    }
+};
+
+#endif
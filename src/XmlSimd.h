@@ -0,0 +1,251 @@
+#ifndef XMLSIMD_H
+#define XMLSIMD_H
+
+#include "NumberParse.h"
+#include "SimdLevel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// XLSX 扫描器的分类内核: 标量 / SSE2 / AVX2, 运行时按 CPU 选择
+// 每次把 64 字节分类为三个位图, 扫描器之后的查找只做位运算,
+// 每 64 字节只有一次间接调用
+namespace xmlsimd
+{
+
+using simd::detect;
+using simd::Level;
+using simd::levelName;
+using simd::lowestBit;
+
+// 64 字节块的分类结果, 第 i 位对应 base[i]
+//   lt      '<'
+//   tagEnd  '>', '"', '\''
+//   quote   '"', '\''
+struct BlockMasks
+{
+    uint64_t lt = 0;
+    uint64_t tagEnd = 0;
+    uint64_t quote = 0;
+};
+
+struct Kernels
+{
+    Level level;
+    // 分类 p 开始的完整 64 字节
+    void (*classify) (const char *p, BlockMasks &out);
+};
+
+namespace detail
+{
+
+// 分类 p 开始的 n 字节 (n <= 64), 其余位为 0
+inline void
+classifyTail (const char *p, std::size_t n, BlockMasks &out)
+{
+    out = BlockMasks ();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const uint64_t bit = uint64_t (1) << i;
+        switch (p[i])
+        {
+        case '<':
+            out.lt |= bit;
+            break;
+        case '>':
+            out.tagEnd |= bit;
+            break;
+        case '"':
+        case '\'':
+            out.tagEnd |= bit;
+            out.quote |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+inline void
+classifyScalar (const char *p, BlockMasks &out)
+{
+    classifyTail (p, 64, out);
+}
+
+#if SIMD_X86
+
+inline void
+classifySse2 (const char *p, BlockMasks &out)
+{
+    const __m128i lt = _mm_set1_epi8 ('<');
+    const __m128i gt = _mm_set1_epi8 ('>');
+    const __m128i dq = _mm_set1_epi8 ('"');
+    const __m128i sq = _mm_set1_epi8 ('\'');
+    out = BlockMasks ();
+    for (int i = 0; i < 4; ++i)
+    {
+        const __m128i block
+            = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (p + 16 * i));
+        const __m128i quote = _mm_or_si128 (_mm_cmpeq_epi8 (block, dq),
+                                            _mm_cmpeq_epi8 (block, sq));
+        const __m128i tagEnd
+            = _mm_or_si128 (quote, _mm_cmpeq_epi8 (block, gt));
+        const int shift = 16 * i;
+        out.lt |= uint64_t (uint16_t (
+                      _mm_movemask_epi8 (_mm_cmpeq_epi8 (block, lt))))
+                  << shift;
+        out.tagEnd |= uint64_t (uint16_t (_mm_movemask_epi8 (tagEnd)))
+                      << shift;
+        out.quote |= uint64_t (uint16_t (_mm_movemask_epi8 (quote)))
+                     << shift;
+    }
+}
+
+__attribute__ ((target ("avx2"))) inline void
+classifyAvx2 (const char *p, BlockMasks &out)
+{
+    const __m256i lt = _mm256_set1_epi8 ('<');
+    const __m256i gt = _mm256_set1_epi8 ('>');
+    const __m256i dq = _mm256_set1_epi8 ('"');
+    const __m256i sq = _mm256_set1_epi8 ('\'');
+    out = BlockMasks ();
+    for (int i = 0; i < 2; ++i)
+    {
+        const __m256i block = _mm256_loadu_si256 (
+            reinterpret_cast<const __m256i *> (p + 32 * i));
+        const __m256i quote = _mm256_or_si256 (_mm256_cmpeq_epi8 (block, dq),
+                                               _mm256_cmpeq_epi8 (block, sq));
+        const __m256i tagEnd
+            = _mm256_or_si256 (quote, _mm256_cmpeq_epi8 (block, gt));
+        const int shift = 32 * i;
+        out.lt |= uint64_t (uint32_t (
+                      _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (block, lt))))
+                  << shift;
+        out.tagEnd |= uint64_t (uint32_t (_mm256_movemask_epi8 (tagEnd)))
+                      << shift;
+        out.quote |= uint64_t (uint32_t (_mm256_movemask_epi8 (quote)))
+                     << shift;
+    }
+}
+
+#endif // SIMD_X86
+
+} // namespace detail
+
+// 指定级别的内核; 超出 CPU 支持范围时降级
+inline const Kernels &
+kernels (Level level)
+{
+    static const Kernels scalar{ Level::SCALAR, detail::classifyScalar };
+#if SIMD_X86
+    static const Kernels sse2{ Level::SSE2, detail::classifySse2 };
+    static const Kernels avx2{ Level::AVX2, detail::classifyAvx2 };
+    static const Level best = detect ();
+    if (level > best)
+    {
+        level = best;
+    }
+    switch (level)
+    {
+    case Level::AVX2:
+        return avx2;
+    case Level::SSE2:
+        return sse2;
+    default:
+        break;
+    }
+#else
+    (void)level;
+#endif
+    return scalar;
+}
+
+namespace detail
+{
+
+inline const Kernels *&
+activeSlot ()
+{
+    static const Kernels *active = &kernels (detect ());
+    return active;
+}
+
+} // namespace detail
+
+// 扫描器默认使用的内核, 首次调用时按 CPU 选择
+inline const Kernels &
+active ()
+{
+    return *detail::activeSlot ();
+}
+
+// 切换默认内核 (性能对比和测试用), 返回实际使用的级别
+// 不能与正在进行的解析并发调用
+inline Level
+setActive (Level level)
+{
+    detail::activeSlot () = &kernels (level);
+    return active ().level;
+}
+
+// 按位图查找的游标, 位图按需逐块计算
+// 查找位置通常单调前进, 回退到当前块之前时重新分类
+class BlockCursor
+{
+  private:
+    const char *end_;
+    const Kernels *kernels_;
+    const char *base_ = nullptr;
+    std::size_t size_ = 0;
+    BlockMasks masks_;
+
+    void
+    load (const char *from)
+    {
+        base_ = from;
+        size_ = static_cast<std::size_t> (end_ - from);
+        if (size_ >= 64)
+        {
+            size_ = 64;
+            kernels_->classify (from, masks_);
+        }
+        else
+        {
+            detail::classifyTail (from, size_, masks_);
+        }
+    }
+
+  public:
+    BlockCursor (const char *end, const Kernels &kernels)
+        : end_ (end), kernels_ (&kernels)
+    {
+    }
+
+    // [from, end) 中 mask 对应的第一个字符, 不存在时返回 end
+    const char *
+    find (const char *from, uint64_t BlockMasks::*mask)
+    {
+        while (from < end_)
+        {
+            if (from < base_ || from >= base_ + size_)
+            {
+                load (from);
+            }
+            const auto offset = static_cast<unsigned> (from - base_);
+            const uint64_t bits = (masks_.*mask) >> offset;
+            if (bits != 0)
+            {
+                return from + lowestBit (bits);
+            }
+            from = base_ + size_;
+        }
+        return end_;
+    }
+};
+
+using numparse::parseDigits;
+
+} // namespace xmlsimd
+
+#endif
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "ArrowExport.h"
+#include "ColumnBuffer.h"
 #include "Exceptions.h"
+#include "MappedFile.h"
 #include "ResourceManager.h"
+#include "RowView.h"
 #include "strategy.h"
 
 #include <filesystem>
@@ -24,26 +28,65 @@ class XLSReader : public TableReader
 {
 private:
     ResourceManager<xls::xlsWorkBook> m_resourceManager;
+    // 工作簿直接读 input_ 中的数据, 必须在 m_strategy 之后析构
+    InputBuffer input_;
     std::unique_ptr<XLSReadStrategy> m_strategy;
     fs::path path_;
     std::size_t sheetCounts_;
+    ParseMode mode_;
+    OpenMode openMode_ = OpenMode::STREAM;
+    bool fromMemory_ = false;
 
 public:
-    explicit XLSReader (const fs::path& p)
-        : path_ (p) {};
+    // mode: ParseMode::VALUES_ONLY 时数值单元格只保存值, 不生成 libxls 的
+    // 显示文本; 通过本类读取的结果不变, 见 ParseMode
+    // openMode: MAPPED 时整个文件只读映射, 由 xls_open_buffer 读取,
+    // 不再经过 FILE* 按扇区 fseek / fread
+    explicit XLSReader (const fs::path& p, ParseMode mode = ParseMode::FULL,
+                        OpenMode openMode = OpenMode::STREAM)
+        : path_ (p), mode_ (mode), openMode_ (openMode) {};
 
-    explicit XLSReader (const std::string& p)
-        : path_ (fs::path (p))
+    explicit XLSReader (const std::string& p,
+                        ParseMode mode = ParseMode::FULL,
+                        OpenMode openMode = OpenMode::STREAM)
+        : path_ (fs::path (p)), mode_ (mode), openMode_ (openMode)
     {
         if (!isValide (path_))
             throw ExcelReader::FileNotFoundException (path_.string ());
     };
 
+    // 从内存读取, 如对象存储缓存或上传内容, 不复制也不访问磁盘
+    // data 在本对象析构前必须有效
+    explicit XLSReader (Span<const std::byte> data,
+                        ParseMode mode = ParseMode::FULL)
+        : input_ (data), mode_ (mode), openMode_ (OpenMode::MAPPED),
+          fromMemory_ (true) {};
+
     bool
     open () override
     {
-        auto wb = std::unique_ptr<xls::xlsWorkBook> (
-            xls::xls_open (path_.string ().c_str (), "UTF-8"));
+        XLSWorkBook wb (nullptr, xlsDeleter);
+        InputBuffer mapped;
+        if (openMode_ == OpenMode::STREAM)
+            wb.reset (xls::xls_open (path_.string ().c_str (), "UTF-8"));
+        else
+            {
+                if (!fromMemory_)
+                    {
+                        try
+                            {
+                                mapped = InputBuffer (path_);
+                            }
+                        catch (const ExcelReader::FailedOpenException&)
+                            {
+                                this->sheetCounts_ = 0;
+                                return false;
+                            }
+                    }
+                const auto& input = fromMemory_ ? input_ : mapped;
+                wb.reset (xls::xls_open_buffer (input.bytes (), input.size (),
+                                                "UTF-8", nullptr));
+            }
 
         if (!wb)
             {
@@ -52,7 +95,11 @@ public:
             }
 
         this->sheetCounts_ = wb.get ()->sheets.count;
-        m_strategy = std::make_unique<XLSReadStrategy> (path_, std::move (wb));
+        // 先替换 (释放) 旧的工作簿, 再替换它读取的映射
+        m_strategy = std::make_unique<XLSReadStrategy> (path_, std::move (wb),
+                                                        mode_);
+        if (!fromMemory_)
+            input_ = std::move (mapped);
         return true;
     };
 
@@ -67,4 +114,101 @@ public:
     {
         return sheetCounts_;
     }
+
+    // 用 threads 个线程并行解析全部工作表, 线程安全约定见
+    // XLSReadStrategy::parseAllSheets
+    void
+    parseAllSheets (std::size_t threads = defaultThreadCount ())
+    {
+        m_strategy->parseAllSheets (threads);
+    }
+
+    bool
+    isSheetParsed (std::size_t index) const
+    {
+        return m_strategy->isSheetParsed (index);
+    }
+
+    // 释放工作表解析结果, 用完的大表可以及时归还内存
+    void
+    releaseSheet (std::size_t index)
+    {
+        m_strategy->releaseSheet (index);
+    }
+
+    // 批量读取, 第 i 个位置的结果写入 out[i], 见 XLSReadStrategy::readCells
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<XlsCellView> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    void
+    readCells (std::size_t index, Span<const CellPosition> cells,
+               Span<CellType> out)
+    {
+        m_strategy->readCells (index, cells, out);
+    }
+
+    // 读取区域, 如 "A1:Z100", "C:C", "3:5"; 行优先的稠密块
+    CellBlock<XlsCellView>
+    readRange (std::size_t index, std::string_view range)
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    CellBlock<XlsCellView>
+    readRange (std::size_t index, const CellRange& range)
+    {
+        return m_strategy->readRange (index, range);
+    }
+
+    // 按行顺序遍历, 行视图借用解析后的单元格, 不构造 XlsCell
+    XlsSheetRows
+    rows (std::size_t index)
+    {
+        return XlsSheetRows (m_strategy->sheet (index),
+                             &m_strategy->dateFormats ());
+    }
+
+    // 按列导出整张工作表, 每列是类型化的连续缓冲区, 见 ColumnBuffer
+    // skipRows 为跳过的表头行数
+    // DICTIONARY: 字符串列为 SST 驻留后的编码和字典
+    SheetColumns
+    readColumns (std::size_t index, std::size_t skipRows = 0,
+                 StringEncoding encoding = StringEncoding::PLAIN)
+    {
+        return ::readColumns (m_strategy->sheet (index),
+                              &m_strategy->dateFormats (),
+                              m_strategy->date1904 (), skipRows, encoding);
+    }
+
+    // 导出为 Arrow C Data Interface 结构体数组, 由调用方负责 release
+    // header 为 true 时第一行作为列名 (取单元格的 displayText), 不参与导出
+    // DICTIONARY: 字符串列导出为 dictionary<uint32, large_utf8>
+    void
+    exportArrow (std::size_t index, ArrowSchema* schema, ArrowArray* array,
+                 bool header = false,
+                 StringEncoding encoding = StringEncoding::PLAIN)
+    {
+        std::vector<std::string> names;
+        if (header)
+            {
+                const auto& sheet = m_strategy->sheet (index);
+                names.resize (sheet.colCount ());
+                for (auto cell : XlsRowView (sheet.row (0)))
+                    names[ cell.col () ] = cell.displayText ();
+            }
+        ::exportArrow (readColumns (index, header ? 1 : 0, encoding), names,
+                       schema, array);
+    }
+
+    template <typename Fn>
+    void
+    forEachRow (std::size_t index, Fn&& fn)
+    {
+        ::forEachRow (m_strategy->sheet (index), std::forward<Fn> (fn),
+                      &m_strategy->dateFormats ());
+    }
 };
@@ -1,9 +1,20 @@
+#pragma once
+
+#include "BatchRead.h"
+#include "DateFormatCache.h"
 #include "Exceptions.h"
+#include "Parallel.h"
+#include "SheetParser.h"
+#include "Span.h"
+#include "SparseSheet.h"
+#include "XlsCellView.h"
 #include "type.h"
 #include "utils.h"
 
 #include <filesystem>
 #include <memory>
+#include <string_view>
+#include <utility>
 extern "C"
 {
 #include "xls.h"
@@ -24,136 +35,268 @@ public:
 
     virtual CellType readCell (const std::size_t pos,
                                const CellPosition& cpos) = 0;
+
+    // 批量读取, 第 i 个位置的类型写入 out[i]; 按行排序后一次遍历工作表
+    virtual void readCells (const std::size_t pos,
+                            Span<const CellPosition> cells,
+                            Span<CellType> out) = 0;
 };
 
 class XLSReadStrategy : public ReadStrategy
 {
 private:
+    XLSWorkBook workbook_;
     XLSheets sheets_;
+    std::vector<SparseSheet> cells_;
     std::vector<bool> parsedSheets_;
     XLSheetsName names_;
+    DateFormatCache formats_;
+    ParseMode mode_;
 
-public:
-    explicit XLSReadStrategy (const fs::path& path,
-                              std::unique_ptr<xls::xlsWorkBook> workbook_)
+    void
+    checkIndex (std::size_t pos) const
     {
-        auto err = xls::LIBXLS_OK;
+        if (pos >= names_.size ())
+            throw ExcelReader::IndexOutException ("sheets["
+                                                  + std::to_string (pos) + "]");
+    }
 
-        if (!workbook_)
-            throw ExcelReader::FailedOpenException (path.string ());
+    // 工作表句柄在第一次访问时才创建并解析
+    // 单元格只保存在稀疏存储中, 不调用 xls_parseWorkSheet 建立稠密表
+    const SparseSheet&
+    parsedSheet (std::size_t pos)
+    {
+        checkIndex (pos);
 
-        for (std::size_t i = 0; i < workbook_.get ()->sheets.count; ++i)
+        if (!parsedSheets_[ pos ])
             {
-                auto sheet = xls::xls_getWorkSheet (workbook_.get (), i);
-                sheets_.push_back (sheet);
-                names_[ i ] = workbook_.get ()->sheets.sheet[ i ].name;
-                parsedSheets_[ i ] = false;
+                if (parseSparseSheet (sheetHandle (pos), cells_[ pos ], mode_)
+                    != xls::LIBXLS_OK)
+                    throw ExcelReader::ParseSheetException (names_[ pos ]);
+                parsedSheets_[ pos ] = true;
             }
+        return cells_[ pos ];
+    }
+
+    xls::xlsWorkSheet*
+    sheetHandle (std::size_t pos)
+    {
+        if (sheets_[ pos ] == nullptr)
+            sheets_[ pos ] = xls::xls_getWorkSheet (workbook_.get (), int (pos));
+        return sheets_[ pos ];
+    }
+
+    template <typename Out, typename Convert>
+    void
+    readCellsAs (std::size_t pos, Span<const CellPosition> cells,
+                 Span<Out> out, Convert convert)
+    {
+        batch::checkRequest (cells, out);
+        const auto& sheet = parsedSheet (pos);
+        batch::forEachRow (
+            cells,
+            [&] (std::size_t row, const uint32_t* first, const uint32_t* last)
+            {
+                const auto cellsInRow = sheet.row (row);
+                const xls::xlsCell* cursor = cellsInRow.first;
+                for (; first != last; ++first)
+                    out[ *first ] = convert (XlsCellView (
+                        batch::advanceTo (cursor, cellsInRow.last,
+                                          cells[ *first ].col),
+                        &formats_));
+            });
+    }
+
+public:
+    // mode 为 ParseMode::VALUES_ONLY 时数值单元格不生成文本, 见 ParseMode
+    explicit XLSReadStrategy (const fs::path& path, XLSWorkBook workbook,
+                              ParseMode mode = ParseMode::FULL)
+        : workbook_ (std::move (workbook)), mode_ (mode)
+    {
+        if (!workbook_)
+            throw ExcelReader::FailedOpenException (path.string ());
+
+        const std::size_t count = workbook_->sheets.count;
+        sheets_.assign (count, nullptr);
+        cells_.resize (count);
+        parsedSheets_.assign (count, false);
+        for (std::size_t i = 0; i < count; ++i)
+            names_.emplace_back (workbook_->sheets.sheet[ i ].name);
+        formats_ = DateFormatCache (workbook_.get ());
     }
 
-    ~XLSReadStrategy () override = default;
+    ~XLSReadStrategy () override
+    {
+        for (auto* sheet : sheets_)
+            xls::xls_close_WS (sheet);
+    }
 
     CellType
     readCell (const std::size_t pos, const std::size_t row,
               const std::size_t col) override
     {
-        if (pos > names_.size ())
-            throw ExcelReader::IndexOutException ("sheets["
-                                                  + std::to_string (pos) + "]");
-
-        if (!parsedSheets_[ pos ])
-            {
-                auto sheet = sheets_[ pos ];
-                xls::xls_parseWorkSheet (sheet);
-                parsedSheets_[ pos ] = true;
-            }
-
-        auto xls_cell = xls::xls_cell (sheets_[ pos ], row, col);
-        auto c = XlsCell (xls_cell);
-        return c.type ();
+        // 不存在的单元格视为空白; 视图不复制单元格, 无堆分配
+        return XlsCellView (parsedSheet (pos).find (row, col), &formats_)
+            .type ();
     }
 
     CellType
     readCell (std::size_t pos, const std::string& addr) override
     {
+        // parseAddress 返回的行列从 1 开始
         auto loc = parseAddress (addr);
-        return readCell (pos, loc.first, loc.second);
+        return readCell (pos, loc.first - 1, loc.second - 1);
     }
 
     CellType
     readCell (std::size_t pos, const CellPosition& cpos) override
     {
-        if (!cpos.addr.empty ())
+        if (cpos.valid ())
             {
-                return readCell (pos, cpos.addr);
+                return readCell (pos, cpos.row, cpos.col);
             }
-        return readCell (pos, cpos.row, cpos.col);
+        throw ExcelReader::ParseAddrException ("empty position");
     }
 
-    std::string
-    getSheetName (std::size_t pos) const
+    // 批量读取单元格视图, 第 i 个位置写入 out[i], 不存在的单元格为空视图
+    // 工作表只定位一次, 请求按行排序后逐行与单元格归并, 见 BatchRead.h
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<XlsCellView> out)
     {
-        if (pos >= names_.size ())
-            throw ExcelReader::IndexOutException ("sheets["
-                                                  + std::to_string (pos) + "]");
-        return names_[ pos ];
+        readCellsAs (pos, cells, out,
+                     [] (const XlsCellView& view) { return view; });
     }
-};
 
-class XLSXReadStrategy : public ReadStrategy
-{
-public:
-    explicit XLSXReadStrategy () = default;
-    ~XLSXReadStrategy () override = default;
+    void
+    readCells (std::size_t pos, Span<const CellPosition> cells,
+               Span<CellType> out) override
+    {
+        readCellsAs (pos, cells, out,
+                     [] (const XlsCellView& view) { return view.type (); });
+    }
 
-    CellType
-    readCell (const std::size_t pos, const std::size_t row,
-              const std::size_t col) override
+    // 读取区域内的全部单元格, 行优先的稠密块; 整行 / 整列区域截到
+    // 工作表实际大小. 按行顺序遍历, 不逐个查找单元格
+    CellBlock<XlsCellView>
+    readRange (std::size_t pos, const CellRange& range)
     {
-        // Implement XLSX-specific logic here
-        return CellType ();
+        const auto& sheet = parsedSheet (pos);
+        return batch::fillRange<XlsCellView> (
+            range.clamp (sheet.rowCount (), sheet.colCount ()),
+            [&sheet] (std::size_t row)
+            {
+                const auto cells = sheet.row (row);
+                return std::make_pair (cells.first, cells.last);
+            },
+            [this] (const xls::xlsCell* cell)
+            { return XlsCellView (cell, &formats_); });
     }
 
-    CellType
-    readCell (const std::size_t pos, const std::string& addr) override
+    // 区域字符串见 parseRange, 如 "A1:Z100", "C:C", "3:5"
+    CellBlock<XlsCellView>
+    readRange (std::size_t pos, std::string_view range)
     {
-        // Implement XLSX-specific logic here
-        return CellType ();
+        return readRange (pos, parseRange (range));
     }
 
-    CellType
-    readCell (const std::size_t pos, const CellPosition& cpos) override
+    const SparseSheet&
+    sheet (std::size_t pos)
     {
-        // Implement XLSX-specific logic here
-        return CellType ();
+        return parsedSheet (pos);
     }
-};
 
-class CSVReadStrategy : public ReadStrategy
-{
-public:
-    explicit CSVReadStrategy () = default;
-    ~CSVReadStrategy () override = default;
+    // 工作簿的日期格式表, 打开时构建
+    const DateFormatCache&
+    dateFormats () const
+    {
+        return formats_;
+    }
 
-    CellType
-    readCell (const std::size_t pos, const std::size_t row,
-              const std::size_t col) override
+    ParseMode
+    parseMode () const
     {
-        // Implement CSV-specific logic here
-        return CellType ();
+        return mode_;
     }
 
-    CellType
-    readCell (const std::size_t pos, const std::string& addr) override
+    // 工作簿是否使用 1904 日期系统
+    bool
+    date1904 () const
     {
-        // Implement CSV-specific logic here
-        return CellType ();
+        return workbook_->is1904 != 0;
     }
 
-    CellType
-    readCell (const std::size_t pos, const CellPosition& cpos) override
+    // 并行解析所有尚未解析的工作表
+    // 1. 串行读取各工作表的记录流: 工作簿只有一个 OLE 流, 读取会移动其位置
+    // 2. 并行解码: 各工作表只读共享的 SST / XF 表, 文本转换由锁串行化
+    // 调用期间不能在其它线程访问本对象; 返回后对已解析工作表的只读访问
+    // (readCell / sheet / 行视图) 可以多线程进行, 但不能同时解析或释放工作表
+    void
+    parseAllSheets (std::size_t threads)
     {
-        // Implement CSV-specific logic here
-        return CellType ();
+        std::vector<std::size_t> pending;
+        std::vector<std::vector<xls::BYTE>> streams;
+        for (std::size_t pos = 0; pos < names_.size (); ++pos)
+            {
+                if (parsedSheets_[ pos ])
+                    continue;
+
+                streams.emplace_back ();
+                if (readSheetStream (sheetHandle (pos), streams.back ())
+                    != xls::LIBXLS_OK)
+                    throw ExcelReader::ParseSheetException (names_[ pos ]);
+                pending.push_back (pos);
+            }
+
+        std::mutex textLock;
+        std::vector<xls::xls_error_t> results (pending.size (),
+                                               xls::LIBXLS_OK);
+        parallelFor (pending.size (), threads,
+                     [&] (std::size_t i)
+                     {
+                         results[ i ] = decodeSheetStream (
+                             workbook_.get (), streams[ i ],
+                             cells_[ pending[ i ] ], &textLock, mode_);
+                         std::vector<xls::BYTE> ().swap (streams[ i ]);
+                     });
+
+        for (std::size_t i = 0; i < pending.size (); ++i)
+            {
+                if (results[ i ] != xls::LIBXLS_OK)
+                    throw ExcelReader::ParseSheetException (
+                        names_[ pending[ i ] ]);
+                parsedSheets_[ pending[ i ] ] = true;
+            }
     }
-};
\ No newline at end of file
+
+    bool
+    isSheetParsed (std::size_t pos) const
+    {
+        checkIndex (pos);
+        return parsedSheets_[ pos ];
+    }
+
+    // 释放已解析工作表的内存, 再次访问时重新解析
+    // 之前取得的行视图随之失效
+    void
+    releaseSheet (std::size_t pos)
+    {
+        checkIndex (pos);
+        cells_[ pos ].clear ();
+        xls::xls_close_WS (sheets_[ pos ]);
+        sheets_[ pos ] = nullptr;
+        parsedSheets_[ pos ] = false;
+    }
+
+    std::string
+    getSheetName (std::size_t pos) const
+    {
+        if (pos >= names_.size ())
+            throw ExcelReader::IndexOutException ("sheets["
+                                                  + std::to_string (pos) + "]");
+        return names_[ pos ];
+    }
+};
+
+// XLSXReadStrategy 见 XlsxStrategy.h
+// CSVReadStrategy 见 CsvStrategy.h
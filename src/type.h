@@ -11,5 +11,6 @@
 using XLSheets = std::vector<xls::xlsWorkSheet *>;
 using XLSRow = std::vector<XlsCell>;
 using XLSheetsName = std::vector<std::string>;
+using XLSWorkBook = std::unique_ptr<xls::xlsWorkBook, void (*) (xls::xlsWorkBook *)>;
 
 #endif
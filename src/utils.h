@@ -4,10 +4,12 @@
 #include "Exceptions.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <optional>
-#include <set>
+#include <string_view>
 #include <vector>
 
 extern "C"
@@ -122,7 +124,31 @@ tolower (const std::string &raw_value)
     return tmp;
 }
 
-inline bool
+// 内置数字格式 (id < 164) 中的日期时间格式位图
+// 18.8.30 numFmt (Number Format) p1786
+// Date times: 14-22, 27-36, 45-47, 50-58, 71-81 (inclusive)
+constexpr int BuiltinFormatCount = 164;
+
+constexpr std::array<uint64_t, 3>
+makeBuiltinDateBitmap ()
+{
+    constexpr std::pair<int, int> ranges[]
+        = { { 14, 22 }, { 27, 36 }, { 45, 47 }, { 50, 58 }, { 71, 81 } };
+    std::array<uint64_t, 3> bits{};
+    for (auto range : ranges)
+    {
+        for (int id = range.first; id <= range.second; ++id)
+        {
+            bits[id / 64] |= uint64_t{ 1 } << (id % 64);
+        }
+    }
+    return bits;
+}
+
+inline constexpr std::array<uint64_t, 3> BuiltinDateBitmap
+    = makeBuiltinDateBitmap ();
+
+constexpr bool
 isDateTime (int Did)
 {
     // Page and section numbers below refer to
@@ -148,27 +174,175 @@ isDateTime (int Did)
     // understood to be the 0th built-in number format.
     //
     // This function stores knowledge about these built-in number formats.
-    //
-    // 18.8.30 numFmt (Number Format) p1786
-    // Date times: 14-22, 27-36, 45-47, 50-58, 71-81 (inclusive)
-    if ((Did >= 14 && Did <= 22) || (Did >= 27 && Did <= 36)
-        || (Did >= 45 && Did <= 47) || (Did >= 50 && Did <= 58)
-        || (Did >= 71 && Did <= 81))
+    // 自定义格式 (id >= 164) 需按格式字符串判断, 见 DateFormatCache
+    if (Did < 0 || Did >= BuiltinFormatCount)
     {
-        return true;
+        return false;
+    }
+    return ((BuiltinDateBitmap[Did / 64] >> (Did % 64)) & 1u) != 0;
+}
+
+// 数字格式的种类, 决定数值单元格的解释方式
+enum class NumberKind : uint8_t
+{
+    NUMBER = 0,
+    DATE, // 日期或日期时间
+    TIME, // 只有时间
+    PERCENT,
+    TEXT // "@"
+};
+
+// 内置格式的种类, 超出内置范围返回 NUMBER
+constexpr NumberKind
+builtinFormatKind (int Did)
+{
+    if ((Did >= 18 && Did <= 21) || (Did >= 45 && Did <= 47))
+    {
+        return NumberKind::TIME;
     }
+    if (isDateTime (Did))
+    {
+        return NumberKind::DATE;
+    }
+    if (Did == 9 || Did == 10)
+    {
+        return NumberKind::PERCENT;
+    }
+    if (Did == 49)
+    {
+        return NumberKind::TEXT;
+    }
+    return NumberKind::NUMBER;
+}
 
-    // Built-in format that's not a date
-    if (Did < 164)
+// 方括号内全是同一个 h / m / s (不分大小写) 时为经过时间, 如 [h] [mm];
+// [Magenta] [Black] 等颜色不算
+constexpr bool
+isElapsedTimeCode (std::string_view inner)
+{
+    if (inner.empty ())
+    {
+        return false;
+    }
+    const char unit = static_cast<char> (inner[0] | 0x20);
+    if (unit != 'h' && unit != 'm' && unit != 's')
     {
         return false;
     }
-    std::set<int> dateFormats
-        = { 14, 15, 16, 17, 18, 19, 20, 21, 22, 27, 28, 29,
-            30, 31, 32, 33, 34, 35, 36, 50, 51, 52, 53, 54,
-            55, 56, 57, 58, 59, 60, 61, 62, 67, 68, 69 };
+    for (char c : inner)
+    {
+        if (static_cast<char> (c | 0x20) != unit)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 按格式字符串判断种类, 只看第一节 (正数部分)
+// 忽略引号内文本, 转义字符, 以及 [Red] / [$-409] 等方括号内容;
+// [h] [mm] [ss] 等经过时间格式视为时间
+// 单独的 m 视为月份, 与 h / s 同时出现时视为分钟
+constexpr NumberKind
+classifyFormatCode (std::string_view code)
+{
+    bool date = false;
+    bool time = false;
+    bool month = false;
+    bool percent = false;
+    bool text = false;
+    for (std::size_t i = 0; i < code.size () && code[i] != ';'; ++i)
+    {
+        switch (code[i])
+        {
+        case '"':
+            i = code.find ('"', i + 1);
+            if (i == std::string_view::npos)
+            {
+                return NumberKind::NUMBER;
+            }
+            break;
+        case '\\':
+        case '_':
+        case '*':
+            ++i; // 跳过下一个字符
+            break;
+        case '[':
+        {
+            auto end = code.find (']', i + 1);
+            if (end == std::string_view::npos)
+            {
+                return NumberKind::NUMBER;
+            }
+            if (isElapsedTimeCode (code.substr (i + 1, end - i - 1)))
+            {
+                time = true;
+            }
+            i = end;
+            break;
+        }
+        case 'A':
+        case 'a':
+            // AM/PM, A/P
+            if (code.substr (i, 5) == "AM/PM" || code.substr (i, 5) == "am/pm")
+            {
+                time = true;
+                i += 4;
+            }
+            else if (code.substr (i, 3) == "A/P" || code.substr (i, 3) == "a/p")
+            {
+                time = true;
+                i += 2;
+            }
+            break;
+        case 'd':
+        case 'D':
+        case 'y':
+        case 'Y':
+            date = true;
+            break;
+        case 'm':
+        case 'M':
+            month = true;
+            break;
+        case 'h':
+        case 'H':
+        case 's':
+        case 'S':
+            time = true;
+            break;
+        case '%':
+            percent = true;
+            break;
+        case '@':
+            text = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (date || (month && !time))
+    {
+        return NumberKind::DATE;
+    }
+    if (time)
+    {
+        return NumberKind::TIME;
+    }
+    if (percent)
+    {
+        return NumberKind::PERCENT;
+    }
+    return text ? NumberKind::TEXT : NumberKind::NUMBER;
+}
 
-    return dateFormats.count (Did) > 0;
+// 按格式字符串判断是否为日期时间格式
+constexpr bool
+isDateFormatCode (std::string_view code)
+{
+    auto kind = classifyFormatCode (code);
+    return kind == NumberKind::DATE || kind == NumberKind::TIME;
 }
 
 inline std::pair<std::size_t, std::size_t>
@@ -208,6 +382,174 @@ parseAddress (const std::string &addr)
     return std::make_pair (row, col);
 }
 
+// 单元格区域, 行列从 0 开始, 首尾都包含
+// 整列区域 (C:C) 的行, 整行区域 (3:5) 的列不限, 结束位置为 npos,
+// 读取时按工作表实际大小截断 (见 clamp)
+struct CellRange
+{
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    uint32_t firstRow = 0;
+    uint32_t firstCol = 0;
+    uint32_t lastRow = npos;
+    uint32_t lastCol = npos;
+
+    [[nodiscard]] constexpr bool
+    wholeColumns () const
+    {
+        return lastRow == npos;
+    }
+
+    [[nodiscard]] constexpr bool
+    wholeRows () const
+    {
+        return lastCol == npos;
+    }
+
+    // 不限的一端截到工作表的 rows 行, cols 列; 明确给出的范围保持不变
+    // 工作表为空时结果为空区域, rowCount () 或 colCount () 为 0
+    [[nodiscard]] constexpr CellRange
+    clamp (std::size_t rows, std::size_t cols) const
+    {
+        CellRange out = *this;
+        if (wholeColumns ())
+        {
+            out.lastRow = static_cast<uint32_t> (
+                std::min<std::size_t> (rows, npos - 1)) - 1;
+        }
+        if (wholeRows ())
+        {
+            out.lastCol = static_cast<uint32_t> (
+                std::min<std::size_t> (cols, npos - 1)) - 1;
+        }
+        return out;
+    }
+
+    // 行数和列数; 不限的一端需要先 clamp, 否则为 0
+    [[nodiscard]] constexpr std::size_t
+    rowCount () const
+    {
+        return lastRow != npos && lastRow >= firstRow
+                   ? std::size_t (lastRow) + 1 - firstRow
+                   : 0;
+    }
+
+    [[nodiscard]] constexpr std::size_t
+    colCount () const
+    {
+        return lastCol != npos && lastCol >= firstCol
+                   ? std::size_t (lastCol) + 1 - firstCol
+                   : 0;
+    }
+
+    [[nodiscard]] constexpr bool
+    contains (std::size_t row, std::size_t col) const
+    {
+        return row >= firstRow && row <= lastRow && col >= firstCol
+               && col <= lastCol;
+    }
+};
+
+// 不放在 detail 中: utils.h 处于全局命名空间, ::detail 会与
+// xmlsimd::detail 等在 using 之后产生歧义
+namespace rangeparse
+{
+
+// 区域的一端: 列名和行号都可以省略, '$' 忽略; 返回从 1 开始的行列号,
+// 省略的部分为 0; 格式错误或越界返回 false
+constexpr bool
+parseRangeEnd (std::string_view text, uint64_t &col, uint64_t &row)
+{
+    std::size_t idx = 0;
+    col = 0;
+    row = 0;
+    if (idx < text.size () && text[idx] == '$')
+    {
+        ++idx;
+    }
+    while (idx < text.size ()
+           && ((text[idx] >= 'A' && text[idx] <= 'Z')
+               || (text[idx] >= 'a' && text[idx] <= 'z')))
+    {
+        col = col * 26 + static_cast<uint64_t> ((text[idx] & ~0x20) - 'A' + 1);
+        if (col > CellRange::npos - 1)
+        {
+            return false;
+        }
+        ++idx;
+    }
+    if (idx < text.size () && text[idx] == '$' && col != 0)
+    {
+        ++idx;
+    }
+    const std::size_t digits = idx;
+    while (idx < text.size () && text[idx] >= '0' && text[idx] <= '9')
+    {
+        row = row * 10 + static_cast<uint64_t> (text[idx] - '0');
+        if (row > CellRange::npos - 1)
+        {
+            return false;
+        }
+        ++idx;
+    }
+    return idx == text.size () && (col != 0 || idx != digits)
+           && (idx == digits || row != 0);
+}
+
+} // namespace rangeparse
+
+// 解析区域: A1:Z100, 单个单元格 B2, 整列 C:C / C:E, 整行 3:3 / 3:5
+// 列名不区分大小写, 可带 '$'; 两端顺序颠倒时自动交换
+// 格式错误返回空
+constexpr std::optional<CellRange>
+fromRangeString (std::string_view text)
+{
+    const std::size_t colon = text.find (':');
+    const auto first = text.substr (0, colon);
+    const auto last
+        = colon == std::string_view::npos ? first : text.substr (colon + 1);
+
+    uint64_t c1 = 0;
+    uint64_t r1 = 0;
+    uint64_t c2 = 0;
+    uint64_t r2 = 0;
+    if (!rangeparse::parseRangeEnd (first, c1, r1)
+        || !rangeparse::parseRangeEnd (last, c2, r2))
+    {
+        return std::nullopt;
+    }
+    // 两端的形式必须相同: 都是单元格, 都是列, 或都是行
+    if ((c1 == 0) != (c2 == 0) || (r1 == 0) != (r2 == 0))
+    {
+        return std::nullopt;
+    }
+
+    CellRange range;
+    if (c1 != 0)
+    {
+        range.firstCol = static_cast<uint32_t> (std::min (c1, c2) - 1);
+        range.lastCol = static_cast<uint32_t> (std::max (c1, c2) - 1);
+    }
+    if (r1 != 0)
+    {
+        range.firstRow = static_cast<uint32_t> (std::min (r1, r2) - 1);
+        range.lastRow = static_cast<uint32_t> (std::max (r1, r2) - 1);
+    }
+    return range;
+}
+
+// 同 fromRangeString, 格式错误时抛出 ParseAddrException
+inline CellRange
+parseRange (std::string_view text)
+{
+    auto range = fromRangeString (text);
+    if (!range.has_value ())
+    {
+        throw ExcelReader::ParseAddrException (std::string (text));
+    }
+    return *range;
+}
+
 std::wstring
 _transformString2Wstring (const std::string &s)
 {
@@ -0,0 +1,143 @@
+#include "../src/ArrowExport.h"
+#include "sheetBuilder.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+SheetColumns
+makeTable ()
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 1.5);
+    addLabel (sheet, 0, 1, "ab");
+    addLabel (sheet, 1, 1, "c");
+    addNumber (sheet, 1, 2, 25570.0, 14);
+    addLabel (sheet, 1, 3, "bool", XLS_RECORD_BOOLERR).d = 1;
+    addCell (sheet, 1, 5, XLS_RECORD_BLANK);
+    sheet.finalize ();
+    return readColumns (sheet, nullptr);
+}
+
+} // namespace
+
+TEST (ArrowExportTest, SchemaAndBuffers)
+{
+    ArrowSchema schema{};
+    ArrowArray array{};
+    exportArrow (makeTable (), { "num", "" }, &schema, &array);
+
+    EXPECT_STREQ (schema.format, "+s");
+    ASSERT_EQ (schema.n_children, 6);
+    EXPECT_STREQ (schema.children[0]->name, "num");
+    EXPECT_STREQ (schema.children[1]->name, "B");
+    EXPECT_STREQ (schema.children[5]->name, "F");
+    EXPECT_STREQ (schema.children[0]->format, "g");
+    EXPECT_STREQ (schema.children[1]->format, "U");
+    EXPECT_STREQ (schema.children[2]->format, "tsm:");
+    EXPECT_STREQ (schema.children[3]->format, "b");
+    EXPECT_STREQ (schema.children[4]->format, "n");
+    EXPECT_EQ (schema.children[0]->flags, ARROW_FLAG_NULLABLE);
+
+    EXPECT_EQ (array.length, 2);
+    ASSERT_EQ (array.n_children, 6);
+
+    const ArrowArray *num = array.children[0];
+    EXPECT_EQ (num->null_count, 1);
+    EXPECT_EQ (static_cast<const uint8_t *> (num->buffers[0])[0], 0x01);
+    EXPECT_DOUBLE_EQ (static_cast<const double *> (num->buffers[1])[0], 1.5);
+
+    const ArrowArray *str = array.children[1];
+    EXPECT_EQ (str->n_buffers, 3);
+    EXPECT_EQ (str->null_count, 0);
+    EXPECT_EQ (str->buffers[0], nullptr);
+    const auto *offsets = static_cast<const int64_t *> (str->buffers[1]);
+    EXPECT_EQ (offsets[0], 0);
+    EXPECT_EQ (offsets[1], 2);
+    EXPECT_EQ (offsets[2], 3);
+    EXPECT_EQ (std::memcmp (str->buffers[2], "abc", 3), 0);
+
+    const ArrowArray *date = array.children[2];
+    EXPECT_EQ (static_cast<const int64_t *> (date->buffers[1])[1], 86400000);
+
+    const ArrowArray *flags = array.children[3];
+    EXPECT_EQ (static_cast<const uint8_t *> (flags->buffers[1])[0] & 0x02,
+               0x02);
+
+    const ArrowArray *empty = array.children[4];
+    EXPECT_EQ (empty->n_buffers, 0);
+    EXPECT_EQ (empty->null_count, 2);
+
+    array.release (&array);
+    schema.release (&schema);
+    EXPECT_EQ (array.release, nullptr);
+    EXPECT_EQ (schema.release, nullptr);
+}
+
+// 子数组可以移走后单独释放
+TEST (ArrowExportTest, MoveChildOut)
+{
+    ArrowSchema schema{};
+    ArrowArray array{};
+    exportArrow (makeTable (), {}, &schema, &array);
+
+    ArrowArray moved = *array.children[1];
+    array.children[1]->release = nullptr;
+    array.release (&array);
+
+    ASSERT_NE (moved.release, nullptr);
+    EXPECT_EQ (std::memcmp (moved.buffers[2], "abc", 3), 0);
+    moved.release (&moved);
+    schema.release (&schema);
+}
+
+// 字典编码的列导出为 dictionary<uint32, large_utf8>, 字典可随子数组移走
+TEST (ArrowExportTest, DictionaryColumn)
+{
+    SparseSheet sheet;
+    for (uint16_t r = 0; r < 4; ++r)
+    {
+        addLabel (sheet, r, 0, r % 2 == 0 ? "x" : "yz");
+    }
+    addLabel (sheet, 5, 0, "x");
+    sheet.finalize ();
+
+    ArrowSchema schema{};
+    ArrowArray array{};
+    exportArrow (readColumns (sheet, nullptr, false, 0,
+                              StringEncoding::DICTIONARY),
+                 {}, &schema, &array);
+
+    const ArrowSchema *field = schema.children[0];
+    EXPECT_STREQ (field->format, "I");
+    ASSERT_NE (field->dictionary, nullptr);
+    EXPECT_STREQ (field->dictionary->format, "U");
+
+    ArrowArray moved = *array.children[0];
+    array.children[0]->release = nullptr;
+    array.release (&array);
+
+    EXPECT_EQ (moved.length, 6);
+    EXPECT_EQ (moved.null_count, 1);
+    EXPECT_EQ (moved.n_buffers, 2);
+    const auto *codes = static_cast<const uint32_t *> (moved.buffers[1]);
+    EXPECT_EQ (codes[0], 0u);
+    EXPECT_EQ (codes[1], 1u);
+    EXPECT_EQ (codes[2], 0u);
+    EXPECT_EQ (codes[5], 0u);
+
+    const ArrowArray *dict = moved.dictionary;
+    ASSERT_NE (dict, nullptr);
+    EXPECT_EQ (dict->length, 2);
+    EXPECT_EQ (dict->null_count, 0);
+    EXPECT_EQ (dict->n_buffers, 3);
+    EXPECT_EQ (dict->buffers[0], nullptr);
+    const auto *offsets = static_cast<const int64_t *> (dict->buffers[1]);
+    EXPECT_EQ (offsets[1], 1);
+    EXPECT_EQ (offsets[2], 3);
+    EXPECT_EQ (std::memcmp (dict->buffers[2], "xyz", 3), 0);
+
+    moved.release (&moved);
+    schema.release (&schema);
+}
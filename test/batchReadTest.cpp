@@ -0,0 +1,203 @@
+#include "../src/CsvStrategy.h"
+#include "../src/XlsxStrategy.h"
+#include "../src/strategy.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifndef LIBXLS_TEST_DATA_DIR
+#define LIBXLS_TEST_DATA_DIR "third-party/libxls/test/files"
+#endif
+
+#ifndef XLNT_TEST_DATA_DIR
+#define XLNT_TEST_DATA_DIR "third-party/xlnt/tests/data"
+#endif
+
+namespace
+{
+
+// 随机位置, 含重复和超出范围的位置, 顺序打乱
+std::vector<CellPosition>
+randomPositions (std::size_t rows, std::size_t cols)
+{
+    std::mt19937 rng (6);
+    std::vector<CellPosition> cells;
+    for (int i = 0; i < 500; ++i)
+    {
+        cells.emplace_back (rng () % (rows + 3), rng () % (cols + 3));
+    }
+    cells.push_back (cells[0]);
+    cells.push_back (cells[1]);
+    return cells;
+}
+
+// readCells 与逐个 readCell 的结果相同
+void
+expectMatchesReadCell (ReadStrategy &strategy,
+                       const std::vector<CellPosition> &cells)
+{
+    std::vector<CellType> types (cells.size (), CellType::UNKNOWN);
+    strategy.readCells (0, cells, types);
+    for (std::size_t i = 0; i < cells.size (); ++i)
+    {
+        ASSERT_EQ (types[i], strategy.readCell (0, cells[i]))
+            << cells[i].addr ();
+    }
+}
+
+// 块中每个位置与按位置单独读取的结果相同
+template <typename Block, typename Expected>
+void
+expectBlock (const Block &block, Expected &&expected)
+{
+    ASSERT_EQ (block.cells.size (), block.rows * block.cols);
+    for (std::size_t r = 0; r < block.rows; ++r)
+    {
+        for (std::size_t c = 0; c < block.cols; ++c)
+        {
+            expected (block.range.firstRow + r, block.range.firstCol + c,
+                      block.at (r, c));
+        }
+    }
+}
+
+} // namespace
+
+TEST (BatchReadTest, XlsMatchesReadCell)
+{
+    const auto path = fs::path (LIBXLS_TEST_DATA_DIR) / "test2.xls";
+    XLSReadStrategy strategy (
+        path, XLSWorkBook (xls::xls_open (path.string ().c_str (), "UTF-8"),
+                           xlsDeleter));
+    const auto &sheet = strategy.sheet (0);
+    const auto cells = randomPositions (sheet.rowCount (), sheet.colCount ());
+    expectMatchesReadCell (strategy, cells);
+
+    std::vector<XlsCellView> views (cells.size ());
+    strategy.readCells (0, cells, views);
+    for (std::size_t i = 0; i < cells.size (); ++i)
+    {
+        EXPECT_EQ (views[i].raw (), sheet.find (cells[i].row, cells[i].col));
+    }
+}
+
+TEST (BatchReadTest, XlsxMatchesReadCell)
+{
+    XLSXReadStrategy strategy (fs::path (XLNT_TEST_DATA_DIR)
+                               / "18_formulae.xlsx");
+    const auto &sheet = strategy.sheet (0);
+    const auto cells = randomPositions (sheet.rowCount (), sheet.colCount ());
+    expectMatchesReadCell (strategy, cells);
+
+    std::vector<XlsxCellView> views (cells.size ());
+    strategy.readCells (0, cells, views);
+    for (std::size_t i = 0; i < cells.size (); ++i)
+    {
+        EXPECT_EQ (views[i].raw (), sheet.find (cells[i].row, cells[i].col));
+    }
+}
+
+TEST (BatchReadTest, CsvMatchesReadCell)
+{
+    const auto path = fs::temp_directory_path () / "batchReadTest.csv";
+    {
+        std::ofstream out (path, std::ios::binary);
+        for (int r = 0; r < 50; ++r)
+        {
+            out << r << ",name" << r << ",\"q," << r << "\","
+                << (r % 2 != 0 ? "TRUE" : "") << "\n";
+        }
+    }
+    CSVReadStrategy strategy (path);
+    const auto cells = randomPositions (strategy.rowCount (),
+                                        strategy.colCount ());
+    expectMatchesReadCell (strategy, cells);
+
+    std::vector<csv::CsvField> fields (cells.size ());
+    strategy.readCells (0, cells, fields);
+    for (std::size_t i = 0; i < cells.size (); ++i)
+    {
+        EXPECT_EQ (fields[i].text (),
+                   strategy.field (0, cells[i].row, cells[i].col).text ());
+    }
+    fs::remove (path);
+}
+
+TEST (BatchReadTest, InvalidRequests)
+{
+    XLSXReadStrategy strategy (fs::path (XLNT_TEST_DATA_DIR)
+                               / "18_formulae.xlsx");
+    std::vector<CellPosition> cells{ CellPosition (0, 0), CellPosition () };
+    std::vector<CellType> types (2);
+    EXPECT_THROW (strategy.readCells (0, cells, types),
+                  ExcelReader::ParseAddrException);
+
+    cells.pop_back ();
+    std::vector<CellType> empty;
+    EXPECT_THROW (strategy.readCells (0, cells, empty),
+                  ExcelReader::IndexOutException);
+
+    // 空请求
+    strategy.readCells (0, Span<const CellPosition> (), empty);
+}
+
+TEST (BatchReadTest, XlsRange)
+{
+    const auto path = fs::path (LIBXLS_TEST_DATA_DIR) / "test2.xls";
+    XLSReadStrategy strategy (
+        path, XLSWorkBook (xls::xls_open (path.string ().c_str (), "UTF-8"),
+                           xlsDeleter));
+    const auto &sheet = strategy.sheet (0);
+    for (const char *range : { "A1:E10", "B3:D30", "C:C", "2:4", "A1" })
+    {
+        expectBlock (strategy.readRange (0, range),
+                     [&] (std::size_t r, std::size_t c, const XlsCellView &v)
+                     { EXPECT_EQ (v.raw (), sheet.find (r, c)) << range; });
+    }
+    const auto column = strategy.readRange (0, "C:C");
+    EXPECT_EQ (column.rows, sheet.rowCount ());
+    EXPECT_EQ (column.cols, 1u);
+}
+
+TEST (BatchReadTest, XlsxRange)
+{
+    XLSXReadStrategy strategy (fs::path (XLNT_TEST_DATA_DIR)
+                               / "18_formulae.xlsx");
+    const auto &sheet = strategy.sheet (0);
+    for (const char *range : { "A1:J20", "B2:C3", "D:E", "1:2" })
+    {
+        expectBlock (strategy.readRange (0, range),
+                     [&] (std::size_t r, std::size_t c, const XlsxCellView &v)
+                     { EXPECT_EQ (v.raw (), sheet.find (r, c)) << range; });
+    }
+    EXPECT_THROW (strategy.readRange (0, "A1:"),
+                  ExcelReader::ParseAddrException);
+}
+
+TEST (BatchReadTest, CsvRange)
+{
+    const auto path = fs::temp_directory_path () / "batchReadRange.csv";
+    {
+        std::ofstream out (path, std::ios::binary);
+        out << "a,b,c\n1,\"x\ny\",3\n4\n5,6,7,8\n";
+    }
+    CSVReadStrategy strategy (path);
+    for (const char *range : { "A1:D4", "B2:C9", "D:D", "2:3" })
+    {
+        expectBlock (strategy.readRange (0, range),
+                     [&] (std::size_t r, std::size_t c,
+                          const csv::CsvField &field)
+                     {
+                         EXPECT_EQ (field.text (),
+                                    strategy.field (0, r, c).text ())
+                             << range;
+                     });
+    }
+    const auto block = strategy.readRange (0, "B:B");
+    EXPECT_EQ (block.rows, 4u);
+    EXPECT_EQ (block.at (1, 0).text (), "x\ny");
+    fs::remove (path);
+}
@@ -0,0 +1,103 @@
+#include "../src/XlsCell.h"
+
+#include <gtest/gtest.h>
+
+// 编译期转换
+static_assert (CellPosition::fromAddress ("A1")->col == 0);
+static_assert (CellPosition::fromAddress ("AA10")->row == 9);
+static_assert (CellPosition::fromAddress ("AA10")->col == 26);
+static_assert (!CellPosition::fromAddress ("1A").has_value ());
+static_assert (CellPosition (3, 4) == CellPosition (std::make_pair (3, 4)));
+static_assert (fromRangeString ("B2:A1")->lastCol == 1);
+static_assert (fromRangeString ("C:C")->wholeColumns ());
+
+// 默认构造为无效位置, 地址为空
+TEST (CellPositionTest, DefaultIsInvalid)
+{
+    CellPosition pos;
+    EXPECT_FALSE (pos.valid ());
+    EXPECT_FALSE (CellPosition (std::nullopt).valid ());
+    EXPECT_EQ (pos.addr (), "");
+}
+
+// 行列号 -> 地址, 只在需要时计算
+TEST (CellPositionTest, FromRowCol)
+{
+    CellPosition pos (0, 0);
+    EXPECT_TRUE (pos.valid ());
+    EXPECT_EQ (pos.addr (), "A1");
+    EXPECT_EQ (CellPosition (std::make_pair (1, 2)).addr (), "C2");
+    EXPECT_EQ (CellPosition (9, 25).addr (), "Z10");
+    EXPECT_EQ (CellPosition (0, 26).addr (), "AA1");
+    EXPECT_EQ (CellPosition (0, 701).addr (), "ZZ1");
+    EXPECT_EQ (CellPosition (1048575, 16383).addr (), "XFD1048576");
+}
+
+// 地址 -> 行列号, 列名不区分大小写
+TEST (CellPositionTest, FromAddress)
+{
+    CellPosition pos ("B3");
+    EXPECT_EQ (pos.row, 2u);
+    EXPECT_EQ (pos.col, 1u);
+    EXPECT_EQ (CellPosition (std::string ("ab12")), CellPosition (11, 27));
+    EXPECT_EQ (CellPosition ("XFD1048576").addr (), "XFD1048576");
+}
+
+TEST (CellPositionTest, InvalidAddress)
+{
+    EXPECT_THROW (CellPosition (""), ExcelReader::ParseAddrException);
+    EXPECT_THROW (CellPosition ("A"), ExcelReader::ParseAddrException);
+    EXPECT_THROW (CellPosition ("12"), ExcelReader::ParseAddrException);
+    EXPECT_THROW (CellPosition ("A0"), ExcelReader::ParseAddrException);
+    EXPECT_THROW (CellPosition ("A1B"), ExcelReader::ParseAddrException);
+    EXPECT_THROW (CellPosition ("A99999999999"),
+                  ExcelReader::ParseAddrException);
+}
+
+// 最大行列的往返转换
+TEST (CellPositionTest, RoundTripLimits)
+{
+    CellPosition pos (CellPosition::npos - 1, CellPosition::npos - 1);
+    auto addr = pos.addr ();
+    EXPECT_LE (addr.size (), CellPosition::MaxAddrLength);
+    EXPECT_EQ (CellPosition (addr), pos);
+}
+
+// 区域: 单元格区域, 单个单元格, 整列, 整行, '$' 和颠倒的两端
+TEST (CellPositionTest, ParseRange)
+{
+    auto range = parseRange ("A1:Z10000");
+    EXPECT_EQ (range.firstRow, 0u);
+    EXPECT_EQ (range.firstCol, 0u);
+    EXPECT_EQ (range.lastRow, 9999u);
+    EXPECT_EQ (range.lastCol, 25u);
+    EXPECT_EQ (range.rowCount (), 10000u);
+    EXPECT_EQ (range.colCount (), 26u);
+
+    range = parseRange ("$c$3");
+    EXPECT_EQ (range.rowCount (), 1u);
+    EXPECT_TRUE (range.contains (2, 2));
+
+    range = parseRange ("D:b");
+    EXPECT_TRUE (range.wholeColumns ());
+    EXPECT_FALSE (range.wholeRows ());
+    EXPECT_EQ (range.firstCol, 1u);
+    EXPECT_EQ (range.lastCol, 3u);
+    EXPECT_EQ (range.rowCount (), 0u);
+    EXPECT_EQ (range.clamp (50, 2).rowCount (), 50u);
+    EXPECT_EQ (range.clamp (50, 2).colCount (), 3u);
+    EXPECT_EQ (range.clamp (0, 2).rowCount (), 0u);
+
+    range = parseRange ("5:3");
+    EXPECT_TRUE (range.wholeRows ());
+    EXPECT_EQ (range.firstRow, 2u);
+    EXPECT_EQ (range.lastRow, 4u);
+    EXPECT_EQ (range.clamp (100, 7).colCount (), 7u);
+
+    for (const char *bad : { "", ":", "A1:B", "A:1", "A0", "1A", "A1:B2:C3",
+                             "A1 ", "$$A1", "A1:" })
+    {
+        EXPECT_FALSE (fromRangeString (bad).has_value ()) << bad;
+    }
+    EXPECT_THROW (parseRange ("A1-B2"), ExcelReader::ParseAddrException);
+}
@@ -0,0 +1,320 @@
+#include "../src/ColumnBuffer.h"
+#include "sheetBuilder.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+TEST (ColumnBufferTest, EmptySheet)
+{
+    SparseSheet sheet;
+    sheet.finalize ();
+    auto table = readColumns (sheet, nullptr);
+    EXPECT_EQ (table.rows, 0u);
+    EXPECT_TRUE (table.columns.empty ());
+}
+
+// 每列按取样的单元格定类型, 空行补空值
+TEST (ColumnBufferTest, TypedColumns)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 1.5);
+    addCell (sheet, 2, 0, XLS_RECORD_RK).d = -2.0;
+    addLabel (sheet, 0, 1, "a");
+    addLabel (sheet, 1, 1, "");
+    addLabel (sheet, 2, 1, "bc");
+    addLabel (sheet, 1, 2, "bool", XLS_RECORD_BOOLERR).d = 1;
+    addNumber (sheet, 3, 3, 25569.5, 14);
+    sheet.finalize ();
+
+    auto table = readColumns (sheet, nullptr);
+    ASSERT_EQ (table.rows, 4u);
+    ASSERT_EQ (table.columns.size (), 4u);
+
+    const auto &numbers = table.columns[0];
+    EXPECT_EQ (numbers.type, ColumnType::NUMBER);
+    EXPECT_EQ (numbers.length, 4u);
+    EXPECT_EQ (numbers.nullCount, 2u);
+    EXPECT_TRUE (numbers.valid (0));
+    EXPECT_FALSE (numbers.valid (1));
+    EXPECT_DOUBLE_EQ (numbers.numbers[0], 1.5);
+    EXPECT_DOUBLE_EQ (numbers.numbers[2], -2.0);
+
+    const auto &strings = table.columns[1];
+    EXPECT_EQ (strings.type, ColumnType::STRING);
+    ASSERT_EQ (strings.offsets.size (), 5u);
+    EXPECT_EQ (strings.stringAt (0), "a");
+    EXPECT_FALSE (strings.valid (1));
+    EXPECT_EQ (strings.stringAt (1), "");
+    EXPECT_EQ (strings.stringAt (2), "bc");
+    EXPECT_FALSE (strings.valid (3));
+    EXPECT_EQ (std::string (strings.chars.begin (), strings.chars.end ()),
+               "abc");
+
+    const auto &bools = table.columns[2];
+    EXPECT_EQ (bools.type, ColumnType::BOOL);
+    EXPECT_FALSE (bools.valid (0));
+    EXPECT_TRUE (bools.valid (1));
+    EXPECT_TRUE (bools.boolAt (1));
+
+    const auto &dates = table.columns[3];
+    EXPECT_EQ (dates.type, ColumnType::DATE);
+    EXPECT_EQ (dates.nullCount, 3u);
+    EXPECT_EQ (dates.dates[3], 43200000);
+}
+
+// 类型混合的列为 STRING, 不论第一个单元格是什么类型; 数值单元格格式化,
+// 字符串单元格保存原文
+TEST (ColumnBufferTest, MixedColumnsBecomeStrings)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 1.0);
+    addLabel (sheet, 1, 0, "pending");
+    addLabel (sheet, 0, 1, "x");
+    addLabel (sheet, 1, 1, "007");
+    addLabel (sheet, 2, 1, " 1e3 ");
+    addLabel (sheet, 3, 1, "true");
+    addNumber (sheet, 4, 1, 0.25);
+    addLabel (sheet, 0, 2, "2.5");
+    addNumber (sheet, 1, 2, 3.0);
+    addNumber (sheet, 0, 3, 1.0);
+    addLabel (sheet, 1, 3, "TRUE", XLS_RECORD_LABEL);
+    sheet.finalize ();
+
+    auto table = readColumns (sheet, nullptr);
+    const auto &first = table.columns[0];
+    EXPECT_EQ (first.type, ColumnType::STRING);
+    EXPECT_TRUE (first.valid (0) && first.valid (1));
+    EXPECT_EQ (first.stringAt (0), "1");
+    EXPECT_EQ (first.stringAt (1), "pending");
+
+    const auto &labels = table.columns[1];
+    EXPECT_EQ (labels.type, ColumnType::STRING);
+    EXPECT_EQ (labels.nullCount, 0u);
+    EXPECT_EQ (labels.stringAt (1), "007");
+    EXPECT_EQ (labels.stringAt (2), " 1e3 ");
+    EXPECT_EQ (labels.stringAt (3), "true");
+    EXPECT_EQ (labels.stringAt (4), "0.25");
+
+    // 数值文本与数值单元格都是 NUMBER
+    const auto &numbers = table.columns[2];
+    EXPECT_EQ (numbers.type, ColumnType::NUMBER);
+    EXPECT_TRUE (numbers.valid (0) && numbers.valid (1));
+    EXPECT_DOUBLE_EQ (numbers.numbers[0], 2.5);
+    EXPECT_DOUBLE_EQ (numbers.numbers[1], 3.0);
+
+    EXPECT_EQ (table.columns[3].type, ColumnType::STRING);
+    EXPECT_EQ (table.columns[3].stringAt (1), "TRUE");
+}
+
+// 只取样部分行时, 取样之外无法按列类型表示的值为空值
+TEST (ColumnBufferTest, SampledTypeNullsOnlyUnrepresentable)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 1.0);
+    addLabel (sheet, 1, 0, "2.5");
+    addLabel (sheet, 2, 0, "n/a");
+    addNumber (sheet, 3, 0, 45000.0, 14);
+    sheet.finalize ();
+
+    auto table = readColumns (sheet, nullptr, false, 0,
+                              StringEncoding::PLAIN, 1);
+    const auto &numbers = table.columns[0];
+    EXPECT_EQ (numbers.type, ColumnType::NUMBER);
+    EXPECT_DOUBLE_EQ (numbers.numbers[1], 2.5);
+    EXPECT_FALSE (numbers.valid (2));
+    EXPECT_DOUBLE_EQ (numbers.numbers[3], 45000.0);
+    EXPECT_EQ (numbers.nullCount, 1u);
+
+    EXPECT_EQ (readColumns (sheet, nullptr).columns[0].type,
+               ColumnType::STRING);
+}
+
+// 同样的数据在 XLS 与 XLSX 中得到同样的列
+TEST (ColumnBufferTest, XlsAndXlsxColumnsAgree)
+{
+    const char *labels[] = { "x", "007", "1.5", "true" };
+    SparseSheet xls;
+    StringArena shared;
+    XlsxSheet xlsx (&shared, nullptr);
+    for (uint16_t r = 0; r < 4; ++r)
+    {
+        addLabel (xls, r, 0, labels[r]);
+        xlsx.append (r, 0, 0, XlsxValue::SHARED).str = shared.add (labels[r]);
+        addNumber (xls, r, 1, r);
+        xlsx.append (r, 1, 0, XlsxValue::NUMBER).number = r;
+    }
+    addLabel (xls, 4, 1, "7");
+    xlsx.append (4, 1, 0, XlsxValue::INLINE).str
+        = xlsx.inlineStrings ().add ("7");
+    xls.finalize ();
+    xlsx.finalize ();
+
+    const auto lhs = readColumns (xls, nullptr);
+    const auto rhs = readColumns (xlsx);
+    ASSERT_EQ (lhs.columns.size (), rhs.columns.size ());
+    EXPECT_EQ (lhs.columns[0].type, ColumnType::STRING);
+    EXPECT_EQ (lhs.columns[1].type, ColumnType::NUMBER);
+    for (std::size_t c = 0; c < lhs.columns.size (); ++c)
+    {
+        const auto &a = lhs.columns[c];
+        const auto &b = rhs.columns[c];
+        EXPECT_EQ (a.type, b.type);
+        EXPECT_EQ (a.nullCount, b.nullCount);
+        for (std::size_t r = 0; r < a.length; ++r)
+        {
+            if (a.type == ColumnType::STRING)
+            {
+                EXPECT_EQ (a.stringAt (r), b.stringAt (r));
+            }
+            else
+            {
+                EXPECT_EQ (a.numbers[r], b.numbers[r]);
+            }
+        }
+    }
+    EXPECT_EQ (lhs.columns[0].stringAt (1), "007");
+    EXPECT_DOUBLE_EQ (lhs.columns[1].numbers[4], 7.0);
+}
+
+TEST (ColumnBufferTest, DateSystems)
+{
+    EXPECT_EQ (columnar::serialToUnixMillis (25569.0, false), 0);
+    EXPECT_EQ (columnar::serialToUnixMillis (24107.0, true), 0);
+    EXPECT_EQ (columnar::serialToUnixMillis (45292.0, false),
+               1704067200000);
+}
+
+// 跳过表头行
+TEST (ColumnBufferTest, SkipHeaderRows)
+{
+    SparseSheet sheet;
+    addLabel (sheet, 0, 0, "value");
+    addNumber (sheet, 1, 0, 3.0);
+    addNumber (sheet, 2, 0, 4.0);
+    sheet.finalize ();
+
+    auto table = readColumns (sheet, nullptr, false, 1);
+    ASSERT_EQ (table.rows, 2u);
+    EXPECT_EQ (table.columns[0].type, ColumnType::NUMBER);
+    EXPECT_EQ (table.columns[0].nullCount, 0u);
+    EXPECT_DOUBLE_EQ (table.columns[0].numbers[1], 4.0);
+
+    EXPECT_EQ (readColumns (sheet, nullptr, false, 5).rows, 0u);
+}
+
+// 相同的文本得到相同的编码, 扩容后编码不变
+TEST (ColumnBufferTest, StringPoolInterns)
+{
+    columnar::StringPool pool (2);
+    EXPECT_EQ (pool.intern ("a"), 0u);
+    EXPECT_EQ (pool.intern (""), 1u);
+    EXPECT_EQ (pool.intern ("a"), 0u);
+    EXPECT_EQ (pool.shared (1, "b"), 2u);
+    EXPECT_EQ (pool.shared (0, "a"), 0u);
+    EXPECT_EQ (pool.shared (5, "b"), 2u); // 超出共享表, 按文本驻留
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ (pool.intern ("s" + std::to_string (i)), 3u + i);
+    }
+    EXPECT_EQ (pool.intern ("s500"), 503u);
+    EXPECT_EQ (pool.shared (1, "b"), 2u);
+
+    auto dict = pool.dictionary ();
+    ASSERT_EQ (dict->size (), 1003u);
+    EXPECT_EQ (dict->get (1), "");
+    EXPECT_EQ (dict->get (1002), "s999");
+}
+
+// XLS: 引用 SST 的单元格按下标驻留, 自有文本和数值按文本驻留,
+// 各字符串列共用一个字典
+TEST (ColumnBufferTest, DictionaryColumnsFromSst)
+{
+    char red[] = "red";
+    char blue[] = "blue";
+    char again[] = "red"; // SST 中的重复文本
+    xls::st_sst::str_sst_string entries[] = { { red }, { blue }, { again } };
+    xls::st_sst sst{};
+    sst.count = 3;
+    sst.string = entries;
+
+    SparseSheet sheet;
+    sheet.setSharedStrings (&sst);
+    sheet.shareString (sheet.append (0, 0, XLS_RECORD_LABELSST, 0), 0);
+    sheet.shareString (sheet.append (1, 0, XLS_RECORD_LABELSST, 0), 1);
+    sheet.shareString (sheet.append (2, 0, XLS_RECORD_LABELSST, 0), 2);
+    addLabel (sheet, 3, 0, "blue");
+    addNumber (sheet, 4, 0, 3.0);
+    sheet.shareString (sheet.append (1, 1, XLS_RECORD_LABELSST, 0), 1);
+    addNumber (sheet, 5, 2, 1.0);
+    sheet.finalize ();
+
+    auto plain = readColumns (sheet, nullptr);
+    auto table = readColumns (sheet, nullptr, false, 0,
+                              StringEncoding::DICTIONARY);
+    ASSERT_EQ (table.rows, 6u);
+
+    const auto &names = table.columns[0];
+    EXPECT_EQ (names.type, ColumnType::STRING);
+    ASSERT_TRUE (names.dictionaryEncoded ());
+    EXPECT_TRUE (names.offsets.empty ());
+    EXPECT_TRUE (names.chars.empty ());
+    ASSERT_EQ (names.codes.size (), 6u);
+    EXPECT_EQ (names.codes[0], names.codes[2]);
+    EXPECT_EQ (names.codes[1], names.codes[3]);
+    EXPECT_NE (names.codes[0], names.codes[1]);
+    EXPECT_EQ (names.stringAt (4), "3");
+    EXPECT_FALSE (names.valid (5));
+    EXPECT_EQ (names.nullCount, 1u);
+    for (std::size_t i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ (names.stringAt (i), plain.columns[0].stringAt (i));
+    }
+
+    const auto &other = table.columns[1];
+    EXPECT_EQ (other.dictionary, names.dictionary);
+    EXPECT_EQ (other.codes[1], names.codes[1]);
+    EXPECT_FALSE (other.valid (0));
+    EXPECT_EQ (names.dictionary->size (), 3u);
+
+    EXPECT_FALSE (table.columns[2].dictionaryEncoded ());
+    EXPECT_FALSE (plain.columns[0].dictionaryEncoded ());
+}
+
+// XLSX: t="s" 按 sharedStrings.xml 下标驻留, 与 inline 文本共用字典
+TEST (ColumnBufferTest, DictionaryColumnsFromXlsx)
+{
+    StringArena shared;
+    shared.add ("north");
+    shared.add ("south");
+
+    XlsxSheet sheet (&shared, nullptr);
+    sheet.append (0, 0, 0, XlsxValue::SHARED).str = 1;
+    sheet.append (1, 0, 0, XlsxValue::SHARED).str = 0;
+    sheet.append (2, 0, 0, XlsxValue::INLINE).str
+        = sheet.inlineStrings ().add ("south");
+    sheet.append (3, 0, 0, XlsxValue::BOOL).number = 1.0;
+    sheet.append (0, 1, 0, XlsxValue::NUMBER).number = 2.5;
+    sheet.finalize ();
+
+    auto plain = readColumns (sheet);
+    ASSERT_EQ (plain.rows, 4u);
+    EXPECT_EQ (plain.columns[0].stringAt (2), "south");
+    EXPECT_EQ (plain.columns[0].stringAt (3), "TRUE");
+    EXPECT_EQ (plain.columns[1].type, ColumnType::NUMBER);
+    EXPECT_DOUBLE_EQ (plain.columns[1].numbers[0], 2.5);
+
+    auto table = readColumns (sheet, false, 0, StringEncoding::DICTIONARY);
+    const auto &col = table.columns[0];
+    ASSERT_TRUE (col.dictionaryEncoded ());
+    EXPECT_EQ (col.codes[0], col.codes[2]);
+    EXPECT_EQ (col.dictionary->size (), 3u);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ (col.stringAt (i), plain.columns[0].stringAt (i));
+    }
+
+    auto body = readColumns (sheet, false, 1, StringEncoding::DICTIONARY);
+    ASSERT_EQ (body.rows, 3u);
+    EXPECT_EQ (body.columns[0].stringAt (0), "north");
+}
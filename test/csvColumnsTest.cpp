@@ -0,0 +1,94 @@
+#include "../src/CsvColumns.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+SheetColumns
+columnsOf (std::string_view text, std::size_t skipRows = 0,
+           std::size_t sampleRows = csv::DefaultSampleRows)
+{
+    const auto index = csv::indexRecords (text);
+    return csv::readColumns (text, index, {}, skipRows, sampleRows);
+}
+
+} // namespace
+
+// 取样确定列类型: 全是数值, 全是 TRUE / FALSE, 混合为字符串, 全空为 EMPTY
+TEST (CsvColumnsTest, InferredTypes)
+{
+    const std::string text = "id,flag,mixed,note,none\n"
+                             "1,TRUE,1,\"a,b\",\n"
+                             "2.5,false,x,\"say \"\"hi\"\"\",\n"
+                             ",,TRUE,,\n";
+    const auto table = columnsOf (text, 1);
+    ASSERT_EQ (table.rows, 3u);
+    ASSERT_EQ (table.columns.size (), 5u);
+
+    const auto &id = table.columns[0];
+    EXPECT_EQ (id.type, ColumnType::NUMBER);
+    EXPECT_EQ (id.nullCount, 1u);
+    EXPECT_DOUBLE_EQ (id.numbers[0], 1.0);
+    EXPECT_DOUBLE_EQ (id.numbers[1], 2.5);
+    EXPECT_FALSE (id.valid (2));
+
+    const auto &flag = table.columns[1];
+    EXPECT_EQ (flag.type, ColumnType::BOOL);
+    EXPECT_TRUE (flag.boolAt (0));
+    EXPECT_FALSE (flag.boolAt (1));
+    EXPECT_FALSE (flag.valid (2));
+
+    const auto &mixed = table.columns[2];
+    EXPECT_EQ (mixed.type, ColumnType::STRING);
+    EXPECT_EQ (mixed.nullCount, 0u);
+    EXPECT_EQ (mixed.stringAt (0), "1");
+    EXPECT_EQ (mixed.stringAt (1), "x");
+    EXPECT_EQ (mixed.stringAt (2), "TRUE");
+
+    const auto &note = table.columns[3];
+    EXPECT_EQ (note.type, ColumnType::STRING);
+    EXPECT_EQ (note.stringAt (0), "a,b");
+    EXPECT_EQ (note.stringAt (1), "say \"hi\"");
+    EXPECT_FALSE (note.valid (2));
+    EXPECT_EQ (note.stringAt (2), "");
+
+    EXPECT_EQ (table.columns[4].type, ColumnType::EMPTY);
+    EXPECT_EQ (table.columns[4].nullCount, 3u);
+}
+
+// 列类型在取样后固定, 之后不符合的值记为空值
+TEST (CsvColumnsTest, TypeLockedAfterSample)
+{
+    std::string text;
+    for (int i = 0; i < 10; ++i)
+    {
+        text += std::to_string (i) + "\n";
+    }
+    text += "N/A\n-1e3\n";
+
+    const auto locked = columnsOf (text, 0, 10);
+    const auto &col = locked.columns[0];
+    ASSERT_EQ (col.type, ColumnType::NUMBER);
+    EXPECT_EQ (col.length, 12u);
+    EXPECT_EQ (col.nullCount, 1u);
+    EXPECT_FALSE (col.valid (10));
+    EXPECT_DOUBLE_EQ (col.numbers[11], -1000.0);
+
+    // 取样包含 "N/A" 时整列为字符串
+    EXPECT_EQ (columnsOf (text, 0, 11).columns[0].type, ColumnType::STRING);
+}
+
+// 记录字段数不同: 缺少的字段为空值
+TEST (CsvColumnsTest, RaggedRows)
+{
+    const auto table = columnsOf ("a,b,c\nx\n\"y\",z\n");
+    ASSERT_EQ (table.rows, 3u);
+    ASSERT_EQ (table.columns.size (), 3u);
+    EXPECT_EQ (table.columns[1].nullCount, 1u);
+    EXPECT_EQ (table.columns[1].stringAt (2), "z");
+    EXPECT_EQ (table.columns[2].nullCount, 2u);
+    EXPECT_EQ (table.columns[2].stringAt (2), "");
+}
@@ -0,0 +1,139 @@
+#include "../src/CsvReader.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+using Level = csvsimd::Level;
+
+namespace
+{
+
+const Level AllLevels[] = { Level::SCALAR, Level::SSE2, Level::AVX2 };
+
+// 引号字段中有换行和 "\r\n", 块边界的推测起点经常落在引号内
+std::string
+quotedCsv (std::mt19937 &rng, std::size_t n)
+{
+    std::string s;
+    while (s.size () < n)
+    {
+        switch (rng () % 6)
+        {
+        case 0:
+            s += "\"multi\nline,\"\"q\"\"\r\nfield\"";
+            break;
+        case 1:
+            s += rng () % 2 == 0 ? "\r\n" : "\n";
+            break;
+        case 2:
+            s += ',';
+            break;
+        case 3:
+            s += rng () % 4 == 0 ? "\r" : "x\"y";
+            break;
+        default:
+            s += "text";
+            break;
+        }
+        if (rng () % 5 == 0)
+        {
+            s += '\n';
+        }
+    }
+    return s;
+}
+
+} // namespace
+
+// 任意分块数下, 分块并行建立的索引都与顺序建立的相同
+TEST (CsvParallelTest, ChunkedIndexMatchesSerial)
+{
+    std::mt19937 rng (4);
+    for (int round = 0; round < 200; ++round)
+    {
+        auto text = quotedCsv (rng, 20 + rng () % 2000);
+        if (round % 10 == 0)
+        {
+            text = "\xEF\xBB\xBF" + text;
+        }
+        for (auto level : AllLevels)
+        {
+            const auto &kernels = csvsimd::kernels (level);
+            const auto serial = csv::indexRecords (text, {}, kernels);
+            for (std::size_t chunks : { 2, 3, 7, 64 })
+            {
+                const auto chunked = csv::detail::indexChunks (
+                    text, {}, chunks, 4, kernels);
+                ASSERT_EQ (chunked.starts, serial.starts)
+                    << csvsimd::levelName (level) << " chunks " << chunks;
+                ASSERT_EQ (chunked.columns, serial.columns);
+            }
+        }
+    }
+}
+
+// 整个文件是一个跨越所有块的引号字段
+TEST (CsvParallelTest, FieldSpanningAllChunks)
+{
+    std::string text = "a,\"";
+    for (int i = 0; i < 200; ++i)
+    {
+        text += "line,\n";
+    }
+    text += "\"\nb,c\n";
+    const auto chunked = csv::detail::indexChunks (text, {}, 16, 4,
+                                                   csvsimd::active ());
+    EXPECT_EQ (chunked.starts,
+               (std::vector<std::size_t>{ 0, text.size () - 4,
+                                          text.size () }));
+    EXPECT_EQ (chunked.columns, 2u);
+}
+
+TEST (CsvParallelTest, ForEachRowParallel)
+{
+    std::mt19937 rng (5);
+    const auto text = quotedCsv (rng, 1 << 16);
+    const auto path = fs::temp_directory_path () / "csvParallelTest.csv";
+    {
+        std::ofstream out (path, std::ios::binary);
+        out << text;
+    }
+
+    std::vector<std::vector<std::string>> expected;
+    csv::forEachRecord (text, {},
+                        [&expected] (const csv::CsvRow &row)
+                        {
+                            expected.emplace_back ();
+                            for (const auto &field : row)
+                            {
+                                expected.back ().push_back (field.text ());
+                            }
+                        });
+
+    CSVReader reader (path, {}, 4);
+    ASSERT_TRUE (reader.open ());
+    ASSERT_EQ (reader.rowCount (), expected.size ());
+
+    std::vector<std::vector<std::string>> rows (expected.size ());
+    std::vector<int> seen (expected.size ());
+    std::mutex lock;
+    reader.forEachRowParallel (0,
+                               [&] (const csv::CsvRow &row)
+                               {
+                                   std::vector<std::string> fields;
+                                   for (const auto &field : row)
+                                   {
+                                       fields.push_back (field.text ());
+                                   }
+                                   std::lock_guard<std::mutex> guard (lock);
+                                   rows[row.index ()] = std::move (fields);
+                                   ++seen[row.index ()];
+                               });
+    fs::remove (path);
+    EXPECT_EQ (rows, expected);
+    EXPECT_EQ (seen, std::vector<int> (expected.size (), 1));
+}
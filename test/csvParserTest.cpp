@@ -0,0 +1,88 @@
+#include "../src/CsvParser.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace csv;
+
+namespace
+{
+
+std::vector<std::vector<std::string>>
+parseAll (std::string_view text, const Dialect &dialect = {})
+{
+    std::vector<std::vector<std::string>> rows;
+    const auto index = indexRecords (text, dialect);
+    CsvRow row;
+    for (std::size_t r = 0; r < index.rowCount (); ++r)
+    {
+        row.parse (text, index, r, dialect);
+        rows.emplace_back ();
+        for (const auto &field : row)
+        {
+            rows.back ().push_back (field.text ());
+        }
+    }
+    return rows;
+}
+
+using Rows = std::vector<std::vector<std::string>>;
+
+} // namespace
+
+TEST (CsvParserTest, PlainFieldsAndLineEndings)
+{
+    EXPECT_EQ (parseAll ("a,b,c\n1,,3\r\nx\ry,z"),
+               (Rows{ { "a", "b", "c" }, { "1", "", "3" }, { "x" },
+                      { "y", "z" } }));
+    // 末尾换行不产生空记录, 中间的空行保留
+    EXPECT_EQ (parseAll ("a\n\nb\n"), (Rows{ { "a" }, { "" }, { "b" } }));
+    EXPECT_EQ (parseAll ("a,\n"), (Rows{ { "a", "" } }));
+    EXPECT_TRUE (parseAll ("").empty ());
+}
+
+TEST (CsvParserTest, QuotedFields)
+{
+    const std::string text = "\"a,b\",\"line\nbreak\",\"say \"\"hi\"\"\"\n"
+                             "\"\",\"x\"tail,\"open";
+    EXPECT_EQ (parseAll (text),
+               (Rows{ { "a,b", "line\nbreak", "say \"hi\"" },
+                      { "", "xtail", "open" } }));
+
+    // 不含转义的引号字段直接指向输入
+    const auto index = indexRecords (text);
+    CsvRow row;
+    row.parse (text, index, 0, {});
+    EXPECT_TRUE (row[0].quoted);
+    EXPECT_FALSE (row[0].escaped);
+    EXPECT_EQ (row[0].raw.data (), text.data () + 1);
+    EXPECT_TRUE (row[2].escaped);
+    EXPECT_EQ (row[7].raw.data (), nullptr);
+}
+
+TEST (CsvParserTest, DialectAndBom)
+{
+    Dialect dialect;
+    dialect.delimiter = ';';
+    dialect.quote = '\'';
+    EXPECT_EQ (parseAll ("\xEF\xBB\xBFk;'v;w'\n'it''s';2", dialect),
+               (Rows{ { "k", "v;w" }, { "it's", "2" } }));
+
+    const auto index = indexRecords ("a;b;c\nd", dialect);
+    EXPECT_EQ (index.rowCount (), 2u);
+    EXPECT_EQ (index.columns, 3u);
+}
+
+TEST (CsvParserTest, Classify)
+{
+    EXPECT_EQ (classify (""), CellType::BLANK);
+    EXPECT_EQ (classify ("12"), CellType::NUMBER);
+    EXPECT_EQ (classify ("-1.5e3"), CellType::NUMBER);
+    EXPECT_EQ (classify (".5"), CellType::NUMBER);
+    EXPECT_EQ (classify ("true"), CellType::BOOL);
+    EXPECT_EQ (classify ("FALSE"), CellType::BOOL);
+    EXPECT_EQ (classify ("nan"), CellType::STRING);
+    EXPECT_EQ (classify ("12abc"), CellType::STRING);
+    EXPECT_EQ (classify ("-"), CellType::STRING);
+}
@@ -0,0 +1,199 @@
+#include "../src/CsvParser.h"
+#include "../src/CsvSimd.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace csvsimd;
+
+namespace
+{
+
+const Level AllLevels[] = { Level::SCALAR, Level::SSE2, Level::AVX2 };
+
+using Rows = std::vector<std::vector<std::string>>;
+
+std::string
+randomCsv (std::mt19937 &rng, std::size_t n, bool wellFormed)
+{
+    std::string s;
+    while (s.size () < n)
+    {
+        switch (rng () % 8)
+        {
+        case 0:
+            s += ',';
+            break;
+        case 1:
+            s += rng () % 3 == 0 ? "\r\n" : "\n";
+            break;
+        case 2:
+            // 引号字段, 可能含转义, 分隔符和换行
+            if (s.empty () || s.back () == ',' || s.back () == '\n')
+            {
+                s += "\"a,\"\"b\nc\"";
+            }
+            break;
+        case 3:
+            if (!wellFormed)
+            {
+                s += rng () % 2 == 0 ? "x\"y" : "\"q\"z";
+            }
+            break;
+        case 4:
+            s += '\r';
+            break;
+        default:
+            s += "text";
+            break;
+        }
+    }
+    return s;
+}
+
+// 逐字节分词的结果, 作为对照
+Rows
+scalarRows (std::string_view text)
+{
+    Rows rows;
+    const char *p = text.data () + csv::bomLength (text);
+    const char *end = text.data () + text.size ();
+    while (p < end)
+    {
+        rows.emplace_back ();
+        p = csv::parseRecord (p, end, {},
+                              [&rows] (const csv::CsvField &field)
+                              { rows.back ().push_back (field.text ()); });
+    }
+    return rows;
+}
+
+Rows
+blockRows (std::string_view text, const Kernels &kernels)
+{
+    Level saved = active ().level;
+    setActive (kernels.level);
+    Rows rows;
+    csv::forEachRecord (text, {},
+                        [&rows] (const csv::CsvRow &row)
+                        {
+                            rows.emplace_back ();
+                            for (const auto &field : row)
+                            {
+                                rows.back ().push_back (field.text ());
+                            }
+                        });
+    setActive (saved);
+    return rows;
+}
+
+} // namespace
+
+TEST (CsvSimdTest, KernelsMatchScalar)
+{
+    std::mt19937 rng (1);
+    static const char alphabet[] = ";,\"\n\ra'\t";
+    for (int round = 0; round < 200; ++round)
+    {
+        std::string buf (64, ' ');
+        for (auto &c : buf)
+        {
+            c = alphabet[rng () % (sizeof alphabet - 1)];
+        }
+        BlockMasks expected;
+        detail::classifyTail (buf.data (), 64, ';', '\'', expected);
+        for (auto level : AllLevels)
+        {
+            BlockMasks got;
+            kernels (level).classify (buf.data (), ';', '\'', got);
+            EXPECT_EQ (got.quote, expected.quote) << levelName (level);
+            EXPECT_EQ (got.delimiter, expected.delimiter) << levelName (level);
+            EXPECT_EQ (got.newline, expected.newline) << levelName (level);
+            EXPECT_EQ (got.cr, expected.cr) << levelName (level);
+        }
+    }
+}
+
+TEST (CsvSimdTest, PrefixXor)
+{
+    std::mt19937_64 rng (2);
+    for (int round = 0; round < 1000; ++round)
+    {
+        const uint64_t bits = rng ();
+        uint64_t expected = 0;
+        unsigned parity = 0;
+        for (unsigned i = 0; i < 64; ++i)
+        {
+            parity ^= (bits >> i) & 1;
+            expected |= uint64_t (parity) << i;
+        }
+        for (auto level : AllLevels)
+        {
+            EXPECT_EQ (kernels (level).prefixXor (bits), expected);
+        }
+    }
+}
+
+// 引号跨块, "\r\n" 跨块
+TEST (CsvSimdTest, QuotesAndCrlfAcrossBlocks)
+{
+    const std::string text = std::string (62, 'a') + ",\""
+                             + std::string (70, 'b') + ",\n\"\"x\",c\r\n"
+                             + std::string (63, 'd') + "\r\nlast";
+    const auto expected = scalarRows (text);
+    ASSERT_EQ (expected.size (), 3u);
+    for (auto level : AllLevels)
+    {
+        EXPECT_EQ (blockRows (text, kernels (level)), expected)
+            << levelName (level);
+    }
+}
+
+// 字段中间的引号 (如 5'11") 使位图失效, 从当前记录起改用逐字节分词
+TEST (CsvSimdTest, MalformedQuoteFallsBack)
+{
+    const std::string text = "h,w\n" + std::string (100, 'x')
+                             + ",5ft 11\"\nnext,\"a,b\"\n";
+    const Rows expected{ { "h", "w" },
+                         { std::string (100, 'x'), "5ft 11\"" },
+                         { "next", "a,b" } };
+    ASSERT_EQ (scalarRows (text), expected);
+    for (auto level : AllLevels)
+    {
+        EXPECT_EQ (blockRows (text, kernels (level)), expected)
+            << levelName (level);
+        const auto index = csv::indexRecords (text, {}, kernels (level));
+        EXPECT_EQ (index.starts,
+                   (std::vector<std::size_t>{ 0, 4, 113, text.size () }));
+        EXPECT_EQ (index.columns, 2u);
+    }
+}
+
+// 随机输入: 块位图分词, 索引与逐字节分词完全一致
+TEST (CsvSimdTest, RandomInputsMatchScalar)
+{
+    std::mt19937 rng (3);
+    for (int round = 0; round < 300; ++round)
+    {
+        const auto text = randomCsv (rng, 50 + rng () % 600, round % 2 == 0);
+        const auto expected = scalarRows (text);
+
+        csv::CsvIndex scalarIndex;
+        const char *end = text.data () + text.size ();
+        csv::detail::indexScalar (text.data (), text.data (), end, end, {},
+                                  scalarIndex);
+        scalarIndex.starts.push_back (text.size ());
+
+        for (auto level : AllLevels)
+        {
+            ASSERT_EQ (blockRows (text, kernels (level)), expected)
+                << levelName (level) << " " << text;
+            const auto index = csv::indexRecords (text, {}, kernels (level));
+            ASSERT_EQ (index.starts, scalarIndex.starts) << levelName (level);
+            ASSERT_EQ (index.columns, scalarIndex.columns)
+                << levelName (level);
+        }
+    }
+}
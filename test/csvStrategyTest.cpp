@@ -0,0 +1,106 @@
+#include "../src/CsvReader.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// 写入临时 CSV 文件, 测试结束时删除
+class TempCsv
+{
+  private:
+    fs::path path_;
+
+  public:
+    TempCsv (const char *name, const std::string &content)
+        : path_ (fs::temp_directory_path () / name)
+    {
+        std::ofstream out (path_, std::ios::binary);
+        out << content;
+    }
+    ~TempCsv () { fs::remove (path_); }
+
+    const fs::path &
+    path () const
+    {
+        return path_;
+    }
+};
+
+} // namespace
+
+TEST (CsvStrategyTest, OpenMissingFile)
+{
+    CSVReader reader (fs::temp_directory_path () / "no_such_file.csv");
+    EXPECT_FALSE (reader.open ());
+    EXPECT_EQ (reader.getSheetsCount (), 0u);
+}
+
+TEST (CsvStrategyTest, ReadCellTypes)
+{
+    TempCsv file ("csvStrategyTest_types.csv",
+                  "name,value,flag\n\"Smith, J\",3.5,TRUE\nx,,\"7\"\n");
+    CSVReader reader (file.path ());
+    ASSERT_TRUE (reader.open ());
+    EXPECT_EQ (reader.getSheetsCount (), 1u);
+    EXPECT_EQ (reader.getSheetName (0), "csvStrategyTest_types");
+    EXPECT_EQ (reader.rowCount (), 3u);
+    EXPECT_EQ (reader.colCount (), 3u);
+
+    EXPECT_EQ (reader.readCell (0, 0, 0), CellType::STRING);
+    EXPECT_EQ (reader.readCell (0, 1, 1), CellType::NUMBER);
+    EXPECT_EQ (reader.readCell (0, 1, 2), CellType::BOOL);
+    EXPECT_EQ (reader.readCell (0, 2, 1), CellType::BLANK);
+    EXPECT_EQ (reader.readCell (0, 2, 2), CellType::NUMBER);
+    EXPECT_EQ (reader.readCell (0, 2, 5), CellType::BLANK);
+    EXPECT_EQ (reader.readCell (0, 9, 0), CellType::BLANK);
+    EXPECT_EQ (reader.field (0, 1, 0).text (), "Smith, J");
+    EXPECT_THROW (reader.readCell (1, 0, 0), ExcelReader::IndexOutException);
+}
+
+TEST (CsvStrategyTest, IterateRows)
+{
+    TempCsv file ("csvStrategyTest_rows.csv", "a,b\n\"1\n2\",3\n\n4");
+    CSVReader reader (file.path ());
+    ASSERT_TRUE (reader.open ());
+
+    std::vector<std::size_t> sizes;
+    std::vector<std::string> first;
+    reader.forEachRow (0,
+                       [&] (const csv::CsvRow &row)
+                       {
+                           sizes.push_back (row.size ());
+                           first.push_back (row[0].text ());
+                       });
+    EXPECT_EQ (sizes, (std::vector<std::size_t>{ 2, 2, 1, 1 }));
+    EXPECT_EQ (first, (std::vector<std::string>{ "a", "1\n2", "", "4" }));
+}
+
+TEST (CsvStrategyTest, EmptyFile)
+{
+    TempCsv file ("csvStrategyTest_empty.csv", "");
+    CSVReader reader (file.path ());
+    ASSERT_TRUE (reader.open ());
+    EXPECT_EQ (reader.rowCount (), 0u);
+    EXPECT_EQ (reader.readCell (0, 0, 0), CellType::BLANK);
+}
+
+// 内存中的文本与文件读取结果相同, 字段直接指向调用方的数据
+TEST (CsvStrategyTest, OpenFromMemory)
+{
+    const std::string text = "a,b\n1,\"x,y\"\n";
+    const Span<const std::byte> data (
+        reinterpret_cast<const std::byte *> (text.data ()), text.size ());
+    CSVReader reader (data);
+    ASSERT_TRUE (reader.open ());
+    EXPECT_EQ (reader.getSheetsCount (), 1u);
+    EXPECT_EQ (reader.getSheetName (0), "");
+    EXPECT_EQ (reader.rowCount (), 2u);
+    EXPECT_EQ (reader.readCell (0, 1, 0), CellType::NUMBER);
+
+    const auto field = reader.field (0, 0, 1);
+    EXPECT_EQ (field.raw.data (), text.data () + 2);
+}
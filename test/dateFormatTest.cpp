@@ -0,0 +1,163 @@
+#include "../src/DateFormatCache.h"
+#include "../src/XlsCellView.h"
+#include "sheetBuilder.h"
+
+#include <gtest/gtest.h>
+
+// 内置格式位图在编译期可用
+static_assert (isDateTime (14));
+static_assert (isDateTime (22));
+static_assert (!isDateTime (23));
+static_assert (isDateTime (81));
+static_assert (!isDateTime (164));
+static_assert (isDateFormatCode ("yyyy-mm-dd"));
+static_assert (!isDateFormatCode ("#,##0.00"));
+
+TEST (DateFormatTest, BuiltinIds)
+{
+    for (int id = 0; id < 200; ++id)
+    {
+        bool expected = (id >= 14 && id <= 22) || (id >= 27 && id <= 36)
+                        || (id >= 45 && id <= 47) || (id >= 50 && id <= 58)
+                        || (id >= 71 && id <= 81);
+        EXPECT_EQ (isDateTime (id), expected) << id;
+    }
+    EXPECT_FALSE (isDateTime (-1));
+}
+
+TEST (DateFormatTest, FormatCodes)
+{
+    EXPECT_TRUE (isDateFormatCode ("m/d/yy"));
+    EXPECT_TRUE (isDateFormatCode ("h:mm AM/PM"));
+    EXPECT_TRUE (isDateFormatCode ("[$-409]mmmm d, yyyy"));
+    EXPECT_TRUE (isDateFormatCode ("[h]:mm:ss"));
+    EXPECT_TRUE (isDateFormatCode ("[Red]yyyy"));
+
+    EXPECT_FALSE (isDateFormatCode ("General"));
+    EXPECT_FALSE (isDateFormatCode ("0.00E+00"));
+    EXPECT_FALSE (isDateFormatCode ("[Red]#,##0;-#,##0"));
+    // 以 h / m / s 开头的颜色不是经过时间
+    EXPECT_FALSE (isDateFormatCode ("[Magenta]0.00"));
+    EXPECT_FALSE (isDateFormatCode ("[Black]#,##0"));
+    EXPECT_FALSE (isDateFormatCode ("0 \"days\""));
+    EXPECT_FALSE (isDateFormatCode ("0\\m"));
+    EXPECT_FALSE (isDateFormatCode ("#,##0_);(#,##0)"));
+    EXPECT_FALSE (isDateFormatCode ("@"));
+    EXPECT_FALSE (isDateFormatCode ("\"unterminated"));
+}
+
+// 工作簿中的自定义格式按格式字符串分类, XF 通过格式 id 查表
+TEST (DateFormatTest, WorkbookCache)
+{
+    using FormatData = std::remove_pointer_t<decltype (xls::st_format::format)>;
+    using XfData = std::remove_pointer_t<decltype (xls::st_xf::xf)>;
+
+    char dateCode[] = "yyyy\\-mm\\-dd";
+    char numberCode[] = "0.000";
+    FormatData formats[2] = {};
+    formats[0].index = 164;
+    formats[0].value = dateCode;
+    formats[1].index = 165;
+    formats[1].value = numberCode;
+
+    XfData xfs[4] = {};
+    xfs[0].format = 0;
+    xfs[1].format = 14;
+    xfs[2].format = 164;
+    xfs[3].format = 165;
+
+    xls::xlsWorkBook wb{};
+    wb.formats.count = 2;
+    wb.formats.format = formats;
+    wb.xfs.count = 4;
+    wb.xfs.xf = xfs;
+
+    DateFormatCache cache (&wb);
+    EXPECT_TRUE (cache.isDateFormat (14));
+    EXPECT_TRUE (cache.isDateFormat (164));
+    EXPECT_FALSE (cache.isDateFormat (165));
+    EXPECT_FALSE (cache.isDateFormat (1000));
+
+    EXPECT_FALSE (cache.isDateXf (0));
+    EXPECT_TRUE (cache.isDateXf (1));
+    EXPECT_TRUE (cache.isDateXf (2));
+    EXPECT_FALSE (cache.isDateXf (3));
+    EXPECT_FALSE (cache.isDateXf (4));
+
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 45000.0, 2);
+    addNumber (sheet, 0, 1, 1.5, 3);
+    sheet.finalize ();
+    EXPECT_EQ (XlsCellView (sheet.find (0, 0), &cache).type (), CellType::DATE);
+    EXPECT_EQ (XlsCellView (sheet.find (0, 1), &cache).type (),
+               CellType::NUMBER);
+}
+
+TEST (DateFormatTest, FormatKinds)
+{
+    EXPECT_EQ (builtinFormatKind (0), NumberKind::NUMBER);
+    EXPECT_EQ (builtinFormatKind (10), NumberKind::PERCENT);
+    EXPECT_EQ (builtinFormatKind (14), NumberKind::DATE);
+    EXPECT_EQ (builtinFormatKind (20), NumberKind::TIME);
+    EXPECT_EQ (builtinFormatKind (22), NumberKind::DATE);
+    EXPECT_EQ (builtinFormatKind (46), NumberKind::TIME);
+    EXPECT_EQ (builtinFormatKind (49), NumberKind::TEXT);
+
+    EXPECT_EQ (classifyFormatCode ("mmm-yy"), NumberKind::DATE);
+    EXPECT_EQ (classifyFormatCode ("mmmm"), NumberKind::DATE);
+    EXPECT_EQ (classifyFormatCode ("yyyy-mm-dd hh:mm"), NumberKind::DATE);
+    EXPECT_EQ (classifyFormatCode ("hh:mm"), NumberKind::TIME);
+    EXPECT_EQ (classifyFormatCode ("mm:ss.0"), NumberKind::TIME);
+    EXPECT_EQ (classifyFormatCode ("[mm]:ss"), NumberKind::TIME);
+    EXPECT_EQ (classifyFormatCode ("[SS].00"), NumberKind::TIME);
+    EXPECT_EQ (classifyFormatCode ("[Magenta]0.00"), NumberKind::NUMBER);
+    EXPECT_EQ (classifyFormatCode ("[Black]0%"), NumberKind::PERCENT);
+    EXPECT_EQ (classifyFormatCode ("[hm]0"), NumberKind::NUMBER);
+    EXPECT_EQ (classifyFormatCode ("0.0%"), NumberKind::PERCENT);
+    EXPECT_EQ (classifyFormatCode ("0 \"%\""), NumberKind::NUMBER);
+    EXPECT_EQ (classifyFormatCode ("@"), NumberKind::TEXT);
+    EXPECT_EQ (classifyFormatCode ("0;[Red]\"d\"0"), NumberKind::NUMBER);
+}
+
+// XF 下标直接映射到种类
+TEST (DateFormatTest, XfKinds)
+{
+    using FormatData = std::remove_pointer_t<decltype (xls::st_format::format)>;
+    using XfData = std::remove_pointer_t<decltype (xls::st_xf::xf)>;
+
+    char timeCode[] = "h:mm:ss";
+    FormatData formats[1] = {};
+    formats[0].index = 170;
+    formats[0].value = timeCode;
+
+    XfData xfs[4] = {};
+    xfs[0].format = 170;
+    xfs[1].format = 9;
+    xfs[2].format = 49;
+    xfs[3].format = 2;
+
+    xls::xlsWorkBook wb{};
+    wb.formats.count = 1;
+    wb.formats.format = formats;
+    wb.xfs.count = 4;
+    wb.xfs.xf = xfs;
+
+    DateFormatCache cache (&wb);
+    EXPECT_EQ (cache.xfKind (0), NumberKind::TIME);
+    EXPECT_EQ (cache.xfKind (1), NumberKind::PERCENT);
+    EXPECT_EQ (cache.xfKind (2), NumberKind::TEXT);
+    EXPECT_EQ (cache.xfKind (3), NumberKind::NUMBER);
+    EXPECT_EQ (cache.xfKind (99), NumberKind::NUMBER);
+
+    // XF 14 不是格式 14, 不应按日期处理
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 0.5);
+    addNumber (sheet, 0, 1, 1.0, 14);
+    sheet.finalize ();
+    XlsCellView time (sheet.find (0, 0), &cache);
+    EXPECT_EQ (time.numberKind (), NumberKind::TIME);
+    EXPECT_EQ (time.type (), CellType::DATE);
+    EXPECT_EQ (time.toCell ().type (), CellType::DATE);
+    EXPECT_EQ (XlsCellView (sheet.find (0, 1), &cache).type (),
+               CellType::NUMBER);
+}
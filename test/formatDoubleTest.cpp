@@ -0,0 +1,106 @@
+#include "../src/XlsCell.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+// 原 ostringstream 实现, 作为输出格式的基准
+std::string
+legacyFormat (double value)
+{
+    std::ostringstream oss;
+    double intpart;
+    if (std::modf (value, &intpart) == 0.0)
+    {
+        if (value >= std::numeric_limits<int64_t>::min ()
+            && value < 0x1p63)
+        {
+            oss << static_cast<int64_t> (value);
+        }
+        else
+        {
+            oss << std::fixed << std::setprecision (0) << value;
+        }
+        return oss.str ();
+    }
+
+    oss << std::setprecision (15) << value;
+    std::string str = oss.str ();
+    if (str.find ('.') != std::string::npos)
+    {
+        str.erase (str.find_last_not_of ('0') + 1, std::string::npos);
+        if (!str.empty () && str.back () == '.')
+        {
+            str.pop_back ();
+        }
+    }
+    return str;
+}
+
+std::string
+format (double value)
+{
+    char buf[XlsCell::MaxDoubleLength];
+    return { buf, XlsCell::formatDouble (value, buf) };
+}
+
+} // namespace
+
+TEST (FormatDoubleTest, KnownValues)
+{
+    EXPECT_EQ (format (0.0), "0");
+    EXPECT_EQ (format (-0.0), "0");
+    EXPECT_EQ (format (42.0), "42");
+    EXPECT_EQ (format (-7.0), "-7");
+    EXPECT_EQ (format (0.1), "0.1");
+    EXPECT_EQ (format (1.0 / 3.0), "0.333333333333333");
+    EXPECT_EQ (format (2.5e-7), "2.5e-07");
+    EXPECT_EQ (format (1e20), "100000000000000000000");
+    EXPECT_EQ (format (std::numeric_limits<double>::infinity ()), "inf");
+}
+
+// 与原实现逐字节一致
+TEST (FormatDoubleTest, MatchesLegacyFormatting)
+{
+    const double special[] = {
+        std::numeric_limits<double>::max (),
+        std::numeric_limits<double>::lowest (),
+        std::numeric_limits<double>::min (),
+        std::numeric_limits<double>::denorm_min (),
+        -std::numeric_limits<double>::infinity (),
+        0x1p63,
+        -0x1p63,
+        9007199254740993.0,
+        123456.789,
+        45123.5,
+    };
+    for (double value : special)
+    {
+        EXPECT_EQ (format (value), legacyFormat (value)) << value;
+    }
+
+    std::mt19937_64 rng (20240601);
+    std::uniform_real_distribution<double> small (-1e6, 1e6);
+    std::uniform_int_distribution<int> exponent (-300, 300);
+    for (int i = 0; i < 100000; ++i)
+    {
+        double value = small (rng);
+        if (i % 2 == 1)
+        {
+            value = std::ldexp (value, exponent (rng));
+        }
+        if (i % 5 == 0)
+        {
+            value = std::round (value);
+        }
+        ASSERT_EQ (format (value), legacyFormat (value)) << value;
+    }
+}
@@ -0,0 +1,42 @@
+#include "../src/Parallel.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// 每个下标恰好执行一次
+TEST (ParallelForTest, VisitsEveryIndexOnce)
+{
+    for (std::size_t threads : { 1u, 2u, 8u })
+    {
+        std::vector<std::atomic<int>> hits (1000);
+        parallelFor (hits.size (), threads,
+                     [&] (std::size_t i) { ++hits[i]; });
+        for (const auto &hit : hits)
+        {
+            EXPECT_EQ (hit.load (), 1);
+        }
+    }
+}
+
+TEST (ParallelForTest, ZeroCountDoesNothing)
+{
+    int calls = 0;
+    parallelFor (0, 4, [&] (std::size_t) { ++calls; });
+    EXPECT_EQ (calls, 0);
+}
+
+// 任务中的异常在调用方重新抛出
+TEST (ParallelForTest, RethrowsTaskException)
+{
+    EXPECT_THROW (parallelFor (100, 4,
+                               [] (std::size_t i)
+                               {
+                                   if (i == 42)
+                                   {
+                                       throw std::runtime_error ("task");
+                                   }
+                               }),
+                  std::runtime_error);
+}
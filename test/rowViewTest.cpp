@@ -0,0 +1,115 @@
+#include "../src/RowView.h"
+#include "sheetBuilder.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+
+SparseSheet
+makeSheet ()
+{
+    // 行 0: A B C, 行 5: D, 行 7: A C
+    SparseSheet sheet;
+    const std::pair<uint16_t, uint16_t> cells[]
+        = { { 0, 0 }, { 0, 1 }, { 0, 2 }, { 5, 3 }, { 7, 0 }, { 7, 2 } };
+    for (const auto &[row, col] : cells)
+    {
+        addNumber (sheet, row, col, row * 10 + col);
+    }
+    sheet.finalize ();
+    return sheet;
+}
+
+} // namespace
+
+// 只遍历非空行, 行内按列顺序
+TEST (RowViewTest, IteratesPopulatedRowsInOrder)
+{
+    auto sheet = makeSheet ();
+
+    std::vector<std::size_t> rows;
+    std::vector<double> values;
+    for (const auto &row : XlsSheetRows (sheet))
+    {
+        rows.push_back (row.index ());
+        for (auto cell : row)
+        {
+            values.push_back (cell.asDouble ());
+        }
+    }
+
+    EXPECT_EQ (rows, (std::vector<std::size_t>{ 0, 5, 7 }));
+    EXPECT_EQ (values, (std::vector<double>{ 0, 1, 2, 53, 70, 72 }));
+}
+
+TEST (RowViewTest, FindByColumn)
+{
+    auto sheet = makeSheet ();
+    auto row = *(++XlsSheetRows (sheet).begin ());
+
+    EXPECT_EQ (row.index (), 5u);
+    ASSERT_TRUE (row.find (3).valid ());
+    EXPECT_DOUBLE_EQ (row.find (3).asDouble (), 53.0);
+    EXPECT_FALSE (row.find (0).valid ());
+}
+
+// 行内迭代器支持随机访问: 反向遍历, 按列二分查找
+TEST (RowViewTest, CellIteratorIsRandomAccess)
+{
+    auto sheet = makeSheet ();
+    auto row = *XlsSheetRows (sheet).begin ();
+
+    EXPECT_EQ ((*std::prev (row.end ())).col (), 2u);
+    EXPECT_EQ ((*(row.end () - 1)).col (), 2u);
+    EXPECT_EQ ((*(2 + row.begin ())).col (), 2u);
+    EXPECT_EQ (row.begin ()[1].col (), 1u);
+
+    std::vector<std::size_t> cols;
+    for (auto it = std::make_reverse_iterator (row.end ());
+         it != std::make_reverse_iterator (row.begin ()); ++it)
+    {
+        cols.push_back ((*it).col ());
+    }
+    EXPECT_EQ (cols, (std::vector<std::size_t>{ 2, 1, 0 }));
+
+    auto it = row.end ();
+    it -= 2;
+    EXPECT_EQ ((*it--).col (), 1u);
+    EXPECT_EQ (it, row.begin ());
+    EXPECT_TRUE (row.begin () < row.end ());
+    EXPECT_TRUE (row.end () >= row.begin ());
+    EXPECT_FALSE (row.begin () > row.begin ());
+    EXPECT_TRUE (row.begin () <= row.begin ());
+
+    auto found = std::lower_bound (row.begin (), row.end (), 1u,
+                                   [] (XlsCellView cell, std::size_t col)
+                                   { return cell.col () < col; });
+    EXPECT_EQ (found - row.begin (), 1);
+}
+
+TEST (RowViewTest, EmptySheetHasNoRows)
+{
+    SparseSheet sheet;
+    sheet.finalize ();
+
+    XlsSheetRows rows (sheet);
+    EXPECT_EQ (rows.begin (), rows.end ());
+}
+
+// 回调返回 false 时提前结束
+TEST (RowViewTest, ForEachRowStopsEarly)
+{
+    auto sheet = makeSheet ();
+
+    std::size_t visited = 0;
+    forEachRow (sheet, [&] (const XlsRowView &) { return ++visited < 2; });
+    EXPECT_EQ (visited, 2u);
+
+    std::size_t cells = 0;
+    forEachRow (sheet, [&] (const XlsRowView &row) { cells += row.size (); });
+    EXPECT_EQ (cells, 6u);
+}
@@ -0,0 +1,39 @@
+#ifndef TEST_SHEETBUILDER_H
+#define TEST_SHEETBUILDER_H
+
+#include "../src/SparseSheet.h"
+
+#include <cstdint>
+#include <cstring>
+
+// 测试中逐格构造 SparseSheet, 调用方在读取前自行 finalize ()
+
+// 追加一个单元格, 返回其引用以便设置 d / l / str
+inline xls::xlsCell &
+addCell (SparseSheet &sheet, uint16_t row, uint16_t col, uint16_t id,
+         uint16_t xf = 0)
+{
+    return sheet.at (sheet.append (row, col, id, xf));
+}
+
+inline xls::xlsCell &
+addNumber (SparseSheet &sheet, uint16_t row, uint16_t col, double value,
+           uint16_t xf = 0)
+{
+    auto &cell = addCell (sheet, row, col, XLS_RECORD_NUMBER, xf);
+    cell.d = value;
+    return cell;
+}
+
+// 带文本的单元格, 默认为 LABELSST; 也用于 str 有含义的 BOOLERR / FORMULA
+// 等记录. 文本复制一份, 由 SparseSheet 释放
+inline xls::xlsCell &
+addLabel (SparseSheet &sheet, uint16_t row, uint16_t col, const char *text,
+          uint16_t id = XLS_RECORD_LABELSST)
+{
+    auto &cell = addCell (sheet, row, col, id);
+    cell.str = strdup (text);
+    return cell;
+}
+
+#endif
@@ -0,0 +1,265 @@
+#include "../src/SheetParser.h"
+#include "../src/XlsCellView.h"
+
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifndef LIBXLS_TEST_DATA_DIR
+#define LIBXLS_TEST_DATA_DIR "third-party/libxls/test/files"
+#endif
+
+namespace
+{
+
+void
+putU16 (std::vector<xls::BYTE> &out, uint16_t value)
+{
+    out.push_back (static_cast<xls::BYTE> (value & 0xff));
+    out.push_back (static_cast<xls::BYTE> (value >> 8));
+}
+
+void
+putU32 (std::vector<xls::BYTE> &out, uint32_t value)
+{
+    putU16 (out, static_cast<uint16_t> (value & 0xffff));
+    putU16 (out, static_cast<uint16_t> (value >> 16));
+}
+
+// BIFF8 DIMENSIONS, 行列上界不含
+void
+putDimensions (std::vector<xls::BYTE> &out, uint32_t rows, uint16_t cols)
+{
+    putU16 (out, biff::DimensionsRecord);
+    putU16 (out, 14);
+    putU32 (out, 0);
+    putU32 (out, rows);
+    putU16 (out, 0);
+    putU16 (out, cols);
+    putU16 (out, 0);
+}
+
+void
+putNumber (std::vector<xls::BYTE> &out, uint16_t row, uint16_t col,
+           double value)
+{
+    putU16 (out, XLS_RECORD_NUMBER);
+    putU16 (out, 14);
+    putU16 (out, row);
+    putU16 (out, col);
+    putU16 (out, 0);
+    xls::BYTE bytes[8];
+    std::memcpy (bytes, &value, sizeof bytes);
+    out.insert (out.end (), bytes, bytes + 8);
+}
+
+void
+putEof (std::vector<xls::BYTE> &out)
+{
+    putU16 (out, XLS_RECORD_EOF);
+    putU16 (out, 0);
+}
+
+// 三个数值单元格, 前面是给定的 DIMENSIONS
+std::vector<xls::BYTE>
+sheetWithDimensions (uint32_t rows, uint16_t cols)
+{
+    std::vector<xls::BYTE> data;
+    putDimensions (data, rows, cols);
+    putNumber (data, 0, 0, 1.5);
+    putNumber (data, 2, 3, 2.5);
+    putNumber (data, 9, 1, 3.5);
+    putEof (data);
+    return data;
+}
+
+} // namespace
+
+TEST (SheetParserTest, ReadDimensions)
+{
+    xls::xlsWorkBook wb{};
+    std::vector<xls::BYTE> data;
+    putDimensions (data, 65536, 256);
+
+    biff::Dimensions dims;
+    ASSERT_TRUE (biff::readDimensions (&wb, 14, data.data () + 4, dims));
+    EXPECT_EQ (dims.lastRow, 65536u);
+    EXPECT_EQ (dims.lastCol, 256u);
+    EXPECT_EQ (dims.cellCount (), 65536u * 256u);
+
+    // 记录过短, 超出 BIFF 上限
+    EXPECT_FALSE (biff::readDimensions (&wb, 10, data.data () + 4, dims));
+    data.clear ();
+    putDimensions (data, 65537, 1);
+    EXPECT_FALSE (biff::readDimensions (&wb, 14, data.data () + 4, dims));
+
+    // BIFF5: 行号为 16 位
+    wb.is5ver = 1;
+    const xls::BYTE biff5[] = { 1, 0, 5, 0, 0, 0, 3, 0, 0, 0 };
+    ASSERT_TRUE (biff::readDimensions (&wb, 10, biff5, dims));
+    EXPECT_EQ (dims.cellCount (), 12u);
+}
+
+// DIMENSIONS 偏小, 偏大或缺失时只影响预留容量, 解码结果相同
+TEST (SheetParserTest, DimensionsOnlyAffectCapacity)
+{
+    xls::xlsWorkBook wb{};
+    for (auto data : { sheetWithDimensions (10, 4), sheetWithDimensions (1, 1),
+                       sheetWithDimensions (65536, 256),
+                       sheetWithDimensions (0, 0) })
+    {
+        SparseSheet sheet;
+        ASSERT_EQ (decodeSheetStream (&wb, data, sheet), xls::LIBXLS_OK);
+        EXPECT_EQ (sheet.cellCount (), 3u);
+        EXPECT_EQ (sheet.rowCount (), 10u);
+        EXPECT_EQ (sheet.colCount (), 4u);
+        ASSERT_NE (sheet.find (2, 3), nullptr);
+        EXPECT_DOUBLE_EQ (sheet.find (2, 3)->d, 2.5);
+    }
+}
+
+// 按 DIMENSIONS 预留, 但不超过记录流能容纳的单元格数
+TEST (SheetParserTest, ReservationIsBoundedByStream)
+{
+    xls::xlsWorkBook wb{};
+    for (auto [rows, cols, expected] :
+         { std::make_tuple (10u, uint16_t (4), 40u),
+           std::make_tuple (65536u, uint16_t (256), 100u) })
+    {
+        std::vector<xls::BYTE> data;
+        putDimensions (data, rows, cols);
+
+        SparseSheet sheet;
+        biff::SheetDecoder decoder (&wb, sheet, 100);
+        ASSERT_TRUE (decoder.record (biff::DimensionsRecord, 14,
+                                     data.data () + 4));
+        EXPECT_EQ (sheet.memoryUsage (), expected * sizeof (xls::xlsCell));
+    }
+}
+
+// 不含单元格的 MULRK / MULBLANK 不产生单元格, 之后的 STRING 记录不会
+// 写到其它单元格上
+TEST (SheetParserTest, EmptyMulRecordsOwnNoCell)
+{
+    xls::xlsWorkBook wb{};
+    const xls::BYTE mul[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    const xls::BYTE str[] = { 1, 0, 0, 'x' };
+    std::vector<xls::BYTE> number;
+    putNumber (number, 0, 0, 1.5);
+
+    for (uint16_t id : { XLS_RECORD_MULRK, XLS_RECORD_MULBLANK })
+    {
+        const uint16_t size = id == XLS_RECORD_MULRK ? 11 : 7;
+        SparseSheet sheet;
+        biff::SheetDecoder decoder (&wb, sheet, 100, nullptr,
+                                    ParseMode::VALUES_ONLY);
+        EXPECT_EQ (biff::addCell (&wb, sheet, id, size, mul), -1);
+        ASSERT_TRUE (decoder.record (id, size, mul));
+        ASSERT_TRUE (decoder.record (XLS_RECORD_STRING, sizeof str, str));
+        EXPECT_EQ (sheet.cellCount (), 0u);
+
+        ASSERT_TRUE (decoder.record (XLS_RECORD_NUMBER, 14,
+                                     number.data () + 4));
+        ASSERT_TRUE (decoder.record (id, size, mul));
+        ASSERT_TRUE (decoder.record (XLS_RECORD_STRING, sizeof str, str));
+        ASSERT_EQ (sheet.cellCount (), 1u);
+        EXPECT_EQ (sheet.at (0).str, nullptr);
+    }
+}
+
+// 单遍解析与先缓存再解码的结果逐格相同
+TEST (SheetParserTest, SinglePassMatchesBuffered)
+{
+    const auto path
+        = std::filesystem::path (LIBXLS_TEST_DATA_DIR) / "test2.xls";
+    auto *wb = xls::xls_open (path.string ().c_str (), "UTF-8");
+    ASSERT_NE (wb, nullptr);
+
+    std::size_t total = 0;
+    for (int i = 0; i < int (wb->sheets.count); ++i)
+    {
+        auto *ws = xls::xls_getWorkSheet (wb, i);
+        std::vector<xls::BYTE> data;
+        SparseSheet buffered;
+        ASSERT_EQ (readSheetStream (ws, data), xls::LIBXLS_OK);
+        ASSERT_EQ (decodeSheetStream (wb, data, buffered), xls::LIBXLS_OK);
+
+        SparseSheet single;
+        ASSERT_EQ (parseSparseSheet (ws, single), xls::LIBXLS_OK);
+        ASSERT_EQ (single.cellCount (), buffered.cellCount ());
+        total += single.cellCount ();
+
+        const auto *expected = buffered.cells ().begin ();
+        for (const auto &cell : single.cells ())
+        {
+            EXPECT_EQ (cell.row, expected->row);
+            EXPECT_EQ (cell.col, expected->col);
+            EXPECT_EQ (cell.id, expected->id);
+            EXPECT_EQ (cell.xf, expected->xf);
+            EXPECT_EQ (std::memcmp (&cell.d, &expected->d, sizeof cell.d), 0);
+            EXPECT_STREQ (cell.str, expected->str);
+            ++expected;
+        }
+        xls::xls_close_WS (ws);
+    }
+    EXPECT_GT (total, 0u);
+    xls::xls_close_WB (wb);
+}
+
+// VALUES_ONLY: 数值和空白单元格不生成文本, 读取结果与 FULL 相同
+TEST (SheetParserTest, ValuesOnlyReadsSameValues)
+{
+    const auto path
+        = std::filesystem::path (LIBXLS_TEST_DATA_DIR) / "test2.xls";
+    auto *wb = xls::xls_open (path.string ().c_str (), "UTF-8");
+    ASSERT_NE (wb, nullptr);
+    const DateFormatCache formats (wb);
+
+    // 工作表引用工作簿的共享字符串表, 须先于工作簿释放
+    auto *ws = xls::xls_getWorkSheet (wb, 0);
+    auto full = std::make_unique<SparseSheet> ();
+    auto values = std::make_unique<SparseSheet> ();
+    ASSERT_EQ (parseSparseSheet (ws, *full), xls::LIBXLS_OK);
+    ASSERT_EQ (parseSparseSheet (ws, *values, ParseMode::VALUES_ONLY),
+               xls::LIBXLS_OK);
+    ASSERT_EQ (values->cellCount (), full->cellCount ());
+
+    std::size_t numbers = 0;
+    std::size_t shared = 0;
+    const auto *expected = full->cells ().begin ();
+    for (const auto &cell : values->cells ())
+    {
+        const XlsCellView view (&cell, &formats);
+        const XlsCellView fullView (expected, &formats);
+        EXPECT_EQ (view.type (), fullView.type ());
+        EXPECT_EQ (view.asDouble (), fullView.asDouble ());
+        EXPECT_EQ (view.text (), fullView.text ());
+        EXPECT_EQ (view.toCell ().asStdString (false),
+                   fullView.toCell ().asStdString (false));
+        if (view.type () == CellType::NUMBER)
+        {
+            EXPECT_EQ (cell.str, nullptr);
+            ++numbers;
+        }
+        // LABELSST 直接指向 SST 表项, 两种方式相同
+        if (cell.id == XLS_RECORD_LABELSST)
+        {
+            ASSERT_GE (cell.l, 0);
+            EXPECT_EQ (cell.str, wb->sst.string[cell.l].str);
+            EXPECT_EQ (expected->str, cell.str);
+            ++shared;
+        }
+        ++expected;
+    }
+    EXPECT_GT (numbers, 0u);
+    EXPECT_GT (shared, 0u);
+
+    full.reset ();
+    values.reset ();
+    xls::xls_close_WS (ws);
+    xls::xls_close_WB (wb);
+}
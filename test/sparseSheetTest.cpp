@@ -0,0 +1,134 @@
+#include "../src/SparseSheet.h"
+#include "sheetBuilder.h"
+
+#include <gtest/gtest.h>
+
+// 空表: 没有行, 查找返回 nullptr
+TEST (SparseSheetTest, EmptySheet)
+{
+    SparseSheet sheet;
+    sheet.finalize ();
+
+    EXPECT_EQ (sheet.rowCount (), 0u);
+    EXPECT_EQ (sheet.colCount (), 0u);
+    EXPECT_EQ (sheet.cellCount (), 0u);
+    EXPECT_EQ (sheet.find (0, 0), nullptr);
+    EXPECT_TRUE (sheet.row (0).empty ());
+}
+
+// 列连续的行: 直接下标访问
+TEST (SparseSheetTest, DenseRowLookup)
+{
+    SparseSheet sheet;
+    for (uint16_t c = 0; c < 10; ++c)
+    {
+        addNumber (sheet, 3, c, c * 1.5);
+    }
+    sheet.finalize ();
+
+    EXPECT_EQ (sheet.rowCount (), 4u);
+    EXPECT_EQ (sheet.colCount (), 10u);
+    EXPECT_EQ (sheet.row (3).size (), 10u);
+    ASSERT_NE (sheet.find (3, 7), nullptr);
+    EXPECT_DOUBLE_EQ (sheet.find (3, 7)->d, 10.5);
+    EXPECT_EQ (sheet.find (3, 10), nullptr);
+    EXPECT_EQ (sheet.find (2, 0), nullptr);
+}
+
+// 稀疏行: 二分查找, 不存在的列返回 nullptr
+TEST (SparseSheetTest, SparseRowLookup)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 1.0);
+    addNumber (sheet, 0, 255, 2.0);
+    addNumber (sheet, 65535, 100, 3.0);
+    sheet.finalize ();
+
+    EXPECT_EQ (sheet.rowCount (), 65536u);
+    EXPECT_EQ (sheet.colCount (), 256u);
+    EXPECT_EQ (sheet.cellCount (), 3u);
+    EXPECT_DOUBLE_EQ (sheet.find (0, 255)->d, 2.0);
+    EXPECT_DOUBLE_EQ (sheet.find (65535, 100)->d, 3.0);
+    EXPECT_EQ (sheet.find (0, 128), nullptr);
+    EXPECT_EQ (sheet.find (1, 0), nullptr);
+}
+
+// 乱序追加: finalize 后行内按列有序
+TEST (SparseSheetTest, OutOfOrderAppendIsSorted)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 2, 5, 25.0);
+    addNumber (sheet, 0, 1, 1.0);
+    addNumber (sheet, 2, 1, 21.0);
+    addNumber (sheet, 0, 0, 0.0);
+    sheet.finalize ();
+
+    auto row = sheet.row (2);
+    ASSERT_EQ (row.size (), 2u);
+    EXPECT_EQ (row.first[0].col, 1);
+    EXPECT_EQ (row.first[1].col, 5);
+    EXPECT_DOUBLE_EQ (sheet.find (0, 1)->d, 1.0);
+    EXPECT_DOUBLE_EQ (sheet.find (2, 5)->d, 25.0);
+}
+
+// 同一位置重复出现时以最后一条记录为准
+TEST (SparseSheetTest, DuplicateKeepsLastRecord)
+{
+    SparseSheet sheet;
+    addLabel (sheet, 1, 1, "old", XLS_RECORD_LABEL);
+    addLabel (sheet, 1, 1, "new", XLS_RECORD_LABEL);
+    sheet.finalize ();
+
+    EXPECT_EQ (sheet.cellCount (), 1u);
+    ASSERT_NE (sheet.find (1, 1), nullptr);
+    EXPECT_STREQ (sheet.find (1, 1)->str, "new");
+}
+
+// 稀疏存储的内存只和单元格数量相关
+TEST (SparseSheetTest, MemoryTracksPopulatedCells)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 255, 1.0);
+    addNumber (sheet, 65535, 0, 1.0);
+    sheet.finalize ();
+
+    std::size_t dense = 65536u * 256u * sizeof (xls::xlsCell);
+    EXPECT_LT (sheet.memoryUsage () * 100, dense);
+}
+
+// 引用共享字符串的单元格不复制也不释放表项; 自有字符串照常释放
+TEST (SparseSheetTest, SharedStringsAreBorrowed)
+{
+    char first[] = "red";
+    char second[] = "blue";
+    xls::st_sst::str_sst_string entries[] = { { first }, { second } };
+    xls::st_sst sst{};
+    sst.count = 2;
+    sst.string = entries;
+
+    SparseSheet sheet;
+    sheet.setSharedStrings (&sst);
+    for (uint16_t r = 0; r < 4; ++r)
+    {
+        sheet.shareString (sheet.append (r, 0, XLS_RECORD_LABELSST, 0),
+                           r % 2);
+    }
+    // 越界下标, 自有字符串, 重复位置
+    sheet.shareString (sheet.append (4, 0, XLS_RECORD_LABELSST, 0), 7);
+    addLabel (sheet, 5, 0, "own");
+    sheet.shareString (sheet.append (3, 0, XLS_RECORD_LABELSST, 0), 0);
+    sheet.finalize ();
+
+    EXPECT_EQ (sheet.cellCount (), 6u);
+    EXPECT_EQ (sheet.find (0, 0)->str, first);
+    EXPECT_EQ (sheet.find (1, 0)->str, second);
+    EXPECT_EQ (sheet.find (1, 0)->l, 1);
+    EXPECT_EQ (sheet.find (3, 0)->str, first);
+    EXPECT_EQ (sheet.find (4, 0)->str, nullptr);
+    EXPECT_EQ (sheet.find (4, 0)->l, -1);
+    EXPECT_STREQ (sheet.find (5, 0)->str, "own");
+
+    sheet.clear ();
+    EXPECT_STREQ (first, "red");
+    EXPECT_EQ (sheet.sharedStrings (), nullptr);
+}
@@ -0,0 +1,162 @@
+#include "../src/XlsCellView.h"
+#include "../src/XlsxSheet.h"
+#include "sheetBuilder.h"
+
+#include <gtest/gtest.h>
+
+// 空视图视为空白单元格
+TEST (XlsCellViewTest, NullViewIsBlank)
+{
+    XlsCellView view;
+    EXPECT_FALSE (view.valid ());
+    EXPECT_EQ (view.type (), CellType::BLANK);
+    EXPECT_EQ (view.row (), -1);
+    EXPECT_DOUBLE_EQ (view.asDouble (), 0.0);
+    EXPECT_TRUE (view.text ().empty ());
+    EXPECT_THROW ((void)view.toCell (), ExcelReader::NullCellException);
+}
+
+// 各类记录的类型推断
+TEST (XlsCellViewTest, TypeFromRecord)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 2.5);
+    addCell (sheet, 0, 1, XLS_RECORD_RK, 14).d = 45000.0;
+    addLabel (sheet, 0, 2, "abc");
+    addLabel (sheet, 0, 3, "  ", XLS_RECORD_BLANK);
+    addLabel (sheet, 0, 4, "bool", XLS_RECORD_BOOLERR).d = 1;
+    addLabel (sheet, 0, 5, "error", XLS_RECORD_FORMULA).l = 0xFFFF;
+    addLabel (sheet, 0, 6, "result", XLS_RECORD_FORMULA).l = 0xFFFF;
+    sheet.finalize ();
+
+    auto at = [&sheet] (std::size_t col)
+    { return XlsCellView (sheet.find (0, col)); };
+
+    EXPECT_EQ (at (0).type (), CellType::NUMBER);
+    EXPECT_DOUBLE_EQ (at (0).asDouble (), 2.5);
+    EXPECT_EQ (at (1).type (), CellType::DATE);
+    EXPECT_EQ (at (2).type (), CellType::STRING);
+    EXPECT_EQ (at (2).text (), "abc");
+    EXPECT_EQ (at (3).type (), CellType::BLANK);
+    EXPECT_EQ (at (4).type (), CellType::BOOL);
+    EXPECT_TRUE (at (4).asLogical ());
+    EXPECT_EQ (at (5).type (), CellType::BLANK);
+    EXPECT_EQ (at (6).type (), CellType::STRING);
+    EXPECT_EQ (at (6).text (), "result");
+    EXPECT_EQ (at (6).col (), 6);
+}
+
+// toCell 复制出独立的 XlsCell
+TEST (XlsCellViewTest, ToCellCopiesValue)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 7.0);
+    sheet.finalize ();
+
+    auto cell = XlsCellView (sheet.find (0, 0)).toCell ();
+    EXPECT_EQ (cell.type (), CellType::NUMBER);
+    EXPECT_DOUBLE_EQ (cell.asDouble (), 7.0);
+}
+
+// 字符串单元格按内容推断数值和 TRUE / FALSE, 不抛异常
+TEST (XlsCellViewTest, ToCellInfersStringValues)
+{
+    SparseSheet sheet;
+    addLabel (sheet, 0, 0, " 42.5 ");
+    addLabel (sheet, 0, 1, "true", XLS_RECORD_LABEL);
+    addLabel (sheet, 0, 2, "5ft 11");
+    addLabel (sheet, 0, 3, "nan");
+    addLabel (sheet, 0, 4, "");
+    sheet.finalize ();
+
+    auto at = [&sheet] (std::size_t col)
+    { return XlsCellView (sheet.find (0, col)).toCell (); };
+
+    EXPECT_EQ (at (0).type (), CellType::NUMBER);
+    EXPECT_DOUBLE_EQ (at (0).asDouble (), 42.5);
+    EXPECT_EQ (at (1).type (), CellType::BOOL);
+    EXPECT_TRUE (at (1).asLogical ());
+    EXPECT_EQ (at (2).type (), CellType::STRING);
+    EXPECT_EQ (at (3).type (), CellType::STRING);
+    EXPECT_EQ (at (4).type (), CellType::BLANK);
+}
+
+// 字符串单元格的类型和值与 XlsCell 的推断一致, XLSX 的文本单元格相同;
+// 无论推断为何种类型, text () 都返回原文
+TEST (XlsCellViewTest, LabelTypesMatchXlsCell)
+{
+    const char *labels[] = { " 42.5 ", "\t-7\t", "true", " FALSE",
+                             "1e3",    "5ft 11", "nan",  "0x10",
+                             "",       "  ",     "abc",  "\n1\n",
+                             "007" };
+    SparseSheet sheet;
+    StringArena shared;
+    XlsxSheet xlsx (&shared, nullptr);
+    uint16_t col = 0;
+    for (const char *label : labels)
+    {
+        addLabel (sheet, 0, col, label,
+                  col % 2 == 0 ? XLS_RECORD_LABELSST : XLS_RECORD_LABEL);
+        if (col % 2 == 0)
+        {
+            xlsx.append (0, col, 0, XlsxValue::SHARED).str = shared.add (label);
+        }
+        else
+        {
+            xlsx.append (0, col, 0, XlsxValue::INLINE).str
+                = xlsx.inlineStrings ().add (label);
+        }
+        ++col;
+    }
+    sheet.finalize ();
+    xlsx.finalize ();
+
+    for (uint16_t c = 0; c < col; ++c)
+    {
+        const XlsCellView view (sheet.find (0, c));
+        const XlsCell cell = view.toCell ();
+        EXPECT_EQ (view.type (), cell.type ()) << labels[c];
+        EXPECT_DOUBLE_EQ (view.asDouble (), cell.asDouble ()) << labels[c];
+        EXPECT_EQ (view.asLogical (), cell.asLogical ()) << labels[c];
+        EXPECT_EQ (view.text (), labels[c]);
+
+        const XlsxCellView other (xlsx.find (0, c), &xlsx);
+        EXPECT_EQ (other.type (), view.type ()) << labels[c];
+        EXPECT_DOUBLE_EQ (other.asDouble (), view.asDouble ()) << labels[c];
+        EXPECT_EQ (other.asLogical (), view.asLogical ()) << labels[c];
+        EXPECT_EQ (other.text (), labels[c]);
+    }
+    EXPECT_EQ (XlsCellView (sheet.find (0, 0)).type (), CellType::NUMBER);
+    EXPECT_DOUBLE_EQ (XlsCellView (sheet.find (0, 0)).asDouble (), 42.5);
+    EXPECT_EQ (XlsCellView (sheet.find (0, 2)).type (), CellType::BOOL);
+    EXPECT_EQ (XlsCellView (sheet.find (0, 10)).text (), "abc");
+    EXPECT_EQ (XlsCellView (sheet.find (0, 12)).type (), CellType::NUMBER);
+    EXPECT_EQ (XlsCellView (sheet.find (0, 12)).text (), "007");
+}
+
+// 列名等使用的显示文本: 字符串保留原文, 其它类型格式化
+TEST (XlsCellViewTest, DisplayText)
+{
+    SparseSheet sheet;
+    addNumber (sheet, 0, 0, 2024.0);
+    addLabel (sheet, 0, 1, "007");
+    addLabel (sheet, 0, 2, "1", XLS_RECORD_LABEL);
+    addLabel (sheet, 0, 3, "bool", XLS_RECORD_BOOLERR).d = 1;
+    addNumber (sheet, 0, 4, 45000.5, 14);
+    addLabel (sheet, 0, 5, "45000.000000", XLS_RECORD_RK).d = 45000;
+    addLabel (sheet, 0, 6, "name");
+    addCell (sheet, 0, 7, XLS_RECORD_BLANK);
+    sheet.finalize ();
+
+    auto at = [&sheet] (std::size_t col)
+    { return XlsCellView (sheet.find (0, col)).displayText (); };
+    EXPECT_EQ (at (0), "2024");
+    EXPECT_EQ (at (1), "007");
+    EXPECT_EQ (at (2), "1");
+    EXPECT_EQ (at (3), "TRUE");
+    EXPECT_EQ (at (4), "45000.5");
+    EXPECT_EQ (at (5), "45000"); // 不用 FULL 模式下 libxls 的 "%lf" 文本
+    EXPECT_EQ (at (6), "name");
+    EXPECT_EQ (at (7), "");
+    EXPECT_EQ (XlsCellView ().displayText (), "");
+}
@@ -0,0 +1,121 @@
+#include "../src/reader.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef LIBXLS_TEST_DATA_DIR
+#define LIBXLS_TEST_DATA_DIR "third-party/libxls/test/files"
+#endif
+
+#ifndef LIBXLS_CORPUS_DIR
+#define LIBXLS_CORPUS_DIR "third-party/libxls/fuzz/corpus"
+#endif
+
+namespace
+{
+
+fs::path
+dataFile (const char *name)
+{
+    return fs::path (LIBXLS_TEST_DATA_DIR) / name;
+}
+
+std::vector<std::byte>
+readBytes (const fs::path &path)
+{
+    std::ifstream in (path, std::ios::binary);
+    std::vector<char> chars ((std::istreambuf_iterator<char> (in)),
+                             std::istreambuf_iterator<char> ());
+    std::vector<std::byte> bytes (chars.size ());
+    std::memcpy (bytes.data (), chars.data (), chars.size ());
+    return bytes;
+}
+
+// 逐张工作表比较按列导出的字符串形式
+void
+expectSameSheets (XLSReader &expected, XLSReader &actual)
+{
+    ASSERT_EQ (actual.getSheetsCount (), expected.getSheetsCount ());
+    for (std::size_t i = 0; i < expected.getSheetsCount (); ++i)
+    {
+        EXPECT_EQ (actual.getSheetName (i), expected.getSheetName (i));
+        const auto lhs = expected.readColumns (i);
+        const auto rhs = actual.readColumns (i);
+        ASSERT_EQ (rhs.rows, lhs.rows);
+        ASSERT_EQ (rhs.columns.size (), lhs.columns.size ());
+        for (std::size_t c = 0; c < lhs.columns.size (); ++c)
+        {
+            EXPECT_EQ (rhs.columns[c].type, lhs.columns[c].type);
+            EXPECT_EQ (rhs.columns[c].validity, lhs.columns[c].validity);
+            EXPECT_EQ (rhs.columns[c].numbers, lhs.columns[c].numbers);
+            EXPECT_EQ (rhs.columns[c].chars, lhs.columns[c].chars);
+        }
+    }
+}
+
+} // namespace
+
+// 映射文件和内存打开与 FILE* 读取的结果相同
+TEST (XlsOpenTest, MappedAndMemoryMatchStream)
+{
+    const auto path = dataFile ("test2.xls");
+    XLSReader stream (path);
+    ASSERT_TRUE (stream.open ());
+    ASSERT_GT (stream.getSheetsCount (), 0u);
+
+    XLSReader mapped (path, ParseMode::FULL, OpenMode::MAPPED);
+    ASSERT_TRUE (mapped.open ());
+    expectSameSheets (stream, mapped);
+
+    const auto bytes = readBytes (path);
+    XLSReader memory (Span<const std::byte> (bytes.data (), bytes.size ()),
+                      ParseMode::VALUES_ONLY);
+    ASSERT_TRUE (memory.open ());
+    expectSameSheets (stream, memory);
+
+    // 重新打开替换旧的映射
+    ASSERT_TRUE (mapped.open ());
+    expectSameSheets (stream, mapped);
+}
+
+TEST (XlsOpenTest, OpenFailures)
+{
+    XLSReader missing (dataFile ("no_such_file.xls"), ParseMode::FULL,
+                       OpenMode::MAPPED);
+    EXPECT_FALSE (missing.open ());
+    EXPECT_EQ (missing.getSheetsCount (), 0u);
+
+    const std::vector<std::byte> garbage (4096, std::byte{ 0x5a });
+    XLSReader invalid{ Span<const std::byte> (garbage) };
+    EXPECT_FALSE (invalid.open ());
+    EXPECT_EQ (invalid.getSheetsCount (), 0u);
+
+    XLSReader empty{ Span<const std::byte> () };
+    EXPECT_FALSE (empty.open ());
+}
+
+// 列名与解析模式无关: FULL 模式下 libxls 给数值单元格生成 "%lf" 文本,
+// 数值列名 1 不能导出为 "1.000000"
+TEST (XlsOpenTest, ExportArrowNumericHeader)
+{
+    const auto path = fs::path (LIBXLS_CORPUS_DIR) / "missing-first-column.xls";
+    for (auto mode : { ParseMode::FULL, ParseMode::VALUES_ONLY })
+    {
+        XLSReader reader (path, mode);
+        ASSERT_TRUE (reader.open ());
+
+        ArrowSchema schema;
+        ArrowArray array;
+        reader.exportArrow (0, &schema, &array, true);
+        ASSERT_EQ (schema.n_children, 2);
+        EXPECT_STREQ (schema.children[0]->name, "A");
+        EXPECT_STREQ (schema.children[1]->name, "1");
+        schema.release (&schema);
+        array.release (&array);
+    }
+}
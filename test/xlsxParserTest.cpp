@@ -0,0 +1,345 @@
+#include "../src/XlsxParser.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace xlsx;
+
+TEST (XlsxParserTest, DecodeEntities)
+{
+    EXPECT_EQ (decodeString ("a &amp; b &lt;c&gt; &quot;&apos;"),
+               "a & b <c> \"'");
+    EXPECT_EQ (decodeString ("&#65;&#x4e2d;&#x1F600;"),
+               "A\xE4\xB8\xAD\xF0\x9F\x98\x80");
+    // 无法识别的实体原样保留
+    EXPECT_EQ (decodeString ("AT&T &bogus; &"), "AT&T &bogus; &");
+}
+
+TEST (XlsxParserTest, ScannerSkipsCommentsAndQuotedGreaterThan)
+{
+    XmlScanner scanner (
+        "<?xml version=\"1.0\"?><!-- <c> --><x:a k=\"1>2\" j='q'/>"
+        "<b>text</b>");
+    ASSERT_TRUE (scanner.next ());
+    EXPECT_TRUE (scanner.opens ("a"));
+    EXPECT_TRUE (scanner.selfClosing ());
+    EXPECT_EQ (scanner.attr ("k"), "1>2");
+    EXPECT_EQ (scanner.attr ("j"), "q");
+    EXPECT_EQ (scanner.attr ("missing").data (), nullptr);
+
+    ASSERT_TRUE (scanner.next ());
+    EXPECT_TRUE (scanner.opens ("b"));
+    EXPECT_EQ (scanner.text (), "text");
+    ASSERT_TRUE (scanner.next ());
+    EXPECT_TRUE (scanner.closes ("b"));
+    EXPECT_FALSE (scanner.next ());
+}
+
+// 富文本各段连接, 注音不计入, 空 <si/> 也占一个下标
+TEST (XlsxParserTest, SharedStrings)
+{
+    StringArena strings;
+    parseSharedStrings (
+        "<sst uniqueCount=\"4\"><si><t>plain</t></si>"
+        "<si><r><rPr><b/></rPr><t>ri</t></r><r><t xml:space=\"preserve\">"
+        "ch &amp; </t></r><rPh sb=\"0\" eb=\"1\"><t>x</t></rPh></si>"
+        "<si/><si><t>last</t></si></sst>",
+        strings);
+
+    ASSERT_EQ (strings.size (), 4u);
+    EXPECT_EQ (strings.get (0), "plain");
+    EXPECT_EQ (strings.get (1), "rich & ");
+    EXPECT_EQ (strings.get (2), "");
+    EXPECT_EQ (strings.get (3), "last");
+    EXPECT_EQ (strings.get (4), "");
+}
+
+// CDATA 段原样保留, 其中的 '<' 和 '&' 不是标记; 注释不计入文本
+TEST (XlsxParserTest, CdataText)
+{
+    StringArena strings;
+    parseSharedStrings ("<sst><si><t><![CDATA[a<b> & c]]></t></si>"
+                        "<si><t>x &amp; <![CDATA[<y>]]><!-- z -->!</t></si>"
+                        "<si><r><t><![CDATA[]]>r</t></r></si></sst>",
+                        strings);
+    ASSERT_EQ (strings.size (), 3u);
+    EXPECT_EQ (strings.get (0), "a<b> & c");
+    EXPECT_EQ (strings.get (1), "x & <y>!");
+    EXPECT_EQ (strings.get (2), "r");
+
+    XlsxSheet sheet;
+    parseSheet ("<sheetData><row r=\"1\">"
+                "<c t=\"str\"><v><![CDATA[1 < 2]]></v></c>"
+                "<c t=\"inlineStr\"><is><t><![CDATA[</c>]]></t></is></c>"
+                "<c><v><![CDATA[2.5]]></v></c></row></sheetData>",
+                sheet);
+    ASSERT_EQ (sheet.cellCount (), 3u);
+    EXPECT_EQ (XlsxCellView (sheet.find (0, 0), &sheet).text (), "1 < 2");
+    EXPECT_EQ (XlsxCellView (sheet.find (0, 1), &sheet).text (), "</c>");
+    EXPECT_DOUBLE_EQ (XlsxCellView (sheet.find (0, 2), &sheet).asDouble (),
+                      2.5);
+}
+
+TEST (XlsxParserTest, IsoDates)
+{
+    double serial = 0.0;
+    ASSERT_TRUE (parseIsoDate ("2024-02-29", false, serial));
+    EXPECT_DOUBLE_EQ (serial, 45351.0);
+    ASSERT_TRUE (parseIsoDate ("2024-02-29", true, serial));
+    EXPECT_DOUBLE_EQ (serial, 45351.0 - 1462.0);
+    ASSERT_TRUE (parseIsoDate ("1970-01-01T18:00:00Z", false, serial));
+    EXPECT_DOUBLE_EQ (serial, 25569.75);
+    ASSERT_TRUE (parseIsoDate ("2000-01-01T00:00:01.5+08:00", false, serial));
+    EXPECT_DOUBLE_EQ (serial, 36526.0 + 1.5 / 86400.0);
+    ASSERT_TRUE (parseIsoDate ("12:00", false, serial));
+    EXPECT_DOUBLE_EQ (serial, 0.5);
+
+    EXPECT_FALSE (parseIsoDate ("2023-02-29", false, serial));
+    EXPECT_FALSE (parseIsoDate ("2023-13-01", false, serial));
+    EXPECT_FALSE (parseIsoDate ("2023-1-1", false, serial));
+    EXPECT_FALSE (parseIsoDate ("2023-01-01 12:00", false, serial));
+    EXPECT_FALSE (parseIsoDate ("12:60", false, serial));
+    EXPECT_FALSE (parseIsoDate ("", false, serial));
+}
+
+// t="d" 单元格保存为日期序列号, 不依赖数字格式; 无法识别时按文本保存
+TEST (XlsxParserTest, SheetDateCells)
+{
+    const char *xml = "<sheetData><row r=\"1\">"
+                      "<c r=\"A1\" t=\"d\"><v>2024-02-29T12:00:00</v></c>"
+                      "<c r=\"B1\" t=\"d\"><v>not a date</v></c>"
+                      "<c r=\"C1\" t=\"d\"/></row></sheetData>";
+    XlsxSheet sheet;
+    parseSheet (xml, sheet);
+
+    XlsxCellView date (sheet.find (0, 0), &sheet);
+    EXPECT_EQ (date.type (), CellType::DATE);
+    EXPECT_DOUBLE_EQ (date.asDouble (), 45351.5);
+    XlsxCellView text (sheet.find (0, 1), &sheet);
+    EXPECT_EQ (text.type (), CellType::STRING);
+    EXPECT_EQ (text.text (), "not a date");
+    EXPECT_EQ (sheet.find (0, 2), nullptr);
+
+    XlsxSheet sheet1904;
+    parseSheet (xml, sheet1904, true);
+    EXPECT_DOUBLE_EQ (
+        XlsxCellView (sheet1904.find (0, 0), &sheet1904).asDouble (),
+        45351.5 - 1462.0);
+}
+
+// cellStyleXfs 中的 xf 不计入单元格的 XF 下标
+TEST (XlsxParserTest, StylesResolveDateXfs)
+{
+    DateFormatCache formats;
+    parseStyles ("<styleSheet><numFmts count=\"2\">"
+                 "<numFmt numFmtId=\"164\" formatCode=\"yyyy&quot;-&quot;mm\"/>"
+                 "<numFmt numFmtId=\"165\" formatCode=\"0.00\"/></numFmts>"
+                 "<cellStyleXfs count=\"1\"><xf numFmtId=\"14\"/>"
+                 "</cellStyleXfs><cellXfs count=\"4\"><xf numFmtId=\"0\"/>"
+                 "<xf numFmtId=\"164\"><alignment/></xf><xf numFmtId=\"165\"/>"
+                 "<xf numFmtId=\"14\"/></cellXfs></styleSheet>",
+                 formats);
+
+    EXPECT_FALSE (formats.isDateXf (0));
+    EXPECT_TRUE (formats.isDateXf (1));
+    EXPECT_FALSE (formats.isDateXf (2));
+    EXPECT_TRUE (formats.isDateXf (3));
+    EXPECT_FALSE (formats.isDateXf (4));
+}
+
+TEST (XlsxParserTest, WorkbookAndRelationships)
+{
+    auto info = parseWorkbook (
+        "<workbook><workbookPr date1904=\"1\"/><sheets>"
+        "<sheet name=\"A &amp; B\" sheetId=\"1\" r:id=\"rId2\"/>"
+        "<sheet name=\"Two\" sheetId=\"2\" r:id=\"rId1\"/></sheets></workbook>");
+    EXPECT_TRUE (info.date1904);
+    ASSERT_EQ (info.sheets.size (), 2u);
+    EXPECT_EQ (info.sheets[0].name, "A & B");
+    EXPECT_EQ (info.sheets[0].relId, "rId2");
+
+    auto rels = parseRelationships (
+        "<Relationships><Relationship Id=\"rId1\" Type=\"http://x/worksheet\""
+        " Target=\"worksheets/sheet2.xml\"/><Relationship Id=\"rId3\""
+        " Type=\"http://x/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+        "</Relationships>");
+    ASSERT_EQ (rels.size (), 2u);
+    EXPECT_EQ (rels[0].target, "worksheets/sheet2.xml");
+    ASSERT_NE (findRelationship (rels, "/sharedStrings"), nullptr);
+    EXPECT_EQ (findRelationship (rels, "/sharedStrings")->id, "rId3");
+    EXPECT_EQ (findRelationship (rels, "/styles"), nullptr);
+}
+
+TEST (XlsxParserTest, SheetCellTypes)
+{
+    StringArena shared;
+    shared.add ("hello");
+    shared.add ("  ");
+    DateFormatCache formats;
+    formats.addXf (0);
+    formats.addXf (14);
+
+    XlsxSheet sheet (&shared, &formats);
+    parseSheet ("<worksheet><dimension ref=\"A1:F3\"/><sheetData>"
+                "<row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c>"
+                "<c r=\"B1\"><v>1.5</v></c>"
+                "<c r=\"C1\" s=\"1\"><v>45000</v></c>"
+                "<c r=\"D1\" t=\"b\"><v>1</v></c>"
+                "<c r=\"E1\" t=\"e\"><v>#DIV/0!</v></c>"
+                "<c r=\"F1\" t=\"s\"><v>1</v></c></row>"
+                "<row r=\"3\"><c r=\"B3\" t=\"str\"><f>A1</f><v>x&lt;y</v></c>"
+                "<c r=\"C3\" s=\"1\"/>"
+                "<c r=\"D3\" t=\"inlineStr\"><is><t>in</t></is></c></row>"
+                "</sheetData><mergeCells><c r=\"A9\"><v>9</v></c></mergeCells>"
+                "</worksheet>",
+                sheet);
+
+    auto type = [&sheet] (std::size_t row, std::size_t col)
+    { return XlsxCellView (sheet.find (row, col), &sheet).type (); };
+
+    EXPECT_EQ (type (0, 0), CellType::STRING);
+    EXPECT_EQ (type (0, 1), CellType::NUMBER);
+    EXPECT_EQ (type (0, 2), CellType::DATE);
+    EXPECT_EQ (type (0, 3), CellType::BOOL);
+    EXPECT_EQ (type (0, 4), CellType::BLANK);
+    EXPECT_EQ (type (0, 5), CellType::BLANK);
+    EXPECT_EQ (type (2, 1), CellType::STRING);
+    EXPECT_EQ (type (2, 2), CellType::BLANK);
+    EXPECT_EQ (type (2, 3), CellType::STRING);
+    EXPECT_EQ (type (8, 0), CellType::BLANK);
+
+    EXPECT_EQ (XlsxCellView (sheet.find (0, 0), &sheet).text (), "hello");
+    EXPECT_EQ (XlsxCellView (sheet.find (2, 1), &sheet).text (), "x<y");
+    EXPECT_EQ (XlsxCellView (sheet.find (2, 3), &sheet).text (), "in");
+    EXPECT_TRUE (XlsxCellView (sheet.find (0, 3), &sheet).asLogical ());
+    EXPECT_EQ (sheet.rowCount (), 3u);
+    EXPECT_EQ (sheet.colCount (), 6u);
+}
+
+// 缺少 r 属性时按出现顺序编号; 乱序的单元格在 finalize 中排序
+TEST (XlsxParserTest, SheetWithoutReferences)
+{
+    XlsxSheet sheet;
+    parseSheet ("<sheetData><row><c><v>1</v></c><c><v>2</v></c></row>"
+                "<row><c><v>3</v></c></row>"
+                "<row r=\"5\"><c r=\"C5\"><v>5</v></c><c r=\"A5\"><v>4</v></c>"
+                "</row></sheetData>",
+                sheet);
+
+    std::vector<std::pair<int, int>> positions;
+    std::vector<double> values;
+    forEachRow (sheet,
+                [&] (const XlsxRowView &row)
+                {
+                    for (auto cell : row)
+                    {
+                        positions.emplace_back (cell.row (), cell.col ());
+                        values.push_back (cell.asDouble ());
+                    }
+                });
+
+    EXPECT_EQ (positions, (std::vector<std::pair<int, int>>{
+                              { 0, 0 }, { 0, 1 }, { 1, 0 }, { 4, 0 }, { 4, 2 } }));
+    EXPECT_EQ (values, (std::vector<double>{ 1, 2, 3, 4, 5 }));
+}
+
+// 超出 1048576 行的行号 (含 32 位溢出) 被丢弃, 不影响其余单元格
+TEST (XlsxParserTest, RowsOutOfRangeAreDropped)
+{
+    XlsxSheet sheet;
+    parseSheet ("<sheetData><row r=\"2\"><c><v>1</v></c></row>"
+                "<row r=\"4294967295\"><c><v>2</v></c></row>"
+                "<row r=\"1000000000\"><c><v>3</v></c></row>"
+                "<row><c><v>4</v></c></row>"
+                "<row r=\"1048576\"><c><v>5</v></c>"
+                "<c r=\"B1048577\"><v>6</v></c></row>"
+                "<row r=\"3\"><c r=\"A3\"><v>7</v></c></row></sheetData>",
+                sheet);
+
+    EXPECT_EQ (sheet.cellCount (), 3u);
+    EXPECT_EQ (sheet.rowCount (), 1048576u);
+    ASSERT_NE (sheet.find (1, 0), nullptr);
+    EXPECT_DOUBLE_EQ (sheet.find (1, 0)->number, 1.0);
+    ASSERT_NE (sheet.find (1048575, 0), nullptr);
+    EXPECT_DOUBLE_EQ (sheet.find (1048575, 0)->number, 5.0);
+    EXPECT_DOUBLE_EQ (sheet.find (2, 0)->number, 7.0);
+}
+
+// 分块传入的结果与整体解析相同, </row> 和带前缀的 </x:row> 可跨块
+TEST (XlsxParserTest, SheetStreamAcceptsAnyChunking)
+{
+    const std::string xml
+        = "<x:worksheet><x:dimension ref=\"A1:C4\"/><x:sheetData>"
+          "<x:row r=\"1\"><x:c r=\"A1\" t=\"inlineStr\"><x:is><x:t>a b</x:t>"
+          "</x:is></x:c><x:c r=\"C1\"><x:v>1.5</x:v></x:c></x:row>"
+          "<x:row r=\"2\"/>"
+          "<x:row><x:c><x:v>2</x:v></x:c><x:c t=\"b\"><x:v>1</x:v></x:c>"
+          "</x:row><x:row r=\"4\"><x:c r=\"B4\" t=\"str\"><x:v>r&lt;/row&gt;"
+          "</x:v></x:c></x:row></x:sheetData>"
+          "<x:mergeCells><x:c r=\"A9\"><x:v>9</x:v></x:c></x:mergeCells>"
+          "</x:worksheet>";
+
+    XlsxSheet whole;
+    parseSheet (xml, whole);
+    ASSERT_EQ (whole.cellCount (), 5u);
+
+    for (std::size_t chunk = 1; chunk <= 8; ++chunk)
+    {
+        XlsxSheet sheet;
+        SheetStream stream (sheet, xml.size ());
+        bool more = true;
+        for (std::size_t pos = 0; pos < xml.size () && more; pos += chunk)
+        {
+            more = stream.feed (std::string_view (xml).substr (pos, chunk));
+        }
+        // </sheetData> 之后的数据不再需要
+        EXPECT_FALSE (more);
+        stream.finish ();
+
+        ASSERT_EQ (sheet.cellCount (), whole.cellCount ()) << chunk;
+        EXPECT_EQ (sheet.rowCount (), 4u);
+        for (const auto &cell : whole)
+        {
+            const XlsxCell *got = sheet.find (cell.row, cell.col);
+            ASSERT_NE (got, nullptr) << chunk;
+            EXPECT_EQ (got->value, cell.value);
+            EXPECT_EQ (XlsxCellView (got, &sheet).text (),
+                       XlsxCellView (&cell, &whole).text ());
+            EXPECT_EQ (XlsxCellView (got, &sheet).asDouble (),
+                       XlsxCellView (&cell, &whole).asDouble ());
+        }
+    }
+}
+
+// 行内迭代器与 XlsCellIterator 相同, 支持随机访问
+TEST (XlsxParserTest, CellIteratorIsRandomAccess)
+{
+    XlsxSheet sheet;
+    parseSheet ("<sheetData><row r=\"1\"><c r=\"A1\"><v>1</v></c>"
+                "<c r=\"C1\"><v>3</v></c><c r=\"E1\"><v>5</v></c>"
+                "</row></sheetData>",
+                sheet);
+    auto row = *XlsxSheetRows (sheet).begin ();
+
+    EXPECT_EQ ((*std::prev (row.end ())).col (), 4u);
+    EXPECT_EQ ((*(2 + row.begin ())).col (), 4u);
+    EXPECT_EQ (row.begin ()[1].col (), 2u);
+
+    auto it = row.end ();
+    it -= 2;
+    EXPECT_EQ ((*it--).col (), 2u);
+    EXPECT_EQ (it, row.begin ());
+    EXPECT_EQ (it + 2, row.end () - 1);
+    EXPECT_TRUE (row.begin () < row.end ());
+    EXPECT_TRUE (row.end () >= row.begin ());
+    EXPECT_FALSE (row.begin () > row.begin ());
+    EXPECT_TRUE (row.begin () <= row.begin ());
+
+    auto found = std::lower_bound (row.begin (), row.end (), 3u,
+                                   [] (XlsxCellView cell, std::size_t col)
+                                   { return cell.col () < col; });
+    EXPECT_DOUBLE_EQ ((*found).asDouble (), 5.0);
+}
@@ -0,0 +1,116 @@
+#include "../src/XlsxReader.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef XLNT_TEST_DATA_DIR
+#define XLNT_TEST_DATA_DIR "third-party/xlnt/tests/data"
+#endif
+
+namespace
+{
+
+fs::path
+dataFile (const char *name)
+{
+    return fs::path (XLNT_TEST_DATA_DIR) / name;
+}
+
+} // namespace
+
+TEST (XlsxStrategyTest, OpenMissingFile)
+{
+    XLSXReader reader (dataFile ("no_such_file.xlsx"));
+    EXPECT_FALSE (reader.open ());
+    EXPECT_EQ (reader.getSheetsCount (), 0u);
+}
+
+// 18_formulae.xlsx 第一行: A1 共享字符串, B1 数值, D1 公式字符串,
+// G1 公式数值 PI(), I1 不存在
+TEST (XlsxStrategyTest, ReadCellTypes)
+{
+    XLSXReader reader (dataFile ("18_formulae.xlsx"));
+    ASSERT_TRUE (reader.open ());
+    ASSERT_GE (reader.getSheetsCount (), 1u);
+
+    EXPECT_EQ (reader.readCell (0, 0, 0), CellType::STRING);
+    EXPECT_EQ (reader.readCell (0, 0, 1), CellType::NUMBER);
+    EXPECT_EQ (reader.readCell (0, 0, 3), CellType::STRING);
+    EXPECT_EQ (reader.readCell (0, 0, 6), CellType::NUMBER);
+    EXPECT_EQ (reader.readCell (0, 0, 8), CellType::BLANK);
+    EXPECT_EQ (reader.readCell (0, 100, 0), CellType::BLANK);
+    EXPECT_THROW (reader.readCell (5, 0, 0), ExcelReader::IndexOutException);
+}
+
+// 按行遍历: 内联字符串, 行号从 0 开始
+TEST (XlsxStrategyTest, IterateRows)
+{
+    XLSXReader reader (dataFile ("Issue445_inline_str.xlsx"));
+    ASSERT_TRUE (reader.open ());
+    EXPECT_EQ (reader.getSheetName (0), "Sheet");
+
+    std::vector<std::size_t> rows;
+    std::vector<std::string> values;
+    for (const auto &row : reader.rows (0))
+    {
+        rows.push_back (row.index ());
+        for (auto cell : row)
+        {
+            values.emplace_back (cell.text ());
+        }
+    }
+    EXPECT_EQ (rows, (std::vector<std::size_t>{ 0, 1 }));
+    EXPECT_EQ (values, (std::vector<std::string>{ "a", "b" }));
+
+    // 释放后重新解析
+    reader.releaseSheet (0);
+    EXPECT_FALSE (reader.isSheetParsed (0));
+    std::size_t count = 0;
+    reader.forEachRow (0, [&count] (const XlsxRowView &row)
+                       { count += row.size (); });
+    EXPECT_EQ (count, 2u);
+}
+
+// 共享字符串与公式的缓存值
+TEST (XlsxStrategyTest, SharedStringsAndFormulaValues)
+{
+    XLSXReader reader (dataFile ("18_formulae.xlsx"));
+    ASSERT_TRUE (reader.open ());
+
+    auto row = *reader.rows (0).begin ();
+    EXPECT_EQ (row.find (0).text (), "a1");
+    EXPECT_DOUBLE_EQ (row.find (1).asDouble (), 1.0);
+    EXPECT_EQ (row.find (3).text (), "a11");
+    EXPECT_NEAR (row.find (6).asDouble (), 3.14159265358979, 1e-12);
+}
+
+// 映射文件和内存打开与 FILE* 读取的结果相同
+TEST (XlsxStrategyTest, MappedAndMemoryMatchStream)
+{
+    const auto path = dataFile ("18_formulae.xlsx");
+    std::ifstream in (path, std::ios::binary);
+    const std::string text ((std::istreambuf_iterator<char> (in)),
+                            std::istreambuf_iterator<char> ());
+    const Span<const std::byte> data (
+        reinterpret_cast<const std::byte *> (text.data ()), text.size ());
+
+    XLSXReader mapped (path, OpenMode::MAPPED);
+    XLSXReader memory (data);
+    for (auto *reader : { &mapped, &memory })
+    {
+        ASSERT_TRUE (reader->open ());
+        auto row = *reader->rows (0).begin ();
+        EXPECT_EQ (row.find (0).text (), "a1");
+        EXPECT_EQ (row.find (3).text (), "a11");
+        EXPECT_NEAR (row.find (6).asDouble (), 3.14159265358979, 1e-12);
+    }
+
+    const std::string garbage (64, 'x');
+    XLSXReader invalid{ Span<const std::byte> (
+        reinterpret_cast<const std::byte *> (garbage.data ()),
+        garbage.size ()) };
+    EXPECT_FALSE (invalid.open ());
+}
@@ -0,0 +1,188 @@
+#include "../src/XlsxParser.h"
+#include "../src/XmlSimd.h"
+
+#include <charconv>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace xmlsimd;
+
+namespace
+{
+
+const Level AllLevels[] = { Level::SCALAR, Level::SSE2, Level::AVX2 };
+
+std::string
+randomMarkup (std::mt19937 &rng, std::size_t n)
+{
+    static const char alphabet[] = "<>\"'a=/ 0";
+    std::string s (n, ' ');
+    for (auto &c : s)
+    {
+        c = alphabet[rng () % (sizeof alphabet - 1)];
+    }
+    return s;
+}
+
+// 测试期间切换默认内核, 结束时恢复
+class ActiveLevel
+{
+  private:
+    Level saved_;
+
+  public:
+    explicit ActiveLevel (Level level) : saved_ (active ().level)
+    {
+        setActive (level);
+    }
+    ~ActiveLevel () { setActive (saved_); }
+};
+
+} // namespace
+
+TEST (XmlSimdTest, KernelsMatchScalar)
+{
+    std::mt19937 rng (42);
+    for (int round = 0; round < 200; ++round)
+    {
+        const auto buf = randomMarkup (rng, 64);
+        BlockMasks expected;
+        detail::classifyTail (buf.data (), 64, expected);
+        for (auto level : AllLevels)
+        {
+            BlockMasks got;
+            kernels (level).classify (buf.data (), got);
+            EXPECT_EQ (got.lt, expected.lt) << levelName (level);
+            EXPECT_EQ (got.tagEnd, expected.tagEnd) << levelName (level);
+            EXPECT_EQ (got.quote, expected.quote) << levelName (level);
+        }
+    }
+}
+
+// 不支持的级别降级到 CPU 支持的最高级别
+TEST (XmlSimdTest, LevelClampedToCpu)
+{
+    EXPECT_EQ (kernels (Level::SCALAR).level, Level::SCALAR);
+    EXPECT_LE (kernels (Level::AVX2).level, detect ());
+    ActiveLevel guard (Level::AVX2);
+    EXPECT_EQ (active ().level, kernels (Level::AVX2).level);
+}
+
+// 任意起点 (包括回退) 的查找结果与逐字节查找一致
+TEST (XmlSimdTest, CursorFindMatchesNaive)
+{
+    std::mt19937 rng (7);
+    for (auto level : AllLevels)
+    {
+        const auto buf = randomMarkup (rng, 300);
+        const char *end = buf.data () + buf.size ();
+        BlockCursor cursor (end, kernels (level));
+        for (int round = 0; round < 500; ++round)
+        {
+            const char *from = buf.data () + rng () % (buf.size () + 1);
+            const char *lt = from;
+            while (lt < end && *lt != '<')
+            {
+                ++lt;
+            }
+            const char *quote = from;
+            while (quote < end && *quote != '"' && *quote != '\'')
+            {
+                ++quote;
+            }
+            EXPECT_EQ (cursor.find (from, &BlockMasks::lt), lt);
+            EXPECT_EQ (cursor.find (from, &BlockMasks::quote), quote);
+        }
+    }
+}
+
+TEST (XmlSimdTest, ParseDigits)
+{
+    uint64_t value = 0;
+    ASSERT_TRUE (parseDigits ("1234567890123456789", 19, value));
+    EXPECT_EQ (value, 1234567890123456789ull);
+    ASSERT_TRUE (parseDigits ("00000042", 8, value));
+    EXPECT_EQ (value, 42u);
+    ASSERT_TRUE (parseDigits ("", 0, value));
+    EXPECT_EQ (value, 0u);
+    EXPECT_FALSE (parseDigits ("1234:678", 8, value));
+    EXPECT_FALSE (parseDigits ("12345678/", 9, value));
+    EXPECT_FALSE (parseDigits ("1234 678", 8, value));
+}
+
+// 快速路径与 from_chars 逐位相同
+TEST (XmlSimdTest, ParseNumberMatchesFromChars)
+{
+    std::mt19937_64 rng (3);
+    std::vector<std::string> inputs = { "0",     "-0",    "1.",   ".5",
+                                        "1e5",   "-1.5",  "abc",  "",
+                                        "0.1",   "0.3",   "1.2.3" };
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string s = rng () % 4 == 0 ? "-" : "";
+        s += std::to_string (rng () % 10000000000ull);
+        if (rng () % 2 != 0)
+        {
+            s += ".";
+            s += std::to_string (rng () % 100000000ull);
+        }
+        inputs.push_back (s);
+    }
+    for (const auto &s : inputs)
+    {
+        double expected = 0;
+        const auto [ptr, ec]
+            = std::from_chars (s.data (), s.data () + s.size (), expected);
+        const bool ok
+            = ec == std::errc () && ptr == s.data () + s.size () && !s.empty ();
+        double got = 0;
+        ASSERT_EQ (xlsx::parseNumber (s, got), ok) << s;
+        if (ok)
+        {
+            EXPECT_EQ (std::memcmp (&got, &expected, sizeof got), 0) << s;
+        }
+    }
+}
+
+// 各级别内核解析同一工作表的结果相同
+TEST (XmlSimdTest, SheetIdenticalAcrossLevels)
+{
+    std::string xml = "<worksheet><sheetData>";
+    for (int r = 1; r <= 200; ++r)
+    {
+        const auto row = std::to_string (r);
+        xml += "<row r=\"" + row + "\" spans='1:3'>";
+        xml += "<c r=\"A" + row + "\" s=\"0\"><v>" + row + ".25</v></c>";
+        xml += "<c r=\"B" + row
+               + "\" t=\"inlineStr\"><is><t>a&gt;b \"" + row
+               + "\"</t></is></c>";
+        xml += "<c r='C" + row + "' t=\"str\"><f>A1&gt;0</f><v>x</v></c>";
+        xml += "</row>";
+    }
+    xml += "</sheetData></worksheet>";
+
+    std::vector<std::vector<std::string>> results;
+    for (auto level : AllLevels)
+    {
+        ActiveLevel guard (level);
+        XlsxSheet sheet;
+        xlsx::parseSheet (xml, sheet);
+        std::vector<std::string> cells;
+        for (const auto &cell : sheet)
+        {
+            const XlsxCellView view (&cell, &sheet);
+            cells.push_back (std::to_string (cell.row) + ","
+                             + std::to_string (cell.col) + ":"
+                             + std::to_string (view.asDouble ()) + ":"
+                             + std::string (view.text ()));
+        }
+        results.push_back (std::move (cells));
+    }
+    ASSERT_EQ (results[0].size (), 600u);
+    EXPECT_EQ (results[0][1], "0,1:0.000000:a>b \"1\"");
+    EXPECT_EQ (results[1], results[0]);
+    EXPECT_EQ (results[2], results[0]);
+}